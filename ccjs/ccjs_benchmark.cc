@@ -0,0 +1,614 @@
+// Copyright (c) 2011 SameGoal LLC.
+// All Rights Reserved.
+// Author: Andy Hochhaus <ahochhaus@samegoal.com>
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the throughput of the stream parser and of the structural
+// index parser on a large message in every JSON format, and of stage one
+// of the index parser on its own:
+//
+//   ccjs_benchmark [elements]
+//
+// elements is the number of entries of each repeated field, 50000 by
+// default, which makes payloads of about 4 MB.
+//
+//   ccjs_benchmark parallel [messages] [threads]
+//
+// measures ParsePartialFromJsonArrayInParallel() on an object key tag
+// array of messages small messages, 100000 by default, for every thread
+// count from 1 to threads, one per CPU by default.
+//
+//   ccjs_benchmark delimited [messages]
+//
+// measures ParsePartialDelimitedFromZeroCopyJsonStream() in messages/s
+// and MB/s on messages newline-delimited small messages, 100000 by
+// default, in every JSON format, read in blocks of 64 KB.
+//
+//   ccjs_benchmark compact [elements]
+//
+// measures parsing and serializing the message of the first mode in
+// every JSON format with the unrolled code of TestAllTypes and with the
+// table-driven code of CodeSizeTestAllTypes, see the README for their
+// sizes.
+//
+//   ccjs_benchmark js_generator protoc-gen-js [messages]
+//
+// writes a schema of messages messages, 10000 by default, each with a
+// nested message, an enum and fields of the types of the others, and
+// measures protoc with protoc-gen-js on it. protoc writing only a
+// descriptor set is measured as well and subtracted. Run it from the top
+// of the tree, with a plugin built before and after a change.
+//
+//   ccjs_benchmark ccjs_generator protoc-gen-ccjs [messages]
+//
+// does the same for protoc-gen-ccjs on 2000 messages by default, with
+// protoc writing only the C++ code that the plugin inserts into as the
+// baseline.
+
+#include <ftw.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include "protobuf/ccjs/ccjs_runtime.h"
+#include "protobuf/js/code_size_test.pb.h"
+#include "protobuf/js/test.pb.h"
+
+namespace {
+
+const int kMinRuns = 3;
+const double kMinSeconds = 1.0;
+
+double Now() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+void PopulateMessage(const int elements, TestAllTypes *message) {
+  unsigned int seed = 42;
+  for (int i = 0; i < elements; ++i) {
+    message->add_repeated_int32(rand_r(&seed));
+    message->add_repeated_int64(
+        static_cast<google::protobuf::int64>(rand_r(&seed)) << 20);
+    message->add_repeated_double(static_cast<double>(i) / 7);
+    message->add_repeated_nested_enum(TestAllTypes_NestedEnum_BAZ);
+    message->add_repeated_string(std::string(i % 40, 'x') + "\"\\");
+    message->add_repeated_nested_message()->set_b(i);
+  }
+}
+
+bool StreamParse(const std::string &json,
+                 const google::protobuf::uint32 type,
+                 const bool booleans_as_numbers,
+                 const bool start_index_one,
+                 TestAllTypes *message) {
+  google::protobuf::io::ArrayInputStream input(json.data(), json.size());
+  return message->ParsePartialFromZeroCopyJsonStream(
+      type, booleans_as_numbers, start_index_one, &input) &&
+      sg::protobuf::ccjs::runtime::AtEndOfInput(&input);
+}
+
+bool IndexParse(const std::string &json,
+                const google::protobuf::uint32 type,
+                const bool booleans_as_numbers,
+                const bool start_index_one,
+                TestAllTypes *message) {
+  return sg::protobuf::ccjs::runtime::ParseWithStructuralIndex(
+      message, type, booleans_as_numbers, start_index_one, NULL,
+      json.data(), json.size());
+}
+
+bool BuildIndex(const std::string &json,
+                const google::protobuf::uint32,
+                const bool,
+                const bool,
+                TestAllTypes *) {
+  std::vector<google::protobuf::uint32> structurals;
+  return sg::protobuf::ccjs::runtime::BuildStructuralIndex(
+      json.data(), json.size(), &structurals);
+}
+
+// Returns the MB/s of parse on json, or 0 if it fails.
+double Measure(bool (*parse)(const std::string &,
+                             const google::protobuf::uint32,
+                             const bool,
+                             const bool,
+                             TestAllTypes *),
+               const std::string &json,
+               const google::protobuf::uint32 type,
+               const bool booleans_as_numbers,
+               const bool start_index_one) {
+  TestAllTypes message;
+  int runs = 0;
+  const double begin = Now();
+  double elapsed = 0;
+  while (runs < kMinRuns || elapsed < kMinSeconds) {
+    message.Clear();
+    if (!parse(json, type, booleans_as_numbers, start_index_one,
+               &message)) {
+      return 0;
+    }
+    ++runs;
+    elapsed = Now() - begin;
+  }
+  return json.size() * static_cast<double>(runs) / elapsed / 1e6;
+}
+
+// Runs run(arg) at least kMinRuns times and for at least kMinSeconds.
+// Returns the seconds per run, or 0 if a run fails.
+double SecondsPerRun(bool (*run)(void *arg), void *arg) {
+  int runs = 0;
+  const double begin = Now();
+  double elapsed = 0;
+  while (runs < kMinRuns || elapsed < kMinSeconds) {
+    if (!run(arg)) {
+      return 0;
+    }
+    ++runs;
+    elapsed = Now() - begin;
+  }
+  return elapsed / runs;
+}
+
+struct ParallelRun {
+  std::string json;
+  int threads;
+};
+
+bool ParseInParallel(void *arg) {
+  const ParallelRun *run = static_cast<const ParallelRun *>(arg);
+  google::protobuf::RepeatedPtrField<TestAllTypes> messages;
+  return TestAllTypes::ParsePartialFromJsonArrayInParallel(
+      3, false, false, run->json.data(), run->json.size(), run->threads,
+      &messages);
+}
+
+int ParallelBenchmark(const int messages, const int max_threads) {
+  TestAllTypes message;
+  PopulateMessage(8, &message);
+  std::string element;
+  if (!message.SerializePartialToObjectKeyTagString(&element)) {
+    fprintf(stderr, "serialization failed\n");
+    return 1;
+  }
+  ParallelRun run;
+  run.json = "[";
+  for (int i = 0; i < messages; ++i) {
+    run.json += i ? "," : "";
+    run.json += element;
+  }
+  run.json += "]";
+
+  printf("%.1f MB, runs of at least %d bytes\n", run.json.size() / 1e6,
+         CCJS_PARALLEL_ARRAY_MIN_SIZE);
+  printf("%-8s %12s %8s\n", "threads", "MB/s", "speedup");
+  double serial = 0;
+  for (run.threads = 1; run.threads <= max_threads; ++run.threads) {
+    const double seconds = SecondsPerRun(ParseInParallel, &run);
+    if (seconds == 0) {
+      fprintf(stderr, "parse failed\n");
+      return 1;
+    }
+    if (run.threads == 1) {
+      serial = seconds;
+    }
+    printf("%-8d %12.1f %8.2f\n", run.threads,
+           run.json.size() / seconds / 1e6, serial / seconds);
+  }
+  return 0;
+}
+
+struct DelimitedRun {
+  const char *name;
+  google::protobuf::uint32 type;
+  bool booleans_as_numbers;
+  bool start_index_one;
+  int messages;
+  std::string json;
+};
+
+bool CountMessage(const TestAllTypes &, void *arg) {
+  ++*static_cast<int *>(arg);
+  return true;
+}
+
+bool ParseDelimited(void *arg) {
+  const DelimitedRun *run = static_cast<const DelimitedRun *>(arg);
+  google::protobuf::io::ArrayInputStream input(
+      run->json.data(), run->json.size(), 1 << 16);
+  TestAllTypes message;
+  int messages = 0;
+  return message.ParsePartialDelimitedFromZeroCopyJsonStream(
+      run->type, run->booleans_as_numbers, run->start_index_one, &input,
+      CountMessage, &messages) &&
+      messages == run->messages;
+}
+
+int DelimitedBenchmark(const int messages) {
+  TestAllTypes message;
+  PopulateMessage(8, &message);
+  DelimitedRun runs[] = {
+    {"pblite", 1, true, false, messages, ""},
+    {"pblite zero index", 1, true, true, messages, ""},
+    {"object key name", 2, false, false, messages, ""},
+    {"object key tag", 3, false, false, messages, ""},
+  };
+  std::string lines[4];
+  if (!message.SerializePartialToPbLiteString(&lines[0]) ||
+      !message.SerializePartialToPbLiteZeroIndexString(&lines[1]) ||
+      !message.SerializePartialToObjectKeyNameString(&lines[2]) ||
+      !message.SerializePartialToObjectKeyTagString(&lines[3])) {
+    fprintf(stderr, "serialization failed\n");
+    return 1;
+  }
+
+  printf("%-18s %6s %12s %12s\n", "format", "MB", "messages/s", "MB/s");
+  for (size_t i = 0; i < sizeof(runs) / sizeof(runs[0]); ++i) {
+    for (int j = 0; j < messages; ++j) {
+      runs[i].json += lines[i];
+      runs[i].json += "\n";
+    }
+    const double seconds = SecondsPerRun(ParseDelimited, &runs[i]);
+    if (seconds == 0) {
+      fprintf(stderr, "%s: parse failed\n", runs[i].name);
+      return 1;
+    }
+    printf("%-18s %6.1f %12.0f %12.1f\n", runs[i].name,
+           runs[i].json.size() / 1e6, messages / seconds,
+           runs[i].json.size() / seconds / 1e6);
+  }
+  return 0;
+}
+
+struct CompactRun {
+  google::protobuf::uint32 type;
+  bool booleans_as_numbers;
+  bool start_index_one;
+  std::string json;
+  TestAllTypes unrolled;
+  CodeSizeTestAllTypes compact;
+};
+
+template <typename Message>
+bool ParseAs(void *arg) {
+  const CompactRun *run = static_cast<const CompactRun *>(arg);
+  google::protobuf::io::ArrayInputStream input(
+      run->json.data(), run->json.size());
+  Message message;
+  return message.ParsePartialFromZeroCopyJsonStream(
+      run->type, run->booleans_as_numbers, run->start_index_one, &input) &&
+      sg::protobuf::ccjs::runtime::AtEndOfInput(&input);
+}
+
+template <typename Message>
+bool Serialize(const CompactRun &run,
+               const Message &message,
+               std::string *json) {
+  google::protobuf::io::StringOutputStream output(json);
+  return message.SerializePartialToZeroCopyJsonStream(
+      run.type, run.booleans_as_numbers, run.start_index_one, &output);
+}
+
+bool SerializeUnrolled(void *arg) {
+  const CompactRun *run = static_cast<const CompactRun *>(arg);
+  std::string json;
+  return Serialize(*run, run->unrolled, &json);
+}
+
+bool SerializeCompact(void *arg) {
+  const CompactRun *run = static_cast<const CompactRun *>(arg);
+  std::string json;
+  return Serialize(*run, run->compact, &json);
+}
+
+int CompactBenchmark(const int elements) {
+  CompactRun run;
+  PopulateMessage(elements, &run.unrolled);
+  if (!run.compact.ParseFromString(run.unrolled.SerializeAsString())) {
+    fprintf(stderr, "conversion failed\n");
+    return 1;
+  }
+
+  const struct {
+    const char *name;
+    google::protobuf::uint32 type;
+    bool booleans_as_numbers;
+    bool start_index_one;
+  } formats[] = {
+    {"pblite", 1, true, false},
+    {"pblite zero index", 1, true, true},
+    {"object key name", 2, false, false},
+    {"object key tag", 3, false, false},
+  };
+  printf("%-18s %6s %25s %25s\n", "", "", "parse MB/s", "serialize MB/s");
+  printf("%-18s %6s %12s %12s %12s %12s\n", "format", "MB", "unrolled",
+         "compact", "unrolled", "compact");
+  for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); ++i) {
+    run.type = formats[i].type;
+    run.booleans_as_numbers = formats[i].booleans_as_numbers;
+    run.start_index_one = formats[i].start_index_one;
+    run.json.clear();
+    std::string compact_json;
+    if (!Serialize(run, run.unrolled, &run.json) ||
+        !Serialize(run, run.compact, &compact_json) ||
+        compact_json != run.json) {
+      fprintf(stderr, "%s: serialization failed\n", formats[i].name);
+      return 1;
+    }
+    const double seconds[] = {
+      SecondsPerRun(ParseAs<TestAllTypes>, &run),
+      SecondsPerRun(ParseAs<CodeSizeTestAllTypes>, &run),
+      SecondsPerRun(SerializeUnrolled, &run),
+      SecondsPerRun(SerializeCompact, &run),
+    };
+    printf("%-18s %6.1f", formats[i].name, run.json.size() / 1e6);
+    for (size_t j = 0; j < sizeof(seconds) / sizeof(seconds[0]); ++j) {
+      if (seconds[j] == 0) {
+        fprintf(stderr, "\n%s: run failed\n", formats[i].name);
+        return 1;
+      }
+      printf(" %12.1f", run.json.size() / seconds[j] / 1e6);
+    }
+    printf("\n");
+  }
+  return 0;
+}
+
+int FormatsBenchmark(const int elements) {
+  TestAllTypes message;
+  PopulateMessage(elements, &message);
+
+  struct Format {
+    const char *name;
+    google::protobuf::uint32 type;
+    bool booleans_as_numbers;
+    bool start_index_one;
+    std::string json;
+  } formats[] = {
+    {"pblite", 1, true, false, ""},
+    {"pblite zero index", 1, true, true, ""},
+    {"object key name", 2, false, false, ""},
+    {"object key tag", 3, false, false, ""},
+  };
+  if (!message.SerializePartialToPbLiteString(&formats[0].json) ||
+      !message.SerializePartialToPbLiteZeroIndexString(&formats[1].json) ||
+      !message.SerializePartialToObjectKeyNameString(&formats[2].json) ||
+      !message.SerializePartialToObjectKeyTagString(&formats[3].json)) {
+    fprintf(stderr, "serialization failed\n");
+    return 1;
+  }
+
+  printf("%-18s %6s %12s %12s %12s\n", "format", "MB", "stream MB/s",
+         "index MB/s", "stage 1 MB/s");
+  for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); ++i) {
+    const Format &format = formats[i];
+    const double stream = Measure(
+        StreamParse, format.json, format.type,
+        format.booleans_as_numbers, format.start_index_one);
+    const double index = Measure(
+        IndexParse, format.json, format.type,
+        format.booleans_as_numbers, format.start_index_one);
+    const double stage_one = Measure(
+        BuildIndex, format.json, format.type,
+        format.booleans_as_numbers, format.start_index_one);
+    if (stream == 0 || index == 0 || stage_one == 0) {
+      fprintf(stderr, "%s: parse failed\n", format.name);
+      return 1;
+    }
+    printf("%-18s %6.1f %12.1f %12.1f %12.1f\n", format.name,
+           format.json.size() / 1e6, stream, index, stage_one);
+  }
+  return 0;
+}
+
+// Writes the schema of the generator modes to path.
+bool WriteSchema(const std::string &path, const int messages) {
+  FILE *file = fopen(path.c_str(), "w");
+  if (file == NULL) {
+    return false;
+  }
+  fprintf(file,
+          "syntax = \"proto2\";\n"
+          "\n"
+          "import \"js/javascript_package.proto\";\n"
+          "\n"
+          "option (javascript_package) = \"benchmark\";\n");
+  for (int i = 0; i < messages; ++i) {
+    fprintf(file,
+            "\n"
+            "message Message%d {\n"
+            "  message Nested {\n"
+            "    optional int32 a = 1;\n"
+            "    repeated string b = 2;\n"
+            "  }\n"
+            "  enum Kind {\n"
+            "    KIND_%d_ZERO = 0;\n"
+            "    KIND_%d_ONE = 1;\n"
+            "  }\n"
+            "  optional int32 id = 1;\n"
+            "  optional string name = 2 [default = \"message\"];\n"
+            "  repeated int64 values = 3;\n"
+            "  optional Kind kind = 4 [default = KIND_%d_ONE];\n"
+            "  optional Nested nested = 5;\n"
+            "  repeated double weights = 6;\n"
+            "  optional bool flag = 7;\n"
+            "  optional bytes data = 8;\n",
+            i, i, i, i);
+    if (i > 0) {
+      fprintf(file,
+              "  optional Message%d previous = 9;\n"
+              "  repeated Message%d.Nested previous_nested = 10;\n"
+              "  optional Message%d.Kind previous_kind = 11;\n",
+              i - 1, i - 1, i - 1);
+    }
+    fprintf(file, "}\n");
+  }
+  return fclose(file) == 0;
+}
+
+int RemoveEntry(const char *path, const struct stat *, int,
+                struct FTW *) {
+  return remove(path);
+}
+
+// The arguments of one protoc command line.
+typedef std::vector<std::string> Command;
+
+bool RunProtoc(void *arg) {
+  const Command *command = static_cast<const Command *>(arg);
+  std::vector<char *> argv;
+  argv.push_back(const_cast<char *>("protoc"));
+  for (size_t i = 0; i < command->size(); ++i) {
+    argv.push_back(const_cast<char *>((*command)[i].c_str()));
+  }
+  argv.push_back(NULL);
+  pid_t pid;
+  if (posix_spawnp(&pid, "protoc", NULL, NULL, argv.data(), environ) != 0) {
+    return false;
+  }
+  int status;
+  return waitpid(pid, &status, 0) == pid && WIFEXITED(status) &&
+      WEXITSTATUS(status) == 0;
+}
+
+std::string OutputFlag(const std::string &flag, const std::string &out) {
+  return flag[flag.size() - 1] == '=' ? flag + out : flag;
+}
+
+// Measures protoc with the baseline outputs and with those and the
+// plugin outputs on the schema. Outputs that end in = write into a
+// fresh directory.
+int GeneratorBenchmark(const std::string &plugin,
+                       const int messages,
+                       const Command &baseline_outputs,
+                       const Command &plugin_outputs) {
+  char dir[] = "/tmp/ccjs_benchmark.XXXXXX";
+  if (mkdtemp(dir) == NULL) {
+    perror("mkdtemp");
+    return 1;
+  }
+  const std::string schema = "generator_benchmark.proto";
+  Command baseline;
+  baseline.push_back("-I");
+  baseline.push_back(dir);
+  baseline.push_back("-I");
+  baseline.push_back(".");
+  Command generated = baseline;
+  generated.push_back("--plugin=" + plugin);
+  const std::string out = std::string(dir) + "/out";
+  for (size_t i = 0; i < baseline_outputs.size(); ++i) {
+    baseline.push_back(OutputFlag(baseline_outputs[i], out));
+    generated.push_back(OutputFlag(baseline_outputs[i], out));
+  }
+  for (size_t i = 0; i < plugin_outputs.size(); ++i) {
+    generated.push_back(OutputFlag(plugin_outputs[i], out));
+  }
+  baseline.push_back(schema);
+  generated.push_back(schema);
+
+  int result = 1;
+  double seconds[2] = {0, 0};
+  if (!WriteSchema(std::string(dir) + "/" + schema, messages) ||
+      mkdir(out.c_str(), 0700) != 0) {
+    fprintf(stderr, "writing %s failed\n", dir);
+  } else if ((seconds[0] = SecondsPerRun(RunProtoc, &baseline)) == 0 ||
+             (seconds[1] = SecondsPerRun(RunProtoc, &generated)) == 0) {
+    fprintf(stderr, "protoc failed, run from the top of the tree\n");
+  } else {
+    printf("%d messages\n", messages);
+    printf("%-12s %8s\n", "", "seconds");
+    printf("%-12s %8.3f\n", "baseline", seconds[0]);
+    printf("%-12s %8.3f\n", "with plugin", seconds[1]);
+    printf("%-12s %8.3f\n", "plugin", seconds[1] - seconds[0]);
+    result = 0;
+  }
+  nftw(dir, RemoveEntry, 16, FTW_DEPTH | FTW_PHYS);
+  return result;
+}
+
+const char *usage =
+    "usage: ccjs_benchmark [elements]\n"
+    "       ccjs_benchmark parallel [messages] [threads]\n"
+    "       ccjs_benchmark delimited [messages]\n"
+    "       ccjs_benchmark compact [elements]\n"
+    "       ccjs_benchmark js_generator protoc-gen-js [messages]\n"
+    "       ccjs_benchmark ccjs_generator protoc-gen-ccjs [messages]\n";
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc > 1 && strcmp(argv[1], "parallel") == 0) {
+    const int messages = argc > 2 ? atoi(argv[2]) : 100000;
+    const int threads = argc > 3 ? atoi(argv[3])
+                                 : sysconf(_SC_NPROCESSORS_ONLN);
+    if (messages <= 0 || threads <= 0) {
+      fprintf(stderr, "%s", usage);
+      return 1;
+    }
+    return ParallelBenchmark(messages, threads);
+  }
+  if (argc > 1 && strcmp(argv[1], "delimited") == 0) {
+    const int messages = argc > 2 ? atoi(argv[2]) : 100000;
+    if (messages <= 0) {
+      fprintf(stderr, "%s", usage);
+      return 1;
+    }
+    return DelimitedBenchmark(messages);
+  }
+  if (argc > 1 && strcmp(argv[1], "compact") == 0) {
+    const int elements = argc > 2 ? atoi(argv[2]) : 50000;
+    if (elements <= 0) {
+      fprintf(stderr, "%s", usage);
+      return 1;
+    }
+    return CompactBenchmark(elements);
+  }
+  if (argc > 2 && strcmp(argv[1], "js_generator") == 0) {
+    const int messages = argc > 3 ? atoi(argv[3]) : 10000;
+    if (messages <= 0) {
+      fprintf(stderr, "%s", usage);
+      return 1;
+    }
+    return GeneratorBenchmark(
+        std::string("protoc-gen-js=") + argv[2], messages,
+        Command(1, "--descriptor_set_out=/dev/null"),
+        Command(1, "--js_out="));
+  }
+  if (argc > 2 && strcmp(argv[1], "ccjs_generator") == 0) {
+    const int messages = argc > 3 ? atoi(argv[3]) : 2000;
+    if (messages <= 0) {
+      fprintf(stderr, "%s", usage);
+      return 1;
+    }
+    return GeneratorBenchmark(
+        std::string("protoc-gen-ccjs=") + argv[2], messages,
+        Command(1, "--cpp_out="), Command(1, "--ccjs_out="));
+  }
+  const int elements = argc > 1 ? atoi(argv[1]) : 50000;
+  if (elements <= 0) {
+    fprintf(stderr, "%s", usage);
+    return 1;
+  }
+  return FormatsBenchmark(elements);
+}
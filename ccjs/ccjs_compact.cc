@@ -0,0 +1,866 @@
+// Copyright (c) 2011 SameGoal LLC.
+// All Rights Reserved.
+// Author: Andy Hochhaus <ahochhaus@samegoal.com>
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ccjs/ccjs_compact.h"
+
+#include <string>
+#include <vector>
+
+#include "google/protobuf/reflection.h"
+#include "google/protobuf/unknown_field_set.h"
+
+#ifndef RTN_FALSE
+#define RTN_FALSE return false
+#endif
+
+namespace sg {
+namespace protobuf {
+namespace ccjs {
+namespace runtime {
+
+namespace {
+
+// The field of table with number, or NULL.
+const CompactField *CompactFindNumber(const CompactMessage &table,
+                                      const google::protobuf::int32 number) {
+  for (int i = 0; i < table.field_count; ++i) {
+    if (table.fields[i].number == number) {
+      return &table.fields[i];
+    }
+  }
+  return NULL;
+}
+
+// The number of the field of table named by the key, 0 when there is
+// none and -1 for the empty key that marks the end of an object.
+google::protobuf::int32 CompactFindName(const CompactMessage &table,
+                                        const char *key,
+                                        const int key_size) {
+  if (key_size == 0) {
+    return -1;
+  }
+  for (int i = 0; i < table.field_count; ++i) {
+    const char *name = table.fields[i].name;
+    if (strncmp(name, key, key_size) == 0 && name[key_size] == '\0') {
+      return table.fields[i].number;
+    }
+  }
+  return 0;
+}
+
+// WritePbLiteNullEntries() with the repeated fields taken from table.
+bool CompactWritePbLiteNullEntries(
+    const CompactMessage &table,
+    const google::protobuf::uint32 field_num,
+    const bool start_index_one,
+    google::protobuf::uint32 *cur_field_num,
+    google::protobuf::io::ZeroCopyOutputStream *output) {
+  if (*cur_field_num > field_num) {
+    RTN_FALSE;
+  }
+  const google::protobuf::uint32 first = start_index_one ? 1 : 0;
+  for (; *cur_field_num < field_num; ++*cur_field_num) {
+    const CompactField *field = CompactFindNumber(table, *cur_field_num);
+    const char *entry = field != NULL && field->repeated ? ",[]" : ",null";
+    if (*cur_field_num == first) {
+      ++entry;
+    }
+    if (!WriteRaw(entry, strlen(entry), output)) {
+      RTN_FALSE;
+    }
+  }
+  if (*cur_field_num != first && !WriteRaw(",", 1, output)) {
+    RTN_FALSE;
+  }
+  ++*cur_field_num;
+  return true;
+}
+
+// Writes the value of a singular field, or element index of a repeated
+// one, in the format of the unrolled serializer.
+bool CompactWriteValue(
+    const CompactField &field,
+    const google::protobuf::Message &message,
+    const google::protobuf::Reflection *reflection,
+    const google::protobuf::FieldDescriptor *descriptor,
+    const int index,
+    const google::protobuf::uint32 type,
+    const bool booleans_as_numbers,
+    const bool start_index_one,
+    google::protobuf::io::ZeroCopyOutputStream *output) {
+  const bool repeated = index >= 0;
+  char buffer[26];  // ceiling(64/3) + sign char + 2 quotes + NULL
+  int length;
+  switch (field.type) {
+    case google::protobuf::FieldDescriptor::TYPE_BOOL: {
+      const bool value = repeated ?
+          reflection->GetRepeatedBool(message, descriptor, index) :
+          reflection->GetBool(message, descriptor);
+      // Repeated booleans are always numbers.
+      if (booleans_as_numbers || repeated) {
+        return WriteRaw(value ? "1" : "0", 1, output);
+      }
+      return value ? WriteRaw("true", 4, output) :
+          WriteRaw("false", 5, output);
+    }
+    case google::protobuf::FieldDescriptor::TYPE_STRING:
+    case google::protobuf::FieldDescriptor::TYPE_BYTES: {
+      std::string scratch;
+      return WriteString(
+          repeated ?
+          reflection->GetRepeatedStringReference(
+              message, descriptor, index, &scratch) :
+          reflection->GetStringReference(message, descriptor, &scratch),
+          output);
+    }
+    case google::protobuf::FieldDescriptor::TYPE_GROUP:
+    case google::protobuf::FieldDescriptor::TYPE_MESSAGE:
+      return field.message->serialize(
+          repeated ?
+          reflection->GetRepeatedMessage(message, descriptor, index) :
+          reflection->GetMessage(message, descriptor),
+          type, booleans_as_numbers, start_index_one, output);
+    case google::protobuf::FieldDescriptor::TYPE_DOUBLE:
+      length = snprintf(buffer, sizeof(buffer), "%g", repeated ?
+          reflection->GetRepeatedDouble(message, descriptor, index) :
+          reflection->GetDouble(message, descriptor));
+      break;
+    case google::protobuf::FieldDescriptor::TYPE_FLOAT:
+      length = snprintf(buffer, sizeof(buffer), "%g", repeated ?
+          reflection->GetRepeatedFloat(message, descriptor, index) :
+          reflection->GetFloat(message, descriptor));
+      break;
+    case google::protobuf::FieldDescriptor::TYPE_INT64:
+    case google::protobuf::FieldDescriptor::TYPE_SINT64:
+    case google::protobuf::FieldDescriptor::TYPE_SFIXED64:
+      length = snprintf(buffer, sizeof(buffer),
+                        field.quoted ? "\"%ld\"" : "%ld", repeated ?
+          reflection->GetRepeatedInt64(message, descriptor, index) :
+          reflection->GetInt64(message, descriptor));
+      break;
+    case google::protobuf::FieldDescriptor::TYPE_UINT64:
+    case google::protobuf::FieldDescriptor::TYPE_FIXED64:
+      length = snprintf(buffer, sizeof(buffer),
+                        field.quoted ? "\"%lu\"" : "%lu", repeated ?
+          reflection->GetRepeatedUInt64(message, descriptor, index) :
+          reflection->GetUInt64(message, descriptor));
+      break;
+    case google::protobuf::FieldDescriptor::TYPE_INT32:
+    case google::protobuf::FieldDescriptor::TYPE_SINT32:
+    case google::protobuf::FieldDescriptor::TYPE_SFIXED32:
+      length = snprintf(buffer, sizeof(buffer), "%d", repeated ?
+          reflection->GetRepeatedInt32(message, descriptor, index) :
+          reflection->GetInt32(message, descriptor));
+      break;
+    case google::protobuf::FieldDescriptor::TYPE_UINT32:
+    case google::protobuf::FieldDescriptor::TYPE_FIXED32:
+      length = snprintf(buffer, sizeof(buffer), "%u", repeated ?
+          reflection->GetRepeatedUInt32(message, descriptor, index) :
+          reflection->GetUInt32(message, descriptor));
+      break;
+    case google::protobuf::FieldDescriptor::TYPE_ENUM:
+      length = snprintf(buffer, sizeof(buffer), "%d", repeated ?
+          reflection->GetRepeatedEnumValue(message, descriptor, index) :
+          reflection->GetEnumValue(message, descriptor));
+      break;
+    default:
+      RTN_FALSE;
+  }
+  if (length < 0 || length >= static_cast<int>(sizeof(buffer))) {
+    RTN_FALSE;
+  }
+  return WriteRaw(buffer, length, output);
+}
+
+// Reads one number or enum value of field, range checked like the
+// unrolled parser, and sets or adds it unless message is NULL.
+bool CompactReadNumber(
+    const CompactField &field,
+    google::protobuf::Message *message,
+    const google::protobuf::Reflection *reflection,
+    const google::protobuf::FieldDescriptor *descriptor,
+    google::protobuf::io::ZeroCopyInputStream *input) {
+  switch (field.type) {
+    case google::protobuf::FieldDescriptor::TYPE_DOUBLE: {
+      double value;
+      if (!ReadDouble(false, &value, input)) {
+        RTN_FALSE;
+      }
+      if (message == NULL) {
+      } else if (field.repeated) {
+        reflection->AddDouble(message, descriptor, value);
+      } else {
+        reflection->SetDouble(message, descriptor, value);
+      }
+      return true;
+    }
+    case google::protobuf::FieldDescriptor::TYPE_FLOAT: {
+      float value;
+      if (!ReadFloat(false, &value, input)) {
+        RTN_FALSE;
+      }
+      if (message == NULL) {
+      } else if (field.repeated) {
+        reflection->AddFloat(message, descriptor, value);
+      } else {
+        reflection->SetFloat(message, descriptor, value);
+      }
+      return true;
+    }
+    case google::protobuf::FieldDescriptor::TYPE_INT64:
+    case google::protobuf::FieldDescriptor::TYPE_SINT64:
+    case google::protobuf::FieldDescriptor::TYPE_SFIXED64: {
+      google::protobuf::int64 value;
+      if (!ReadInt64(field.quoted, &value, input)) {
+        RTN_FALSE;
+      }
+      if (message == NULL) {
+      } else if (field.repeated) {
+        reflection->AddInt64(message, descriptor, value);
+      } else {
+        reflection->SetInt64(message, descriptor, value);
+      }
+      return true;
+    }
+    case google::protobuf::FieldDescriptor::TYPE_UINT64:
+    case google::protobuf::FieldDescriptor::TYPE_FIXED64: {
+      google::protobuf::uint64 value;
+      if (!ReadUInt64(field.quoted, &value, input)) {
+        RTN_FALSE;
+      }
+      if (message == NULL) {
+      } else if (field.repeated) {
+        reflection->AddUInt64(message, descriptor, value);
+      } else {
+        reflection->SetUInt64(message, descriptor, value);
+      }
+      return true;
+    }
+    case google::protobuf::FieldDescriptor::TYPE_INT32:
+    case google::protobuf::FieldDescriptor::TYPE_SINT32:
+    case google::protobuf::FieldDescriptor::TYPE_SFIXED32: {
+      google::protobuf::int32 value;
+      if (!ReadInt32(false, &value, input)) {
+        RTN_FALSE;
+      }
+      if (message == NULL) {
+      } else if (field.repeated) {
+        reflection->AddInt32(message, descriptor, value);
+      } else {
+        reflection->SetInt32(message, descriptor, value);
+      }
+      return true;
+    }
+    case google::protobuf::FieldDescriptor::TYPE_UINT32:
+    case google::protobuf::FieldDescriptor::TYPE_FIXED32: {
+      google::protobuf::uint32 value;
+      if (!ReadUInt32(false, &value, input)) {
+        RTN_FALSE;
+      }
+      if (message == NULL) {
+      } else if (field.repeated) {
+        reflection->AddUInt32(message, descriptor, value);
+      } else {
+        reflection->SetUInt32(message, descriptor, value);
+      }
+      return true;
+    }
+    case google::protobuf::FieldDescriptor::TYPE_ENUM: {
+      google::protobuf::int32 value;
+      if (!ReadInt32(false, &value, input) || !field.enum_is_valid(value)) {
+        RTN_FALSE;
+      }
+      if (message == NULL) {
+      } else if (field.repeated) {
+        reflection->AddEnumValue(message, descriptor, value);
+      } else {
+        reflection->SetEnumValue(message, descriptor, value);
+      }
+      return true;
+    }
+    default:
+      RTN_FALSE;
+  }
+}
+
+void CompactStoreBool(const CompactField &field,
+                      google::protobuf::Message *message,
+                      const google::protobuf::Reflection *reflection,
+                      const google::protobuf::FieldDescriptor *descriptor,
+                      const bool value) {
+  if (message == NULL) {
+    return;
+  } else if (field.repeated) {
+    reflection->AddBool(message, descriptor, value);
+  } else {
+    reflection->SetBool(message, descriptor, value);
+  }
+}
+
+// Adds the integers of ReadIntegerArray() to a repeated field.
+template <typename Value>
+struct ReflectionValues {
+  typedef Value value_type;
+
+  google::protobuf::MutableRepeatedFieldRef<Value> values;
+
+  void Add(const Value value) {
+    values.Add(value);
+  }
+};
+
+template <typename Value>
+bool CompactReadIntegerArray(
+    const CompactField &field,
+    google::protobuf::Message *message,
+    const google::protobuf::Reflection *reflection,
+    const google::protobuf::FieldDescriptor *descriptor,
+    const bool is_signed,
+    google::protobuf::io::ZeroCopyInputStream *input) {
+  if (message == NULL) {
+    return ReadIntegerArray(
+        field.quoted, is_signed, std::numeric_limits<Value>::max(),
+        static_cast<ReflectionValues<Value> *>(NULL), input);
+  }
+  ReflectionValues<Value> values = {
+      reflection->GetMutableRepeatedFieldRef<Value>(message, descriptor)};
+  return ReadIntegerArray(
+      field.quoted, is_signed, std::numeric_limits<Value>::max(), &values,
+      input);
+}
+
+// Reads the array of a repeated field whose key was just read, the
+// unrolled parser's loop for each type of field.
+bool CompactReadArray(
+    const CompactField &field,
+    google::protobuf::Message *message,
+    const google::protobuf::Reflection *reflection,
+    const google::protobuf::FieldDescriptor *descriptor,
+    const google::protobuf::uint32 type,
+    const bool booleans_as_numbers,
+    const bool start_index_one,
+    google::protobuf::io::ZeroCopyInputStream *input) {
+  Token token;
+  if (!ReadToken(true, &token, input) || token != TOKEN_SQUARE_OPEN) {
+    RTN_FALSE;
+  }
+  switch (field.type) {
+    case google::protobuf::FieldDescriptor::TYPE_INT64:
+    case google::protobuf::FieldDescriptor::TYPE_SINT64:
+    case google::protobuf::FieldDescriptor::TYPE_SFIXED64:
+      return CompactReadIntegerArray<google::protobuf::int64>(
+          field, message, reflection, descriptor, true, input);
+    case google::protobuf::FieldDescriptor::TYPE_UINT64:
+    case google::protobuf::FieldDescriptor::TYPE_FIXED64:
+      return CompactReadIntegerArray<google::protobuf::uint64>(
+          field, message, reflection, descriptor, false, input);
+    case google::protobuf::FieldDescriptor::TYPE_INT32:
+    case google::protobuf::FieldDescriptor::TYPE_SINT32:
+    case google::protobuf::FieldDescriptor::TYPE_SFIXED32:
+      return CompactReadIntegerArray<google::protobuf::int32>(
+          field, message, reflection, descriptor, true, input);
+    case google::protobuf::FieldDescriptor::TYPE_UINT32:
+    case google::protobuf::FieldDescriptor::TYPE_FIXED32:
+      return CompactReadIntegerArray<google::protobuf::uint32>(
+          field, message, reflection, descriptor, false, input);
+    default:
+      break;
+  }
+
+  std::string value;
+  DiscardedString discarded;
+  while (true) {
+    // Messages, enums and floating point numbers are only peeked at.
+    const bool peek =
+        field.type == google::protobuf::FieldDescriptor::TYPE_GROUP ||
+        field.type == google::protobuf::FieldDescriptor::TYPE_MESSAGE ||
+        field.type == google::protobuf::FieldDescriptor::TYPE_ENUM ||
+        field.type == google::protobuf::FieldDescriptor::TYPE_DOUBLE ||
+        field.type == google::protobuf::FieldDescriptor::TYPE_FLOAT;
+    if (!ReadToken(!peek, &token, input)) {
+      RTN_FALSE;
+    }
+    switch (field.type) {
+      case google::protobuf::FieldDescriptor::TYPE_BOOL:
+        if (token == TOKEN_SQUARE_CLOSE) {
+          return true;
+        } else if (booleans_as_numbers && token == TOKEN_NUMBER) {
+          google::protobuf::uint32 number;
+          if (!ReadUInt32(false, &number, input) || number > 1) {
+            RTN_FALSE;
+          }
+          CompactStoreBool(field, message, reflection, descriptor,
+                           number == 1);
+        } else if (!booleans_as_numbers &&
+                   (token == TOKEN_TRUE || token == TOKEN_FALSE)) {
+          CompactStoreBool(field, message, reflection, descriptor,
+                           token == TOKEN_TRUE);
+        } else {
+          RTN_FALSE;
+        }
+        break;
+      case google::protobuf::FieldDescriptor::TYPE_STRING:
+      case google::protobuf::FieldDescriptor::TYPE_BYTES:
+        if (token == TOKEN_SQUARE_CLOSE) {
+          return true;
+        } else if (token != TOKEN_STRING) {
+          RTN_FALSE;
+        } else if (message == NULL) {
+          if (!ReadString(&discarded, input)) {
+            RTN_FALSE;
+          }
+        } else {
+          value.clear();
+          if (!ReadString(&value, input)) {
+            RTN_FALSE;
+          }
+          reflection->AddString(message, descriptor, value);
+        }
+        break;
+      case google::protobuf::FieldDescriptor::TYPE_GROUP:
+      case google::protobuf::FieldDescriptor::TYPE_MESSAGE:
+        if ((type == PB_LITE && token == TOKEN_SQUARE_CLOSE) ||
+            (type != PB_LITE && token == TOKEN_CURLY_CLOSE)) {
+          ReadToken(true, &token, input);
+          return true;
+        } else if ((type == PB_LITE && token == TOKEN_SQUARE_OPEN) ||
+                   (type != PB_LITE && token == TOKEN_CURLY_OPEN)) {
+          if (!field.message->parse(
+                  message == NULL ? NULL :
+                  reflection->AddMessage(message, descriptor),
+                  type, booleans_as_numbers, start_index_one, input)) {
+            RTN_FALSE;
+          }
+        } else {
+          RTN_FALSE;
+        }
+        break;
+      default:
+        if (token == TOKEN_SQUARE_CLOSE) {
+          ReadToken(true, &token, input);
+          return true;
+        } else if (token != TOKEN_NUMBER && token != TOKEN_STRING) {
+          RTN_FALSE;
+        } else if (!CompactReadNumber(
+                       field, message, reflection, descriptor, input)) {
+          RTN_FALSE;
+        }
+        break;
+    }
+    if (!ReadArraySeparator(&token, input)) {
+      RTN_FALSE;
+    }
+    if (token == TOKEN_SQUARE_CLOSE) {
+      return true;
+    }
+  }
+}
+
+// Reads the value of a singular field. token was peeked at by the
+// reader of the key.
+bool CompactReadValue(
+    const CompactField &field,
+    google::protobuf::Message *message,
+    const google::protobuf::Reflection *reflection,
+    const google::protobuf::FieldDescriptor *descriptor,
+    const google::protobuf::uint32 type,
+    const bool booleans_as_numbers,
+    const bool start_index_one,
+    Token token,
+    google::protobuf::io::ZeroCopyInputStream *input) {
+  switch (field.type) {
+    case google::protobuf::FieldDescriptor::TYPE_BOOL:
+      if (booleans_as_numbers && token == TOKEN_NUMBER) {
+        google::protobuf::uint32 number;
+        if (!ReadToken(true, &token, input) ||
+            !ReadUInt32(false, &number, input) || number > 1) {
+          RTN_FALSE;
+        }
+        CompactStoreBool(field, message, reflection, descriptor,
+                         number == 1);
+      } else if (!booleans_as_numbers &&
+                 (token == TOKEN_TRUE || token == TOKEN_FALSE)) {
+        CompactStoreBool(field, message, reflection, descriptor,
+                         token == TOKEN_TRUE);
+      } else {
+        RTN_FALSE;
+      }
+      return true;
+    case google::protobuf::FieldDescriptor::TYPE_STRING:
+    case google::protobuf::FieldDescriptor::TYPE_BYTES: {
+      if (!ReadToken(true, &token, input) || token != TOKEN_STRING) {
+        RTN_FALSE;
+      }
+      if (message == NULL) {
+        DiscardedString discarded;
+        return ReadString(&discarded, input);
+      }
+      std::string value;
+      if (!ReadString(&value, input)) {
+        RTN_FALSE;
+      }
+      reflection->SetString(message, descriptor, value);
+      return true;
+    }
+    case google::protobuf::FieldDescriptor::TYPE_GROUP:
+    case google::protobuf::FieldDescriptor::TYPE_MESSAGE:
+      return field.message->parse(
+          message == NULL ? NULL :
+          reflection->MutableMessage(message, descriptor),
+          type, booleans_as_numbers, start_index_one, input);
+    default:
+      return CompactReadNumber(field, message, reflection, descriptor, input);
+  }
+}
+
+// Whether message, or a message in it, has an unknown field with the
+// number of a known one, see CompactTranscodeBinary().
+bool HasMismatchedFields(const google::protobuf::Message &message) {
+  const google::protobuf::Reflection *reflection = message.GetReflection();
+  const google::protobuf::Descriptor *descriptor = message.GetDescriptor();
+  const google::protobuf::UnknownFieldSet &unknown_fields =
+      reflection->GetUnknownFields(message);
+  for (int i = 0; i < unknown_fields.field_count(); ++i) {
+    if (descriptor->FindFieldByNumber(unknown_fields.field(i).number()) !=
+        NULL) {
+      return true;
+    }
+  }
+  std::vector<const google::protobuf::FieldDescriptor *> fields;
+  reflection->ListFields(message, &fields);
+  for (size_t i = 0; i < fields.size(); ++i) {
+    if (fields[i]->cpp_type() !=
+        google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE) {
+      continue;
+    }
+    if (!fields[i]->is_repeated()) {
+      if (HasMismatchedFields(reflection->GetMessage(message, fields[i]))) {
+        return true;
+      }
+      continue;
+    }
+    for (int j = 0; j < reflection->FieldSize(message, fields[i]); ++j) {
+      if (HasMismatchedFields(
+              reflection->GetRepeatedMessage(message, fields[i], j))) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+bool CompactSerialize(
+    const CompactMessage &table,
+    const google::protobuf::Message &message,
+    const google::protobuf::uint32 type,
+    const bool booleans_as_numbers,
+    const bool start_index_one,
+    google::protobuf::io::ZeroCopyOutputStream *output) {
+  const google::protobuf::Reflection *reflection = message.GetReflection();
+  const google::protobuf::Descriptor *descriptor = message.GetDescriptor();
+  google::protobuf::uint32 cur_field_num = start_index_one ? 1 : 0;
+  bool prev_fields = false;
+  if (!WriteRaw(type == PB_LITE ? "[" : "{", 1, output)) {
+    RTN_FALSE;
+  }
+  for (int i = 0; i < table.field_count; ++i) {
+    const CompactField &field = table.fields[i];
+    const google::protobuf::FieldDescriptor *field_descriptor =
+        descriptor->field(i);
+    const int size = field.repeated ?
+        reflection->FieldSize(message, field_descriptor) : 0;
+    if (field.repeated ? size == 0 :
+        !reflection->HasField(message, field_descriptor)) {
+      continue;
+    }
+
+    if (type == PB_LITE) {
+      if (!CompactWritePbLiteNullEntries(
+              table, field.number, start_index_one, &cur_field_num,
+              output)) {
+        RTN_FALSE;
+      }
+    } else if (type == OBJECT_KEY_TAG) {
+      char key[12];  // ceiling(32/3) + sign char + NULL
+      snprintf(key, sizeof(key), "%d", field.number);
+      if (!WriteObjectKey(key, prev_fields, output)) {
+        RTN_FALSE;
+      }
+      prev_fields = true;
+    } else if (type == OBJECT_KEY_NAME) {
+      if (!WriteObjectKey(field.name, prev_fields, output)) {
+        RTN_FALSE;
+      }
+      prev_fields = true;
+    } else {
+      RTN_FALSE;
+    }
+
+    if (!field.repeated) {
+      if (!CompactWriteValue(field, message, reflection, field_descriptor,
+                             -1, type, booleans_as_numbers,
+                             start_index_one, output)) {
+        RTN_FALSE;
+      }
+      continue;
+    }
+    if (!WriteRaw("[", 1, output)) {
+      RTN_FALSE;
+    }
+    for (int j = 0; j < size; ++j) {
+      if ((j > 0 && !WriteRaw(",", 1, output)) ||
+          !CompactWriteValue(field, message, reflection, field_descriptor,
+                             j, type, booleans_as_numbers, start_index_one,
+                             output)) {
+        RTN_FALSE;
+      }
+    }
+    if (!WriteRaw("]", 1, output)) {
+      RTN_FALSE;
+    }
+  }
+  return WriteRaw(type == PB_LITE ? "]" : "}", 1, output);
+}
+
+bool CompactParse(
+    const CompactMessage &table,
+    google::protobuf::Message *message,
+    const google::protobuf::uint32 type,
+    const bool booleans_as_numbers,
+    const bool start_index_one,
+    google::protobuf::io::ZeroCopyInputStream *input) {
+  const google::protobuf::Reflection *reflection =
+      message == NULL ? NULL : message->GetReflection();
+  const google::protobuf::Descriptor *descriptor =
+      message == NULL ? NULL : message->GetDescriptor();
+  Token token;
+  if (!ReadToken(true, &token, input) ||
+      (type == PB_LITE && token != TOKEN_SQUARE_OPEN) ||
+      (type != PB_LITE && token != TOKEN_CURLY_OPEN)) {
+    RTN_FALSE;
+  }
+
+  // Keys longer than every field name are never decoded in full.
+  char short_key[64];
+  std::vector<char> long_key;
+  char *key = short_key;
+  int capacity = sizeof(short_key);
+  if (table.max_name_length > capacity) {
+    long_key.resize(table.max_name_length);
+    key = &long_key[0];
+    capacity = table.max_name_length;
+  }
+
+  google::protobuf::int32 cur_field_num = start_index_one ? 1 : 0;
+  bool first_tag = true;
+  while (true) {
+    if (type == PB_LITE) {
+      if (!ReadPbLiteNextTag(first_tag, &cur_field_num, &token, input)) {
+        RTN_FALSE;
+      }
+    } else if (type == OBJECT_KEY_NAME) {
+      int key_size;
+      if (!ReadObjectKey(first_tag, key, capacity, &key_size, &token,
+                         input)) {
+        RTN_FALSE;
+      }
+      cur_field_num = CompactFindName(table, key, key_size);
+    } else if (type == OBJECT_KEY_TAG) {
+      if (!ReadObjectKeyTag(first_tag, &cur_field_num, &token, input)) {
+        RTN_FALSE;
+      }
+    } else {
+      RTN_FALSE;
+    }
+    first_tag = false;
+    if (cur_field_num < 0) {
+      if (!ReadToken(true, &token, input) ||
+          (type == PB_LITE && token != TOKEN_SQUARE_CLOSE) ||
+          (type != PB_LITE && token != TOKEN_CURLY_CLOSE)) {
+        RTN_FALSE;
+      }
+      return true;
+    }
+
+    // Unknown fields are skipped so that newer clients can add fields.
+    const CompactField *field = CompactFindNumber(table, cur_field_num);
+    if (field == NULL) {
+      if (!SkipValue(token, input)) {
+        RTN_FALSE;
+      }
+      continue;
+    }
+    const google::protobuf::FieldDescriptor *field_descriptor =
+        message == NULL ? NULL : descriptor->field(field - table.fields);
+    if (field->repeated ?
+        !CompactReadArray(*field, message, reflection, field_descriptor,
+                          type, booleans_as_numbers, start_index_one,
+                          input) :
+        !CompactReadValue(*field, message, reflection, field_descriptor,
+                          type, booleans_as_numbers, start_index_one, token,
+                          input)) {
+      RTN_FALSE;
+    }
+  }
+}
+
+bool CompactParseStructuralIndex(
+    const CompactMessage &table,
+    google::protobuf::Message *message,
+    const google::protobuf::uint32 type,
+    const bool booleans_as_numbers,
+    const bool start_index_one,
+    const char *data,
+    const google::protobuf::uint32 *structurals,
+    const size_t structural_count,
+    size_t *cursor) {
+  const StructuralIndex index = {data, structurals, structural_count};
+  const char *span;
+  int span_size;
+  if (!IndexSkipNested(index, cursor, &span, &span_size)) {
+    RTN_FALSE;
+  }
+  google::protobuf::io::ArrayInputStream input(span, span_size);
+  if (!CompactParse(table, message, type, booleans_as_numbers,
+                    start_index_one, &input) ||
+      input.ByteCount() != span_size) {
+    RTN_FALSE;
+  }
+  return true;
+}
+
+bool CompactTranscodeBinary(
+    const CompactMessage &table,
+    google::protobuf::Message *message,
+    const google::protobuf::uint32 type,
+    const bool booleans_as_numbers,
+    const bool start_index_one,
+    const void *data,
+    int size,
+    google::protobuf::io::ZeroCopyOutputStream *output) {
+  if (!message->ParsePartialFromArray(data, size) ||
+      HasMismatchedFields(*message)) {
+    RTN_FALSE;
+  }
+  return CompactSerialize(table, *message, type, booleans_as_numbers,
+                          start_index_one, output);
+}
+
+bool CompactPushParseStep(
+    const CompactMessage &table,
+    google::protobuf::Message *message,
+    const int event,
+    const bool booleans_as_numbers,
+    const char *text,
+    const int text_size,
+    google::protobuf::int32 *field_num,
+    int *kind,
+    void **child,
+    void *child_step) {
+  if (event == PUSH_KEY) {
+    char short_key[64];
+    std::vector<char> long_key;
+    char *key = short_key;
+    int capacity = sizeof(short_key);
+    if (table.max_name_length > capacity) {
+      long_key.resize(table.max_name_length);
+      key = &long_key[0];
+      capacity = table.max_name_length;
+    }
+    int key_size;
+    google::protobuf::io::ArrayInputStream key_input(
+        text + 1, text_size - 1);
+    if (!ReadObjectKeyChars(key, capacity, &key_size, &key_input) ||
+        key_input.ByteCount() != text_size - 1) {
+      RTN_FALSE;
+    }
+    *field_num = CompactFindName(table, key, key_size);
+    return true;
+  }
+  *kind = PUSH_UNKNOWN;
+  const CompactField *field = CompactFindNumber(table, *field_num);
+  if (field == NULL) {
+    // Unknown fields are skipped.
+    return true;
+  }
+  const google::protobuf::Reflection *reflection = message->GetReflection();
+  const google::protobuf::FieldDescriptor *descriptor =
+      message->GetDescriptor()->field(field - table.fields);
+  if (field->repeated && event == PUSH_OPEN) {
+    *kind = PUSH_ARRAY;
+    return true;
+  }
+
+  if (field->type == google::protobuf::FieldDescriptor::TYPE_GROUP ||
+      field->type == google::protobuf::FieldDescriptor::TYPE_MESSAGE) {
+    if (event != (field->repeated ? PUSH_OPEN_ELEMENT : PUSH_OPEN)) {
+      RTN_FALSE;
+    }
+    *child = field->repeated ?
+        reflection->AddMessage(message, descriptor) :
+        reflection->MutableMessage(message, descriptor);
+    *kind = PUSH_MESSAGE;
+    *static_cast<PushStepFunction *>(child_step) = field->message->push_step;
+    return true;
+  }
+  if (event != (field->repeated ? PUSH_VALUE_ELEMENT : PUSH_VALUE)) {
+    RTN_FALSE;
+  }
+  google::protobuf::io::ArrayInputStream value_input(text, text_size);
+  if (field->type == google::protobuf::FieldDescriptor::TYPE_BOOL) {
+    if (booleans_as_numbers) {
+      google::protobuf::uint32 value;
+      if (!ReadUInt32(false, &value, &value_input) || value > 1) {
+        RTN_FALSE;
+      }
+      CompactStoreBool(*field, message, reflection, descriptor, value == 1);
+    } else if (text_size == 5 && memcmp(text, "true", 4) == 0) {
+      CompactStoreBool(*field, message, reflection, descriptor, true);
+      return true;
+    } else if (text_size == 6 && memcmp(text, "false", 5) == 0) {
+      CompactStoreBool(*field, message, reflection, descriptor, false);
+      return true;
+    } else {
+      RTN_FALSE;
+    }
+  } else if (
+      field->type == google::protobuf::FieldDescriptor::TYPE_STRING ||
+      field->type == google::protobuf::FieldDescriptor::TYPE_BYTES) {
+    Token token;
+    std::string value;
+    if (!ReadToken(true, &token, &value_input) || token != TOKEN_STRING ||
+        !ReadString(&value, &value_input)) {
+      RTN_FALSE;
+    }
+    if (field->repeated) {
+      reflection->AddString(message, descriptor, value);
+    } else {
+      reflection->SetString(message, descriptor, value);
+    }
+  } else if (!CompactReadNumber(
+                 *field, message, reflection, descriptor, &value_input)) {
+    RTN_FALSE;
+  }
+  // Only the terminator may be left.
+  return value_input.ByteCount() == text_size - 1;
+}
+
+}  // namespace runtime
+}  // namespace ccjs
+}  // namespace protobuf
+}  // namespace sg
@@ -0,0 +1,188 @@
+// Copyright (c) 2011 SameGoal LLC.
+// All Rights Reserved.
+// Author: Andy Hochhaus <ahochhaus@samegoal.com>
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The table-driven code of optimize_for=code_size. It walks messages
+// with protobuf reflection, so it is kept out of ccjs_runtime.h, which
+// only needs the lite runtime, and only the .pb.cc files of CODE_SIZE
+// messages include it and link the ccjs_compact library.
+
+#ifndef PROTOBUF_CCJS_CCJS_COMPACT_H_
+#define PROTOBUF_CCJS_CCJS_COMPACT_H_
+
+#include "ccjs/ccjs_runtime.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace sg {
+namespace protobuf {
+namespace ccjs {
+namespace runtime {
+
+// Each message only gets a table of its fields, which the Compact*()
+// functions walk in place of the code that is otherwise unrolled per
+// field, see README. Message fields are handed to the code of their own
+// class, whichever way it was generated, through CompactCalls<>.
+struct CompactMessageCalls {
+  bool (*serialize)(const google::protobuf::Message &message,
+                    const google::protobuf::uint32 type,
+                    const bool booleans_as_numbers,
+                    const bool start_index_one,
+                    google::protobuf::io::ZeroCopyOutputStream *output);
+  // Only validates when message is NULL.
+  bool (*parse)(google::protobuf::Message *message,
+                const google::protobuf::uint32 type,
+                const bool booleans_as_numbers,
+                const bool start_index_one,
+                google::protobuf::io::ZeroCopyInputStream *input);
+  PushStepFunction push_step;
+};
+
+template <typename Message>
+struct CompactCalls {
+  static bool Serialize(const google::protobuf::Message &message,
+                        const google::protobuf::uint32 type,
+                        const bool booleans_as_numbers,
+                        const bool start_index_one,
+                        google::protobuf::io::ZeroCopyOutputStream *output) {
+    return static_cast<const Message &>(message)
+        .SerializePartialToZeroCopyJsonStream(
+            type, booleans_as_numbers, start_index_one, output);
+  }
+
+  static bool Parse(google::protobuf::Message *message,
+                    const google::protobuf::uint32 type,
+                    const bool booleans_as_numbers,
+                    const bool start_index_one,
+                    google::protobuf::io::ZeroCopyInputStream *input) {
+    if (message == NULL) {
+      return Message::ValidateZeroCopyJsonStream(
+          type, booleans_as_numbers, start_index_one, input);
+    }
+    return static_cast<Message *>(message)->ParsePartialFromZeroCopyJsonStream(
+        type, booleans_as_numbers, start_index_one, input);
+  }
+
+  // The child messages of CompactPushParseStep() are passed as
+  // google::protobuf::Message pointers.
+  static bool PushParseStep(void *message,
+                            const int event,
+                            const bool booleans_as_numbers,
+                            const char *text,
+                            const int text_size,
+                            google::protobuf::int32 *field_num,
+                            int *kind,
+                            void **child,
+                            void *child_step) {
+    return static_cast<Message *>(
+        static_cast<google::protobuf::Message *>(message))->PushParseStep(
+            event, booleans_as_numbers, text, text_size, field_num, kind,
+            child, child_step);
+  }
+
+  static const CompactMessageCalls calls;
+};
+
+template <typename Message>
+const CompactMessageCalls CompactCalls<Message>::calls = {
+  &CompactCalls<Message>::Serialize,
+  &CompactCalls<Message>::Parse,
+  &CompactCalls<Message>::PushParseStep
+};
+
+// One field of a message table, in declaration order so that the
+// descriptor of the field has the same index.
+struct CompactField {
+  google::protobuf::int32 number;
+  const char *name;
+  // A google::protobuf::FieldDescriptor::Type.
+  google::protobuf::uint8 type;
+  bool repeated;
+  // 64-bit integers are strings unless the field is annotated with jstype.
+  bool quoted;
+  // The generated <enum>_IsValid() of an enum field.
+  bool (*enum_is_valid)(int value);
+  // The class of a message or group field.
+  const CompactMessageCalls *message;
+};
+
+struct CompactMessage {
+  const CompactField *fields;
+  int field_count;
+  int max_name_length;
+};
+
+bool CompactSerialize(
+    const CompactMessage &table,
+    const google::protobuf::Message &message,
+    const google::protobuf::uint32 type,
+    const bool booleans_as_numbers,
+    const bool start_index_one,
+    google::protobuf::io::ZeroCopyOutputStream *output);
+
+// Accepts what the unrolled parser accepts. Only validates when message
+// is NULL.
+bool CompactParse(
+    const CompactMessage &table,
+    google::protobuf::Message *message,
+    const google::protobuf::uint32 type,
+    const bool booleans_as_numbers,
+    const bool start_index_one,
+    google::protobuf::io::ZeroCopyInputStream *input);
+
+// Parses the message at structurals[*cursor] from its text, as the
+// table has no use for the index within a message.
+bool CompactParseStructuralIndex(
+    const CompactMessage &table,
+    google::protobuf::Message *message,
+    const google::protobuf::uint32 type,
+    const bool booleans_as_numbers,
+    const bool start_index_one,
+    const char *data,
+    const google::protobuf::uint32 *structurals,
+    const size_t structural_count,
+    size_t *cursor);
+
+// Parses the binary data into the empty message and serializes it.
+// Mismatched wire types and unknown enum values, which the protobuf
+// parser keeps as unknown fields of known numbers, are rejected.
+bool CompactTranscodeBinary(
+    const CompactMessage &table,
+    google::protobuf::Message *message,
+    const google::protobuf::uint32 type,
+    const bool booleans_as_numbers,
+    const bool start_index_one,
+    const void *data,
+    int size,
+    google::protobuf::io::ZeroCopyOutputStream *output);
+
+bool CompactPushParseStep(
+    const CompactMessage &table,
+    google::protobuf::Message *message,
+    const int event,
+    const bool booleans_as_numbers,
+    const char *text,
+    const int text_size,
+    google::protobuf::int32 *field_num,
+    int *kind,
+    void **child,
+    void *child_step);
+
+}  // namespace runtime
+}  // namespace ccjs
+}  // namespace protobuf
+}  // namespace sg
+
+#endif  // PROTOBUF_CCJS_CCJS_COMPACT_H_
@@ -0,0 +1,1290 @@
+// Copyright (c) 2011 SameGoal LLC.
+// All Rights Reserved.
+// Author: Andy Hochhaus <ahochhaus@samegoal.com>
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The JSON runtime of the code that protoc-gen-ccjs generates: writing,
+// escaping, tokenizing and number conversion, shared by every .pb.cc
+// through the ccjs_runtime library instead of being pasted into each of
+// them. The templates and the small helpers of the hot loops stay in
+// this header. Only generated code includes it.
+
+#ifndef PROTOBUF_CCJS_CCJS_RUNTIME_H_
+#define PROTOBUF_CCJS_CCJS_RUNTIME_H_
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/repeated_field.h"
+#include "google/protobuf/stubs/common.h"
+#include "google/protobuf/wire_format_lite.h"
+
+// To trace where parsing fails, compile the runtime and the generated
+// code with RTN_FALSE defined as
+//   std::cout << __FILE__ << ":" << __LINE__ << std::endl; exit(1)
+// instead (with <iostream>). Otherwise it is only defined up to the end
+// of this header, ccjs_runtime.cc and the generated code define their
+// own.
+#ifndef RTN_FALSE
+#define RTN_FALSE return false
+#define CCJS_RUNTIME_H_RTN_FALSE
+#endif
+
+namespace sg {
+namespace protobuf {
+namespace ccjs {
+namespace runtime {
+
+// The JSON formats, passed as the type of the generated functions.
+const google::protobuf::uint32 PB_LITE = 1;
+const google::protobuf::uint32 OBJECT_KEY_NAME = 2;
+const google::protobuf::uint32 OBJECT_KEY_TAG = 3;
+
+// Parse*Array() inputs of at least CCJS_STRUCTURAL_INDEX_MIN_SIZE bytes
+// are parsed from a structural index of the whole input (built with
+// SSE2 where available) instead of being tokenized as a stream. Define
+// it when compiling the generated code to opt in, eg: 262144.
+
+inline bool WriteRaw(const char *value,
+                     const int length,
+                     google::protobuf::io::ZeroCopyOutputStream *output) {
+  int bytes_remaining = length;
+  while (bytes_remaining) {
+    void *buffer;
+    int size;
+    if (!output->Next(&buffer, &size)) {
+      RTN_FALSE;
+    }
+    const char *value_ptr = value + (length - bytes_remaining);
+    if (size >= bytes_remaining) {
+      memcpy(buffer, value_ptr, bytes_remaining);
+      int bytes_to_return = size - bytes_remaining;
+      if (bytes_to_return) {
+        output->BackUp(bytes_to_return);
+      }
+      bytes_remaining = 0;
+    } else if (size > 0) {
+      memcpy(buffer, value_ptr, size);
+      bytes_remaining -= size;
+    }
+  }
+  return true;
+}
+
+inline bool WriteRaw(const std::string &value,
+                     google::protobuf::io::ZeroCopyOutputStream *output) {
+  return WriteRaw(value.data(), value.length(), output);
+}
+
+bool WriteString(
+    const char *value,
+    const size_t size,
+    google::protobuf::io::ZeroCopyOutputStream *output);
+
+bool WriteString(
+    const std::string &value,
+    google::protobuf::io::ZeroCopyOutputStream *output);
+
+bool WritePbLiteNullEntries(
+    const google::protobuf::uint32 field_num,
+    const std::set<google::protobuf::uint32> repeated_field_set,
+    const bool start_index_one,
+    google::protobuf::uint32 *cur_field_num,
+    google::protobuf::io::ZeroCopyOutputStream *output);
+
+bool WriteObjectKey(
+    const std::string &key,
+    const bool prev_fields,
+    google::protobuf::io::ZeroCopyOutputStream *output);
+
+enum Token {
+  TOKEN_NONE,
+  TOKEN_CURLY_OPEN,
+  TOKEN_CURLY_CLOSE,
+  TOKEN_SQUARE_OPEN,
+  TOKEN_SQUARE_CLOSE,
+  TOKEN_COLON,
+  TOKEN_COMMA,
+  TOKEN_STRING,
+  TOKEN_NUMBER,
+  TOKEN_NULL,
+  TOKEN_TRUE,
+  TOKEN_FALSE
+};
+
+bool ReadToken(const bool eat_single_char_token,
+               Token *token,
+               google::protobuf::io::ZeroCopyInputStream *input);
+
+// Takes the place of a std::string for ReadString() when a string only
+// needs to be validated.
+struct DiscardedString {
+  void append(size_t, char) {}
+  void append(const char *, size_t) {}
+};
+
+// Reads the rest of a JSON string whose opening quote was just read,
+// unescaping it into value. Instantiated for std::string and
+// DiscardedString.
+template <typename String>
+bool ReadString(String *value,
+                google::protobuf::io::ZeroCopyInputStream *input);
+
+// Scans an optionally quoted integer straight from the input. The
+// magnitude is range checked against max_value (max_value + 1 when
+// negative) as each digit is consumed.
+bool ReadInteger(const bool quoted,
+                 const bool is_signed,
+                 const google::protobuf::uint64 max_value,
+                 bool *negative,
+                 google::protobuf::uint64 *magnitude,
+                 google::protobuf::io::ZeroCopyInputStream *input);
+
+bool ReadInt32(const bool quoted,
+               google::protobuf::int32 *value,
+               google::protobuf::io::ZeroCopyInputStream *input);
+
+bool ReadUInt32(const bool quoted,
+                google::protobuf::uint32 *value,
+                google::protobuf::io::ZeroCopyInputStream *input);
+
+bool ReadInt64(const bool quoted,
+               google::protobuf::int64 *value,
+               google::protobuf::io::ZeroCopyInputStream *input);
+
+bool ReadUInt64(const bool quoted,
+                google::protobuf::uint64 *value,
+                google::protobuf::io::ZeroCopyInputStream *input);
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+// True when the 8 bytes at chars are all ASCII digits.
+inline bool IsEightDigits(const char *chars) {
+  google::protobuf::uint64 block;
+  memcpy(&block, chars, 8);
+  return ((block & 0xF0F0F0F0F0F0F0F0ULL) |
+          (((block + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >>
+           4)) == 0x3333333333333333ULL;
+}
+
+// Converts 8 ASCII digits at once by combining neighbouring digits,
+// then pairs, then quads within one 64-bit word.
+inline google::protobuf::uint32 ParseEightDigits(const char *chars) {
+  google::protobuf::uint64 block;
+  memcpy(&block, chars, 8);
+  block = ((block & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+  block = ((block & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+  return static_cast<google::protobuf::uint32>(
+      ((block & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32);
+}
+#endif
+
+// Scans one array element of ReadIntegerArray() within [p, end) and
+// returns the position of the character after it. Returns NULL for
+// anything unusual (the element continuing past end, 20 digits, leading
+// zeros, out of range values or syntax errors), which ReadInteger()
+// then handles or rejects.
+inline const char *ScanIntegerElement(const char *p,
+                                      const char *end,
+                                      const bool quoted,
+                                      const bool is_signed,
+                                      const google::protobuf::uint64 max_value,
+                                      bool *negative,
+                                      google::protobuf::uint64 *magnitude) {
+  if (quoted) {
+    if (p == end || *p != '"') {
+      return NULL;
+    }
+    ++p;
+  }
+  *negative = p != end && *p == '-' && is_signed;
+  if (*negative) {
+    ++p;
+  }
+  const char *digits = p;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while (end - p >= 8 && p - digits < 16 && IsEightDigits(p)) {
+    p += 8;
+  }
+#endif
+  while (p != end && *p >= '0' && *p <= '9' && p - digits < 20) {
+    ++p;
+  }
+  const int digit_count = p - digits;
+  if (digit_count == 0 || digit_count > 19 ||
+      (digit_count > 1 && digits[0] == '0')) {
+    return NULL;
+  }
+  google::protobuf::uint64 value = 0;
+  int i = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  for (; digit_count - i >= 8; i += 8) {
+    value = value * 100000000 + ParseEightDigits(digits + i);
+  }
+#endif
+  for (; i < digit_count; ++i) {
+    value = value * 10 + (digits[i] - '0');
+  }
+  if (value > (*negative ? max_value + 1 : max_value)) {
+    return NULL;
+  }
+  if (quoted) {
+    if (p == end || *p != '"') {
+      return NULL;
+    }
+    ++p;
+  }
+  *magnitude = value;
+  return p == end ? NULL : p;
+}
+
+// Reads the elements of an integer array whose opening bracket was just
+// read, up to and including the closing bracket, straight into values
+// (a RepeatedField or anything else with its value_type and Add(), or
+// NULL to only check them). Elements are scanned in place within each
+// buffer of input and only those crossing a buffer boundary go through
+// ReadInteger().
+template <typename Values>
+bool ReadIntegerArray(
+    const bool quoted,
+    const bool is_signed,
+    const google::protobuf::uint64 max_value,
+    Values *values,
+    google::protobuf::io::ZeroCopyInputStream *input) {
+  bool first = true;
+  const void *read_buffer;
+  int read_size;
+  while (input->Next(&read_buffer, &read_size)) {
+    const char *p = static_cast<const char *> (read_buffer);
+    const char *end = p + read_size;
+    while (p != end) {
+      if (first && *p == ']') {
+        input->BackUp(end - p - 1);
+        return true;
+      }
+      first = false;
+      bool negative;
+      google::protobuf::uint64 magnitude;
+      const char *next = ScanIntegerElement(
+          p, end, quoted, is_signed, max_value, &negative, &magnitude);
+      if (next == NULL) {
+        input->BackUp(end - p);
+        Token token;
+        if (!ReadInteger(quoted, is_signed, max_value, &negative,
+                         &magnitude, input) ||
+            !ReadToken(true, &token, input)) {
+          RTN_FALSE;
+        }
+        if (values != NULL) {
+          values->Add(static_cast<typename Values::value_type>(
+              negative ? 0 - magnitude : magnitude));
+        }
+        if (token == TOKEN_SQUARE_CLOSE) {
+          return true;
+        } else if (token != TOKEN_COMMA) {
+          RTN_FALSE;
+        }
+        break;
+      }
+      if (values != NULL) {
+        values->Add(static_cast<typename Values::value_type>(
+            negative ? 0 - magnitude : magnitude));
+      }
+      if (*next == ']') {
+        input->BackUp(end - next - 1);
+        return true;
+      } else if (*next != ',') {
+        RTN_FALSE;
+      }
+      p = next + 1;
+    }
+  }
+  RTN_FALSE;
+}
+
+bool ReadDouble(const bool quoted,
+                double *value,
+                google::protobuf::io::ZeroCopyInputStream *input);
+
+bool ReadFloat(const bool quoted,
+               float *value,
+               google::protobuf::io::ZeroCopyInputStream *input);
+
+// Advances *cur_field_num to the next slot that holds a value, which
+// is left in token, or sets it to -1 at the end of the array. first is
+// true right after the opening bracket.
+bool ReadPbLiteNextTag(
+    const bool first,
+    google::protobuf::int32 *cur_field_num,
+    Token *token,
+    google::protobuf::io::ZeroCopyInputStream *input);
+
+// Reads the ',' or ']' after an element of a repeated field into token.
+// A comma must be followed by another element.
+bool ReadArraySeparator(
+    Token *token,
+    google::protobuf::io::ZeroCopyInputStream *input);
+
+// Decodes the characters of an object key up to and including the
+// closing quote without allocating. Keys longer than capacity can
+// never match a field name and are reported with a key_size of
+// capacity + 1. Escapes that cannot appear in a field name are stored
+// as '\\' for the same reason.
+bool ReadObjectKeyChars(
+    char *key,
+    const int capacity,
+    int *key_size,
+    google::protobuf::io::ZeroCopyInputStream *input);
+
+// Reads an object key into key without allocating, see
+// ReadObjectKeyChars(). A key_size of 0 marks the end of the object.
+// first is true right after the opening brace.
+bool ReadObjectKey(const bool first,
+                   char *key,
+                   const int capacity,
+                   int *key_size,
+                   Token *token,
+                   google::protobuf::io::ZeroCopyInputStream *input);
+
+bool ReadObjectKeyTag(
+    const bool first,
+    google::protobuf::int32 *cur_field_num,
+    Token *token,
+    google::protobuf::io::ZeroCopyInputStream *input);
+
+// Skips the value of a field that is not in the schema. token was
+// returned by ReadToken(false, ...) so literals are already consumed.
+bool SkipValue(const Token token,
+               google::protobuf::io::ZeroCopyInputStream *input);
+
+// Counts the elements of the array whose opening bracket was just read
+// when it closes within the current buffer of input, and returns 0
+// otherwise. Used to reserve repeated fields before they are filled.
+// Blocks of 16 bytes without quotes or brackets are counted at once.
+int CountArrayElements(
+    google::protobuf::io::ZeroCopyInputStream *input);
+
+// The structural index lists the positions of { } [ ] : , and of every
+// opening quote outside of strings, followed by a sentinel equal to the
+// input size. Whitespace is not allowed between tokens so every value
+// either starts with a structural character or fills the gap between
+// two of them.
+struct StructuralIndex {
+  const char *data;
+  const google::protobuf::uint32 *structurals;
+  size_t count;
+};
+
+// Stage one of the large payload parser, classifies 64 bytes at a time.
+bool BuildStructuralIndex(
+    const char *data,
+    const int size,
+    std::vector<google::protobuf::uint32> *structurals);
+
+// Returns the structural character at i, or '\0' for the sentinel.
+inline char IndexChar(const StructuralIndex &index, const size_t i) {
+  if (i + 1 >= index.count) {
+    return '\0';
+  }
+  return index.data[index.structurals[i]];
+}
+
+// True when structural i + 1 directly follows structural i.
+inline bool IndexAdjacent(const StructuralIndex &index, const size_t i) {
+  return i + 1 < index.count &&
+      index.structurals[i + 1] == index.structurals[i] + 1;
+}
+
+// Steps over the closing bracket at *cursor. Only the end of the input
+// may follow it without being the next structural.
+inline bool IndexClose(const StructuralIndex &index, size_t *cursor) {
+  if (*cursor + 2 < index.count && !IndexAdjacent(index, *cursor)) {
+    RTN_FALSE;
+  }
+  ++*cursor;
+  return true;
+}
+
+// Value readers expect *cursor at the structural preceding the value
+// ('[', ',' or ':') and leave it at the structural following the value.
+inline bool IndexEnterValue(const StructuralIndex &index, size_t *cursor) {
+  if (!IndexAdjacent(index, *cursor)) {
+    RTN_FALSE;
+  }
+  ++*cursor;
+  return true;
+}
+
+// Locates a number or literal. The span of an unquoted value includes
+// the structural after it since the scanners expect a terminator.
+bool IndexValueSpan(const StructuralIndex &index,
+                    const bool quoted,
+                    size_t *cursor,
+                    const char **span,
+                    int *span_size);
+
+bool IndexReadBool(const StructuralIndex &index,
+                   const bool booleans_as_numbers,
+                   size_t *cursor,
+                   bool *value);
+
+// Strings without escapes are copied as is.
+bool IndexReadString(const StructuralIndex &index,
+                     size_t *cursor,
+                     std::string *value);
+
+// Steps to the next element of an array. *cursor is at the opening
+// bracket before the first element and at the structural following the
+// previous element otherwise. more is false once the array is closed.
+bool IndexNextElement(const StructuralIndex &index,
+                      const bool first,
+                      size_t *cursor,
+                      bool *more);
+
+// Counts the elements of the array opening at structural open, see
+// CountArrayElements(). Returns 0 when the array is not closed.
+int IndexCountElements(const StructuralIndex &index,
+                       const size_t open);
+
+// Steps over the array or object opening at structural *cursor and
+// returns its text. Only the outer brackets are checked to match, the
+// text is verified when it is parsed.
+bool IndexSkipNested(const StructuralIndex &index,
+                     size_t *cursor,
+                     const char **span,
+                     int *span_size);
+
+// Steps over the value following the structural at *cursor whatever its
+// type, for fields that are not in the schema.
+bool IndexSkipValue(const StructuralIndex &index, size_t *cursor);
+
+// Skips null and empty slots like ReadPbLiteNextTag().
+bool IndexPbLiteNextTag(const StructuralIndex &index,
+                        const bool first,
+                        const bool start_index_one,
+                        size_t *cursor,
+                        google::protobuf::int32 *cur_field_num);
+
+// Keys without escapes are returned in place, others are decoded into
+// buffer by ReadObjectKeyChars(). A key_size of 0 marks the end of the
+// object.
+bool IndexObjectKey(const StructuralIndex &index,
+                    const bool first,
+                    char *buffer,
+                    const int capacity,
+                    size_t *cursor,
+                    const char **key,
+                    int *key_size);
+
+bool IndexObjectKeyTag(const StructuralIndex &index,
+                       const bool first,
+                       size_t *cursor,
+                       google::protobuf::int32 *cur_field_num);
+
+// Incremental parsing, see the PushParser declared for every message.
+// Nested messages are filled in through PushStep<>() so that messages
+// of other files are reached as well.
+enum PushEvent {
+  PUSH_KEY = 1,
+  PUSH_OPEN,
+  PUSH_OPEN_ELEMENT,
+  PUSH_VALUE,
+  PUSH_VALUE_ELEMENT
+};
+
+enum PushKind {
+  PUSH_UNKNOWN,
+  PUSH_ARRAY,
+  PUSH_MESSAGE
+};
+
+typedef bool (*PushStepFunction)(void *message,
+                                 const int event,
+                                 const bool booleans_as_numbers,
+                                 const char *text,
+                                 const int text_size,
+                                 google::protobuf::int32 *field_num,
+                                 int *kind,
+                                 void **child,
+                                 void *child_step);
+
+template <typename Message>
+bool PushStep(void *message,
+              const int event,
+              const bool booleans_as_numbers,
+              const char *text,
+              const int text_size,
+              google::protobuf::int32 *field_num,
+              int *kind,
+              void **child,
+              void *child_step) {
+  return static_cast<Message *>(message)->PushParseStep(
+      event, booleans_as_numbers, text, text_size, field_num, kind,
+      child, child_step);
+}
+
+enum PushFrameState {
+  PUSH_OPENED,
+  PUSH_COMMA,
+  PUSH_KEY_READ,
+  PUSH_COLON_READ,
+  PUSH_VALUE_READ
+};
+
+// An open message, or the array of a repeated field when array is set.
+struct PushFrame {
+  void *message;
+  PushStepFunction step;
+  bool array;
+  google::protobuf::int32 field_num;
+  int state;
+};
+
+enum PushToken {
+  PUSH_NO_TOKEN,
+  PUSH_KEY_TOKEN,
+  PUSH_STRING_TOKEN,
+  PUSH_NUMBER_TOKEN,
+  PUSH_LITERAL_TOKEN,
+  PUSH_SKIP_TOKEN
+};
+
+struct PushState {
+  google::protobuf::uint32 type;
+  bool booleans_as_numbers;
+  bool start_index_one;
+  void *root;
+  PushStepFunction root_step;
+  std::vector<PushFrame> frames;
+  bool done;
+  bool failed;
+  // The token that the previous chunk ended in.
+  int token;
+  std::string text;
+  bool escaped;
+  bool in_string;
+  int skip_depth;
+  char skip_close;
+};
+
+void PushStart(PushState *state,
+               void *message,
+               const PushStepFunction step,
+               const google::protobuf::uint32 type,
+               const bool booleans_as_numbers,
+               const bool start_index_one);
+
+bool PushFeed(PushState *state, const char *data, const size_t size);
+
+bool PushFinish(PushState *state);
+
+// The spans of the singular message fields that a LazyView has skipped.
+// They point into the input of the view, which must outlive them.
+class LazySpans {
+ public:
+  LazySpans();
+
+  void Reset(const google::protobuf::uint32 type,
+             const bool booleans_as_numbers,
+             const bool start_index_one);
+
+  void Record(const google::protobuf::int32 field_num,
+              const char *span,
+              const int span_size);
+
+  // True when field_num has spans left to parse or failed to parse.
+  bool Pending(const google::protobuf::int32 field_num) const;
+
+  // Parses the spans of field_num into message in input order. Returns
+  // false, now and on every later call, if one of them is invalid.
+  template <typename Message>
+  bool Parse(const google::protobuf::int32 field_num, Message *message);
+
+ private:
+  struct Span {
+    google::protobuf::int32 field_num;
+    const char *data;
+    int size;
+  };
+
+  google::protobuf::uint32 type_;
+  bool booleans_as_numbers_;
+  bool start_index_one_;
+  std::vector<Span> spans_;
+  std::vector<google::protobuf::int32> failed_;
+
+  LazySpans(const LazySpans &);
+  void operator=(const LazySpans &);
+};
+
+// Stage two of the large payload parser. Messages walk the structural
+// index of the whole input instead of tokenizing it again. Singular
+// message fields are only recorded into lazy unless it is NULL.
+template <typename Message>
+bool ParseWithStructuralIndex(Message *message,
+                              const google::protobuf::uint32 type,
+                              const bool booleans_as_numbers,
+                              const bool start_index_one,
+                              LazySpans *lazy,
+                              const void *data,
+                              const int size) {
+  const char *chars = static_cast<const char *>(data);
+  std::vector<google::protobuf::uint32> structurals;
+  if (!BuildStructuralIndex(chars, size, &structurals) ||
+      structurals[0] != 0) {
+    RTN_FALSE;
+  }
+  size_t cursor = 0;
+  if (!message->ParsePartialFromStructuralIndex(
+          type, booleans_as_numbers, start_index_one, lazy, chars,
+          structurals.data(), structurals.size(), &cursor)) {
+    RTN_FALSE;
+  }
+  // The closing bracket must be the last char of the input.
+  if (cursor + 1 != structurals.size() ||
+      structurals[cursor - 1] + 1 != static_cast<google::protobuf::uint32>(
+          size)) {
+    RTN_FALSE;
+  }
+  return true;
+}
+
+template <typename Message>
+bool LazySpans::Parse(const google::protobuf::int32 field_num,
+                      Message *message) {
+  if (std::find(failed_.begin(), failed_.end(), field_num) !=
+      failed_.end()) {
+    RTN_FALSE;
+  }
+  std::vector<Span>::iterator span = spans_.begin();
+  while (span != spans_.end()) {
+    if (span->field_num != field_num) {
+      ++span;
+      continue;
+    }
+    if (!ParseWithStructuralIndex(message, type_, booleans_as_numbers_,
+                                  start_index_one_, NULL, span->data,
+                                  span->size)) {
+      failed_.push_back(field_num);
+      RTN_FALSE;
+    }
+    span = spans_.erase(span);
+  }
+  return true;
+}
+
+#ifndef CCJS_MAPPED_BLOCK_SIZE
+#define CCJS_MAPPED_BLOCK_SIZE (1 << 30)
+#endif
+
+// Maps a whole file read-only for one sequential pass. As a
+// ZeroCopyInputStream it hands the mapping out in blocks of at most
+// CCJS_MAPPED_BLOCK_SIZE bytes, so files above the 2 GB int limit of
+// ArrayInputStream can be parsed as well. Pipes and other files that
+// are not regular cannot be mapped and are read into a buffer instead.
+class MappedFileInputStream
+    : public google::protobuf::io::ZeroCopyInputStream {
+ public:
+  explicit MappedFileInputStream(const char *path)
+      : data_(NULL), size_(0), position_(0), last_returned_size_(0),
+        mapped_(false) {
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+      return;
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+      close(fd);
+      return;
+    }
+    if (!S_ISREG(file_stat.st_mode)) {
+      ReadAll(fd);
+    } else if (file_stat.st_size > 0) {
+      void *data = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE,
+                        fd, 0);
+      if (data != MAP_FAILED) {
+        madvise(data, file_stat.st_size, MADV_SEQUENTIAL);
+        data_ = static_cast<const char *>(data);
+        size_ = file_stat.st_size;
+        mapped_ = true;
+      }
+    } else {
+      mapped_ = true;
+    }
+    close(fd);
+  }
+
+  ~MappedFileInputStream() {
+    if (data_ != NULL && data_ != buffer_.data()) {
+      munmap(const_cast<char *>(data_), size_);
+    }
+  }
+
+  bool mapped() const { return mapped_; }
+  const char *data() const { return data_; }
+  size_t size() const { return size_; }
+
+  bool Next(const void **data, int *size) {
+    if (position_ == size_) {
+      last_returned_size_ = 0;
+      return false;
+    }
+    last_returned_size_ = static_cast<int>(
+        std::min<size_t>(size_ - position_, CCJS_MAPPED_BLOCK_SIZE));
+    *data = data_ + position_;
+    *size = last_returned_size_;
+    position_ += last_returned_size_;
+    return true;
+  }
+
+  void BackUp(int count) {
+    position_ -= count;
+    last_returned_size_ = 0;
+  }
+
+  bool Skip(int count) {
+    last_returned_size_ = 0;
+    if (static_cast<size_t>(count) > size_ - position_) {
+      position_ = size_;
+      return false;
+    }
+    position_ += count;
+    return true;
+  }
+
+  google::protobuf::int64 ByteCount() const { return position_; }
+
+ private:
+  const char *data_;
+  size_t size_;
+  size_t position_;
+  int last_returned_size_;
+  bool mapped_;
+  std::string buffer_;
+
+  void ReadAll(const int fd) {
+    char chunk[65536];
+    while (true) {
+      const ssize_t count = read(fd, chunk, sizeof(chunk));
+      if (count == 0) {
+        break;
+      } else if (count < 0 && errno != EINTR) {
+        return;
+      } else if (count > 0) {
+        buffer_.append(chunk, count);
+      }
+    }
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    mapped_ = true;
+  }
+
+  MappedFileInputStream(const MappedFileInputStream &);
+  void operator=(const MappedFileInputStream &);
+};
+
+// Sets *c to the next char of input without consuming it. Returns false
+// at the end of input.
+bool PeekChar(google::protobuf::io::ZeroCopyInputStream *input,
+              char *c);
+
+// True when no chars are left in input. Entry points that parse a whole
+// input reject anything after the message, as the structural index does.
+bool AtEndOfInput(google::protobuf::io::ZeroCopyInputStream *input);
+
+// Parses the file at path straight from its mapping. Files that fit the
+// 32-bit positions of the structural index may use it like the
+// Parse*Array() entry points, larger ones are parsed as a stream.
+template <typename Message>
+bool ParseFile(Message *message,
+               const char *path,
+               const google::protobuf::uint32 type,
+               const bool booleans_as_numbers,
+               const bool start_index_one) {
+  MappedFileInputStream input(path);
+  if (!input.mapped()) {
+    RTN_FALSE;
+  }
+#ifdef CCJS_STRUCTURAL_INDEX_MIN_SIZE
+  if (input.size() >= CCJS_STRUCTURAL_INDEX_MIN_SIZE &&
+      input.size() <= static_cast<size_t>(
+          std::numeric_limits<int>::max())) {
+    return ParseWithStructuralIndex(
+        message, type, booleans_as_numbers, start_index_one, NULL,
+        input.data(), input.size());
+  }
+#endif
+  return message->ParsePartialFromZeroCopyJsonStream(
+      type, booleans_as_numbers, start_index_one, &input) &&
+      AtEndOfInput(&input);
+}
+
+// Parses one message per line of input into message, which is cleared
+// before each line so that its allocations are reused, and passes it to
+// callback. Empty lines and "\r\n" line ends are accepted.
+template <typename Message>
+bool ParseDelimited(Message *message,
+                    const google::protobuf::uint32 type,
+                    const bool booleans_as_numbers,
+                    const bool start_index_one,
+                    google::protobuf::io::ZeroCopyInputStream *input,
+                    bool (*callback)(const Message &message, void *arg),
+                    void *arg) {
+  bool line_start = true;
+  char c;
+  while (PeekChar(input, &c)) {
+    if (c == '\n' || c == '\r') {
+      input->Skip(1);
+      line_start = true;
+      continue;
+    }
+    if (!line_start) {
+      RTN_FALSE;
+    }
+    message->Clear();
+    if (!message->ParsePartialFromZeroCopyJsonStream(
+            type, booleans_as_numbers, start_index_one, input) ||
+        !callback(*message, arg)) {
+      RTN_FALSE;
+    }
+    line_start = false;
+  }
+  return true;
+}
+
+// Appends the [begin, end) offsets of the elements of the JSON array at
+// the start of data to elements. Only strings and nesting are tracked,
+// the elements themselves are validated when they are parsed.
+bool FindArrayElements(
+    const char *data,
+    const size_t size,
+    std::vector<std::pair<size_t, size_t> > *elements);
+
+template <typename Message>
+struct ArrayParseTask {
+  Message **messages;
+  const char *data;
+  const std::pair<size_t, size_t> *elements;
+  size_t count;
+  google::protobuf::uint32 type;
+  bool booleans_as_numbers;
+  bool start_index_one;
+  bool result;
+};
+
+template <typename Message>
+void *RunArrayParseTask(void *arg) {
+  ArrayParseTask<Message> *task =
+      static_cast<ArrayParseTask<Message> *>(arg);
+  task->result = false;
+  for (size_t i = 0; i < task->count; ++i) {
+    const std::pair<size_t, size_t> &span = task->elements[i];
+    const size_t size = span.second - span.first;
+    if (size > static_cast<size_t>(std::numeric_limits<int>::max())) {
+      return NULL;
+    }
+    const char *element = task->data + span.first;
+#ifdef CCJS_STRUCTURAL_INDEX_MIN_SIZE
+    if (size >= CCJS_STRUCTURAL_INDEX_MIN_SIZE) {
+      if (!ParseWithStructuralIndex(
+              task->messages[i], task->type, task->booleans_as_numbers,
+              task->start_index_one, NULL, element, size)) {
+        return NULL;
+      }
+      continue;
+    }
+#endif
+    google::protobuf::io::ArrayInputStream input(element, size);
+    if (!task->messages[i]->ParsePartialFromZeroCopyJsonStream(
+            task->type, task->booleans_as_numbers,
+            task->start_index_one, &input) ||
+        !AtEndOfInput(&input)) {
+      return NULL;
+    }
+  }
+  task->result = true;
+  return NULL;
+}
+
+#ifndef CCJS_PARALLEL_ARRAY_MIN_SIZE
+#define CCJS_PARALLEL_ARRAY_MIN_SIZE (1 << 18)
+#endif
+
+// Parses a JSON array of messages into messages. The elements are split
+// into thread_count runs of about the same number of bytes, each parsed
+// on its own thread, so the order of the elements is kept. Starting a
+// thread costs about as much as parsing tens of KB, so every run gets at
+// least CCJS_PARALLEL_ARRAY_MIN_SIZE bytes and smaller arrays are parsed
+// on the calling thread alone.
+template <typename Message>
+bool ParseArrayOfMessages(
+    const google::protobuf::uint32 type,
+    const bool booleans_as_numbers,
+    const bool start_index_one,
+    const void *data,
+    const size_t size,
+    int thread_count,
+    google::protobuf::RepeatedPtrField<Message> *messages) {
+  const char *chars = static_cast<const char *>(data);
+  std::vector<std::pair<size_t, size_t> > elements;
+  if (!FindArrayElements(chars, size, &elements)) {
+    RTN_FALSE;
+  }
+  if (thread_count <= 0) {
+    thread_count = sysconf(_SC_NPROCESSORS_ONLN);
+  }
+  const size_t max_threads = std::max<size_t>(
+      1, std::min<size_t>(elements.size(),
+                          size / CCJS_PARALLEL_ARRAY_MIN_SIZE));
+  if (thread_count <= 0 ||
+      static_cast<size_t>(thread_count) > max_threads) {
+    thread_count = max_threads;
+  }
+
+  const int first = messages->size();
+  messages->Reserve(first + elements.size());
+  std::vector<Message *> added(elements.size());
+  for (size_t i = 0; i < elements.size(); ++i) {
+    added[i] = messages->Add();
+  }
+
+  std::vector<ArrayParseTask<Message> > tasks(thread_count);
+  size_t element = 0;
+  for (int t = 0; t < thread_count; ++t) {
+    const size_t end_offset = size / thread_count * (t + 1);
+    const size_t begin = element;
+    while (element < elements.size() &&
+           (t == thread_count - 1 ||
+            elements[element].first < end_offset)) {
+      ++element;
+    }
+    ArrayParseTask<Message> &task = tasks[t];
+    task.messages = added.data() + begin;
+    task.data = chars;
+    task.elements = elements.data() + begin;
+    task.count = element - begin;
+    task.type = type;
+    task.booleans_as_numbers = booleans_as_numbers;
+    task.start_index_one = start_index_one;
+  }
+
+  std::vector<pthread_t> threads(thread_count);
+  std::vector<bool> started(thread_count, false);
+  for (int t = 1; t < thread_count; ++t) {
+    started[t] = pthread_create(&threads[t], NULL,
+                                &RunArrayParseTask<Message>,
+                                &tasks[t]) == 0;
+    if (!started[t]) {
+      RunArrayParseTask<Message>(&tasks[t]);
+    }
+  }
+  RunArrayParseTask<Message>(&tasks[0]);
+  bool result = tasks[0].result;
+  for (int t = 1; t < thread_count; ++t) {
+    if (started[t]) {
+      pthread_join(threads[t], NULL);
+    }
+    result = result && tasks[t].result;
+  }
+  if (!result) {
+    messages->DeleteSubrange(first, elements.size());
+    RTN_FALSE;
+  }
+  return true;
+}
+
+typedef google::protobuf::internal::WireFormatLite WireFormatLite;
+
+// Encodings of integer values in the binary wire format.
+enum WireEncoding {
+  WIRE_VARINT,
+  WIRE_ZIGZAG,
+  WIRE_FIXED32,
+  WIRE_FIXED64,
+};
+
+inline void AppendVarint(google::protobuf::uint64 value, std::string *output) {
+  while (value >= 0x80) {
+    output->push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  output->push_back(static_cast<char>(value));
+}
+
+inline void AppendFixed(google::protobuf::uint64 value,
+                        const int size,
+                        std::string *output) {
+  for (int i = 0; i < size; ++i) {
+    output->push_back(static_cast<char>(value));
+    value >>= 8;
+  }
+}
+
+// Appends the WireBits() of a value in encoding. Negative int32 values
+// are sign extended to ten byte varints like protobuf does.
+void AppendWireInteger(const WireEncoding encoding,
+                       const google::protobuf::uint64 value,
+                       std::string *output);
+
+// Converts a field value to the bits that AppendWireInteger() encodes.
+template <typename Value>
+google::protobuf::uint64 WireBits(const Value value) {
+  return static_cast<google::protobuf::uint64>(value);
+}
+
+inline google::protobuf::uint64 WireBits(const float value) {
+  return WireFormatLite::EncodeFloat(value);
+}
+
+inline google::protobuf::uint64 WireBits(const double value) {
+  return WireFormatLite::EncodeDouble(value);
+}
+
+// Takes the place of a RepeatedField (or of the set_ of a singular
+// field) and appends every value to output instead, preceded by tag
+// unless it is 0 for the elements of a packed field.
+template <typename Value>
+struct WireValueWriter {
+  typedef Value value_type;
+
+  void Add(const Value value) {
+    if (tag != 0) {
+      AppendVarint(tag, output);
+    }
+    AppendWireInteger(encoding, WireBits(value), output);
+  }
+
+  google::protobuf::uint32 tag;
+  WireEncoding encoding;
+  std::string *output;
+};
+
+// Length-delimited values are appended after a one byte length, which
+// EndLengthDelimited() fills in and widens if needed.
+inline size_t BeginLengthDelimited(std::string *output) {
+  output->push_back(0);
+  return output->size();
+}
+
+void EndLengthDelimited(const size_t begin, std::string *output);
+
+// One occurrence of a field in a binary message. [begin, end) holds the
+// value without its tag: the varint or fixed bytes, the payload of a
+// length-delimited value or the fields of a group.
+struct WireField {
+  google::protobuf::uint32 number;
+  google::protobuf::uint32 wire_type;
+  int begin;
+  int end;
+
+  bool operator<(const WireField &other) const {
+    return number < other.number;
+  }
+};
+
+// Indexes the fields of the binary message in data and sorts them by
+// number, keeping repeated occurrences in order.
+bool IndexWireFields(const google::protobuf::uint8 *data,
+                     const int size,
+                     std::vector<WireField> *fields);
+
+// Finds the occurrences of field number in fields as [*first, *last).
+void FindWireFields(const std::vector<WireField> &fields,
+                    const google::protobuf::uint32 number,
+                    const WireField **first,
+                    const WireField **last);
+
+// Finds the value of a singular message field, which protobuf merges
+// from all of its occurrences in [first, last), and checks their wire
+// type. More than one occurrence is concatenated into merged.
+bool MergeWireFields(const google::protobuf::uint8 *bytes,
+                     const WireField *first,
+                     const WireField *last,
+                     const google::protobuf::uint32 wire_type,
+                     std::string *merged,
+                     const google::protobuf::uint8 **value,
+                     int *value_size);
+
+// Reads the next value of encoding at *p (before end) into value and
+// advances *p. Zigzag values are decoded to the bits of their int64.
+bool ReadWireInteger(const WireEncoding encoding,
+                     const google::protobuf::uint8 **p,
+                     const google::protobuf::uint8 *end,
+                     google::protobuf::uint64 *value);
+
+// Returns the wire type of a single value of encoding.
+google::protobuf::uint32 WireTypeOf(const WireEncoding encoding);
+
+// Passes the buffers of input through and, while recording, appends
+// the bytes that the reader consumes to a string, so that a value
+// checked by the parser can be copied verbatim. A buffer is only
+// appended once the reader moves past it, as BackUp() may still return
+// its tail.
+class RecordingInputStream
+    : public google::protobuf::io::ZeroCopyInputStream {
+ public:
+  explicit RecordingInputStream(
+      google::protobuf::io::ZeroCopyInputStream *input)
+      : input_(input),
+        recorded_(NULL),
+        pending_(NULL),
+        pending_size_(0) {}
+
+  // Starts appending to recorded, or stops for NULL.
+  void Record(std::string *recorded) {
+    Flush();
+    recorded_ = recorded;
+  }
+
+  bool Next(const void **data, int *size) {
+    Flush();
+    if (!input_->Next(data, size)) {
+      return false;
+    }
+    if (recorded_ != NULL) {
+      pending_ = static_cast<const char *>(*data);
+      pending_size_ = *size;
+    }
+    return true;
+  }
+
+  void BackUp(int count) {
+    input_->BackUp(count);
+    if (pending_ != NULL) {
+      pending_size_ -= count;
+    }
+  }
+
+  bool Skip(int count) {
+    if (recorded_ == NULL) {
+      return input_->Skip(count);
+    }
+    while (count > 0) {
+      const void *data;
+      int size;
+      if (!Next(&data, &size)) {
+        return false;
+      }
+      if (size > count) {
+        BackUp(size - count);
+      }
+      count -= size;
+    }
+    return true;
+  }
+
+  google::protobuf::int64 ByteCount() const {
+    return input_->ByteCount();
+  }
+
+ private:
+  void Flush() {
+    if (pending_ != NULL) {
+      recorded_->append(pending_, pending_size_);
+      pending_ = NULL;
+    }
+  }
+
+  google::protobuf::io::ZeroCopyInputStream *input_;
+  std::string *recorded_;
+  const char *pending_;
+  int pending_size_;
+};
+
+// One value of a field held by a JSON transcoder: [begin, end) of its
+// values string, which for a repeated field holds the comma separated
+// elements.
+struct JsonValue {
+  google::protobuf::uint32 number;
+  size_t begin;
+  size_t end;
+
+  bool operator<(const JsonValue &other) const {
+    return number < other.number;
+  }
+};
+
+// Adds the value that was appended to values from begin for field
+// number to fields, less the closing bracket of the elements of a
+// repeated field. Empty arrays are not added.
+void AddJsonValue(const google::protobuf::uint32 number,
+                  const size_t begin,
+                  const bool elements,
+                  const std::string &values,
+                  std::vector<JsonValue> *fields);
+
+// Whether fields holds a value of field number.
+bool HasJsonValue(const std::vector<JsonValue> &fields,
+                  const google::protobuf::uint32 number);
+
+// Finds the values of field number in the sorted fields as
+// [*first, *last).
+void FindJsonValues(const std::vector<JsonValue> &fields,
+                    const google::protobuf::uint32 number,
+                    const JsonValue **first,
+                    const JsonValue **last);
+
+// Writes the last of the values [first, last) of a singular field, as
+// the parser keeps the last, or all of them as one array.
+bool WriteJsonValues(
+    const std::string &values,
+    const JsonValue *first,
+    const JsonValue *last,
+    const bool repeated,
+    google::protobuf::io::ZeroCopyOutputStream *output);
+
+// Appends the booleans of a JSON transcoder to values in the format of
+// SerializePartialToZeroCopyJsonStream(), comma separated.
+struct JsonBoolWriter {
+  typedef bool value_type;
+
+  bool as_numbers;
+  int count;
+  std::string *values;
+
+  void Add(const bool value) {
+    if (count++ > 0) {
+      values->push_back(',');
+    }
+    values->append(as_numbers ? (value ? "1" : "0") :
+                   (value ? "true" : "false"));
+  }
+};
+
+}  // namespace runtime
+}  // namespace ccjs
+}  // namespace protobuf
+}  // namespace sg
+
+#ifdef CCJS_RUNTIME_H_RTN_FALSE
+#undef RTN_FALSE
+#undef CCJS_RUNTIME_H_RTN_FALSE
+#endif
+
+#endif  // PROTOBUF_CCJS_CCJS_RUNTIME_H_
@@ -14,15 +14,64 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include <gtest/gtest.h>
 
+#include <new>
+#include <random>
 #include <string>
+#include <vector>
+
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 
 #include "base/init.h"
+#include "protobuf/ccjs/ccjs_runtime.h"
+#include "protobuf/js/code_size_test.pb.h"
 #include "protobuf/js/test.pb.h"
 #include "protobuf/js/package_test.pb.h"
 
+// Counts the heap allocations of the whole binary, see TEST(Reparse, *).
+// Every form of operator new that allocates through malloc() is paired
+// with the unsized and sized forms of the matching operator delete.
+int allocation_count = 0;
+
+void *CountedAllocate(size_t size) {
+  ++allocation_count;
+  void *allocation = malloc(size ? size : 1);
+  if (allocation == NULL) {
+    throw std::bad_alloc();
+  }
+  return allocation;
+}
+
+void *operator new(size_t size) {
+  return CountedAllocate(size);
+}
+
+void *operator new[](size_t size) {
+  return CountedAllocate(size);
+}
+
+void operator delete(void *allocation) noexcept {
+  free(allocation);
+}
+
+void operator delete(void *allocation, size_t) noexcept {
+  free(allocation);
+}
+
+void operator delete[](void *allocation) noexcept {
+  free(allocation);
+}
+
+void operator delete[](void *allocation, size_t) noexcept {
+  free(allocation);
+}
+
 void PopulateMessage(TestAllTypes *message) {
   message->set_optional_int32(101);
   message->set_optional_int64(102);
@@ -428,6 +477,1332 @@ TEST(ObjectKeyTag, EscapeDeserialization) {
   ASSERT_EQ(special_char_string, message.optional_bytes());
 }
 
+TEST(ObjectKeyTag, IntegerRangeDeserialization) {
+  TestAllTypes message;
+  ASSERT_TRUE(message.ParsePartialFromObjectKeyTagString(
+      "{\"1\":-2147483648,\"3\":4294967295,"
+      "\"2\":\"-9223372036854775808\",\"4\":\"18446744073709551615\"}"));
+  ASSERT_EQ(-2147483647 - 1, message.optional_int32());
+  ASSERT_EQ(4294967295u, message.optional_uint32());
+  ASSERT_EQ(-9223372036854775807ll - 1, message.optional_int64());
+  ASSERT_EQ(18446744073709551615ull, message.optional_uint64());
+
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString(
+      "{\"1\":2147483648}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString(
+      "{\"1\":-2147483649}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString(
+      "{\"3\":4294967296}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"3\":-1}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString(
+      "{\"2\":\"9223372036854775808\"}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString(
+      "{\"4\":\"18446744073709551616\"}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"1\":1.5}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"1\":01}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"2\":102}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"50\":\"1\"}"));
+}
+
+TEST(ObjectKeyTag, IntegerArrayDeserialization) {
+  const std::string json =
+      "{\"31\":[-2147483648,0,2147483647,12345678,123456789],"
+      "\"33\":[],\"34\":[\"18446744073709551615\",\"1234567890123456\"],"
+      "\"32\":[\"-9223372036854775808\",\"-0\"],"
+      "\"52\":[9007199254740993,-7]}";
+  // Every block size splits some element across buffers.
+  for (int block_size = 1; block_size <= 24; ++block_size) {
+    TestAllTypes message;
+    google::protobuf::io::ArrayInputStream input(
+        json.data(), json.size(), block_size);
+    ASSERT_TRUE(message.ParsePartialFromZeroCopyJsonStream(
+        3, false, false, &input));
+    ASSERT_EQ(5, message.repeated_int32_size());
+    ASSERT_EQ(-2147483647 - 1, message.repeated_int32(0));
+    ASSERT_EQ(0, message.repeated_int32(1));
+    ASSERT_EQ(2147483647, message.repeated_int32(2));
+    ASSERT_EQ(12345678, message.repeated_int32(3));
+    ASSERT_EQ(123456789, message.repeated_int32(4));
+    ASSERT_EQ(0, message.repeated_uint32_size());
+    ASSERT_EQ(18446744073709551615ull, message.repeated_uint64(0));
+    ASSERT_EQ(1234567890123456ull, message.repeated_uint64(1));
+    ASSERT_EQ(-9223372036854775807ll - 1, message.repeated_int64(0));
+    ASSERT_EQ(0, message.repeated_int64(1));
+    ASSERT_EQ(9007199254740993ll, message.repeated_int64_number(0));
+    ASSERT_EQ(-7, message.repeated_int64_number(1));
+  }
+
+  TestAllTypes message;
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString(
+      "{\"31\":[2147483648]}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString(
+      "{\"33\":[1,-1]}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString(
+      "{\"31\":[1,01]}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString(
+      "{\"31\":[1,]}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString(
+      "{\"31\":[1 ,2]}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString(
+      "{\"31\":[1}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString(
+      "{\"32\":[1]}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString(
+      "{\"52\":[\"1\"]}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString(
+      "{\"34\":[\"18446744073709551616\"]}"));
+}
+
+TEST(ObjectKeyTag, InvalidEnumDeserialization) {
+  TestAllTypes message;
+  ASSERT_TRUE(message.ParsePartialFromObjectKeyTagString("{\"21\":2}"));
+  ASSERT_EQ(TestAllTypes_NestedEnum_BAR, message.optional_nested_enum());
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"21\":1}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"49\":[0,1]}"));
+}
+
+// Parses random decimal strings and compares against strtod/strtof.
+TEST(ObjectKeyTag, FloatingPointDeserialization) {
+  std::mt19937_64 random(42);
+  for (int i = 0; i < 200000; ++i) {
+    char number[64];
+    if (i % 2 == 0) {
+      google::protobuf::uint64 bits = random();
+      double value;
+      memcpy(&value, &bits, sizeof(value));
+      if (!isfinite(value)) {
+        continue;
+      }
+      snprintf(number, sizeof(number), "%.*g",
+               static_cast<int>(random() % 17) + 1, value);
+    } else {
+      int size = 0;
+      if (random() % 2) {
+        number[size++] = '-';
+      }
+      const int digits = random() % 25 + 1;
+      const int point = random() % (digits + 1);
+      for (int j = 0; j < digits; ++j) {
+        if (j == point && j > 0) {
+          number[size++] = '.';
+        }
+        number[size++] = '0' + (j == 0 && digits > 1 ? random() % 9 + 1
+                                                     : random() % 10);
+      }
+      snprintf(number + size, sizeof(number) - size, "e%d",
+               static_cast<int>(random() % 700) - 350);
+    }
+
+    TestAllTypes message;
+    const std::string json = std::string("{\"11\":") + number +
+        ",\"12\":" + number + "}";
+    ASSERT_TRUE(message.ParsePartialFromObjectKeyTagString(json)) << json;
+    const double expected_double = strtod(number, NULL);
+    const double actual_double = message.optional_double();
+    const float expected_float = strtof(number, NULL);
+    const float actual_float = message.optional_float();
+    ASSERT_EQ(0, memcmp(&expected_double, &actual_double,
+                        sizeof(expected_double))) << number;
+    ASSERT_EQ(0, memcmp(&expected_float, &actual_float,
+                        sizeof(expected_float))) << number;
+  }
+
+  // Decimals at and just above the midpoint of two floats, which only
+  // round like strtof() when they are converted in single precision.
+  std::vector<std::string> numbers;
+  numbers.push_back("1.000000059604644775390625");
+  numbers.push_back("1.0000000596046447753906250001");
+  numbers.push_back("-1.0000000596046447753906250001");
+  for (int i = 0; i < 2000; ++i) {
+    // A finite float below FLT_MAX and the float after it.
+    const google::protobuf::uint32 below_bits = random() % 0x7F7FFFFF;
+    const google::protobuf::uint32 above_bits = below_bits + 1;
+    float below;
+    float above;
+    memcpy(&below, &below_bits, sizeof(below));
+    memcpy(&above, &above_bits, sizeof(above));
+    // Exact in a double, and printed exactly by 150 digits.
+    const double midpoint = (static_cast<double>(below) + above) / 2;
+    char exact[256];
+    snprintf(exact, sizeof(exact), "%.150e", midpoint);
+    const char *exponent = strchr(exact, 'e');
+    numbers.push_back(exact);
+    numbers.push_back(
+        std::string(exact, exponent - exact) + "1" + exponent);
+  }
+
+  for (size_t i = 0; i < numbers.size(); ++i) {
+    TestAllTypes message;
+    ASSERT_TRUE(message.ParsePartialFromObjectKeyTagString(
+        "{\"11\":" + numbers[i] + "}")) << numbers[i];
+    const float expected = strtof(numbers[i].c_str(), NULL);
+    const float actual = message.optional_float();
+    ASSERT_EQ(0, memcmp(&expected, &actual, sizeof(expected)))
+        << numbers[i];
+  }
+}
+
+TEST(ObjectKeyTag, InvalidFloatingPointDeserialization) {
+  TestAllTypes message;
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"12\":1.}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"12\":.5}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"12\":1e}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"12\":01}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"12\":-}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"12\":\"1\"}"));
+}
+
+TEST(ObjectKeyName, FieldNameLookup) {
+  TestAllTypes message;
+  ASSERT_TRUE(message.ParsePartialFromObjectKeyNameString(
+      "{\"optional_int\\u0033\\u0032\":7,\"repeated_int32\":[8]}"));
+  ASSERT_EQ(7, message.optional_int32());
+  ASSERT_EQ(8, message.repeated_int32(0));
+
+  // Keys that do not name a field are skipped.
+  ASSERT_TRUE(message.ParsePartialFromObjectKeyNameString(
+      "{\"optional_int33\":8}"));
+  ASSERT_TRUE(message.ParsePartialFromObjectKeyNameString(
+      "{\"optional_int32_but_longer_than_any_field\":8}"));
+  ASSERT_TRUE(message.ParsePartialFromObjectKeyNameString(
+      "{\"optional_int\\n32\":8}"));
+  ASSERT_EQ(7, message.optional_int32());
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyNameString("{\"\":7}"));
+}
+
+TEST(ObjectKeyTag, InvalidTagDeserialization) {
+  TestAllTypes message;
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"0\":1}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"01\":1}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"+1\":1}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"1x\":1}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString("{\"\":1}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString(
+      "{\"536870912\":1}"));
+  ASSERT_FALSE(message.ParsePartialFromObjectKeyTagString(
+      "{\"99999999999999999999\":1}"));
+}
+
+TEST(UnknownFields, Deserialization) {
+  const std::string unknown_values =
+      "[1,[\"]\\\"}\"],{\"a\":-1.5e3}],\"x\\\\\",true,false";
+  // Pads the pblite goldens past the last field number, 53.
+  const std::string null_slots =
+      ",null,null,null,null,null,null,null,null,null,";
+
+  TestAllTypes pblite;
+  ASSERT_TRUE(pblite.ParsePartialFromPbLiteString(
+      pblite_golden.substr(0, pblite_golden.size() - 1) + null_slots +
+      unknown_values + "]"));
+  ValidateMessage(pblite);
+
+  TestAllTypes zero_index;
+  ASSERT_TRUE(zero_index.ParsePartialFromPbLiteZeroIndexString(
+      pblite_zero_index_golden.substr(
+          0, pblite_zero_index_golden.size() - 1) + null_slots +
+      unknown_values + "]"));
+  ValidateMessage(zero_index);
+
+  TestAllTypes object_key_name;
+  ASSERT_TRUE(object_key_name.ParsePartialFromObjectKeyNameString(
+      "{\"added_field\":[" + unknown_values + "],\"added_message\":" +
+      object_key_name_golden + "," + object_key_name_golden.substr(1)));
+  ValidateMessage(object_key_name);
+
+  TestAllTypes object_key_tag;
+  ASSERT_TRUE(object_key_tag.ParsePartialFromObjectKeyTagString(
+      "{\"1000\":[" + unknown_values + "],\"1001\":null,\"1002\":-0.5," +
+      object_key_tag_golden.substr(1)));
+  ValidateMessage(object_key_tag);
+
+  TestAllTypes invalid;
+  ASSERT_FALSE(invalid.ParsePartialFromObjectKeyTagString(
+      "{\"1000\":\"x}"));
+  ASSERT_FALSE(invalid.ParsePartialFromObjectKeyTagString(
+      "{\"1000\":[1}}"));
+  ASSERT_FALSE(invalid.ParsePartialFromObjectKeyTagString(
+      "{\"1000\":{\"a\":[1]}"));
+  ASSERT_FALSE(invalid.ParsePartialFromObjectKeyTagString(
+      "{\"1000\":nul}"));
+  ASSERT_FALSE(invalid.ParsePartialFromObjectKeyTagString(
+      "{\"1000\":x}"));
+  ASSERT_FALSE(invalid.ParsePartialFromPbLiteString("[null,1,[2,[3]]"));
+}
+
+// test_pb defines CCJS_STRUCTURAL_INDEX_MIN_SIZE so that these payloads are
+// parsed from a structural index, which must agree with the stream parser.
+void PopulateLargeMessage(TestAllTypes *message) {
+  std::mt19937_64 random(42);
+  for (int i = 0; i < 2000; ++i) {
+    message->add_repeated_int32(static_cast<google::protobuf::int32>(random()));
+    message->add_repeated_int64(static_cast<google::protobuf::int64>(random()));
+    message->add_repeated_uint64(random());
+    message->add_repeated_double(static_cast<double>(i) / 4);
+    message->add_repeated_nested_enum(TestAllTypes_NestedEnum_BAZ);
+    message->add_repeated_int64_number(i);
+    message->add_repeated_string(std::string(i % 70, 'x') + "\"[{,:}]\\");
+    message->add_repeatedgroup()->add_a(i);
+    message->add_repeated_nested_message()->set_b(i);
+  }
+  message->add_repeated_nested_message();
+  message->add_repeatedgroup();
+}
+
+template <typename Message>
+void ExpectIndexMatchesStream(const std::string &json,
+                              const google::protobuf::uint32 type,
+                              const bool booleans_as_numbers,
+                              const bool start_index_one,
+                              Message *indexed) {
+  Message streamed;
+  google::protobuf::io::ArrayInputStream input(json.data(), json.size());
+  const bool stream_result = streamed.ParsePartialFromZeroCopyJsonStream(
+      type, booleans_as_numbers, start_index_one, &input) &&
+      sg::protobuf::ccjs::runtime::AtEndOfInput(&input);
+  bool index_result;
+  if (type == 1 && start_index_one) {
+    index_result = indexed->ParsePartialFromPbLiteZeroIndexString(json);
+  } else if (type == 1) {
+    index_result = indexed->ParsePartialFromPbLiteString(json);
+  } else if (type == 2) {
+    index_result = indexed->ParsePartialFromObjectKeyNameString(json);
+  } else {
+    index_result = indexed->ParsePartialFromObjectKeyTagString(json);
+  }
+  ASSERT_EQ(stream_result, index_result);
+  if (index_result) {
+    ASSERT_EQ(streamed.SerializeAsString(), indexed->SerializeAsString());
+  }
+}
+
+TEST(StructuralIndex, LargeDeserialization) {
+  TestAllTypes message;
+  PopulateMessage(&message);
+  PopulateLargeMessage(&message);
+
+  std::string json[4];
+  ASSERT_TRUE(message.SerializePartialToPbLiteString(&json[0]));
+  ASSERT_TRUE(message.SerializePartialToPbLiteZeroIndexString(&json[1]));
+  ASSERT_TRUE(message.SerializePartialToObjectKeyNameString(&json[2]));
+  ASSERT_TRUE(message.SerializePartialToObjectKeyTagString(&json[3]));
+  const google::protobuf::uint32 types[4] = {1, 1, 2, 3};
+  const bool start_index_one[4] = {false, true, false, false};
+
+  for (int i = 0; i < 4; ++i) {
+    TestAllTypes indexed;
+    ExpectIndexMatchesStream(
+        json[i], types[i], i < 2, start_index_one[i], &indexed);
+    ASSERT_EQ(message.SerializeAsString(), indexed.SerializeAsString());
+
+    // As a NestedMessage every field but optional_int32 is unknown.
+    TestAllTypes::NestedMessage nested;
+    ExpectIndexMatchesStream(
+        json[i], types[i], i < 2, start_index_one[i], &nested);
+    ASSERT_EQ(i == 2 ? 0 : 101, nested.b());
+
+    // Truncated and corrupted payloads get the same result from both.
+    for (size_t size = json[i].size() / 2; size < json[i].size();
+         size += json[i].size() / 7) {
+      TestAllTypes truncated;
+      ExpectIndexMatchesStream(json[i].substr(0, size), types[i], i < 2,
+                               start_index_one[i], &truncated);
+      std::string corrupted = json[i];
+      corrupted[size] = ' ';
+      TestAllTypes space;
+      ExpectIndexMatchesStream(
+          corrupted, types[i], i < 2, start_index_one[i], &space);
+      corrupted[size] = '"';
+      TestAllTypes quote;
+      ExpectIndexMatchesStream(
+          corrupted, types[i], i < 2, start_index_one[i], &quote);
+    }
+  }
+}
+
+// Feeds json to a PushParser in two chunks split at split, or one byte
+// at a time if split is past the end.
+template <typename Message>
+bool Push(const std::string &json,
+          const google::protobuf::uint32 type,
+          const bool booleans_as_numbers,
+          const bool start_index_one,
+          const size_t split,
+          Message *message) {
+  typename Message::PushParser parser(
+      message, type, booleans_as_numbers, start_index_one);
+  if (split > json.size()) {
+    for (size_t i = 0; i < json.size(); ++i) {
+      if (!parser.Feed(json.data() + i, 1)) {
+        return false;
+      }
+    }
+  } else if (!parser.Feed(json.data(), split) ||
+             !parser.Feed(json.data() + split, json.size() - split)) {
+    return false;
+  }
+  return parser.Finish();
+}
+
+// Parses json with the stream parser and the push parser split at split,
+// which ignore input after the message and must agree.
+template <typename Message>
+void ExpectPushAgrees(const std::string &json,
+                      const google::protobuf::uint32 type,
+                      const bool booleans_as_numbers,
+                      const bool start_index_one,
+                      const size_t split) {
+  Message streamed;
+  google::protobuf::io::ArrayInputStream input(json.data(), json.size());
+  const bool stream_result = streamed.ParsePartialFromZeroCopyJsonStream(
+      type, booleans_as_numbers, start_index_one, &input);
+  Message pushed;
+  ASSERT_EQ(stream_result,
+            Push(json, type, booleans_as_numbers, start_index_one, split,
+                 &pushed)) << json << " split at " << split;
+  if (stream_result) {
+    ASSERT_EQ(streamed.SerializeAsString(), pushed.SerializeAsString());
+  }
+}
+
+// Parses json with the Parse*() variant of view for the format.
+template <typename View>
+bool LazyViewParse(const std::string &json,
+                   const google::protobuf::uint32 type,
+                   const bool start_index_one,
+                   View *view) {
+  if (type == 1 && start_index_one) {
+    return view->ParsePartialFromPbLiteZeroIndexArray(
+        json.data(), json.size());
+  } else if (type == 1) {
+    return view->ParsePartialFromPbLiteArray(json.data(), json.size());
+  } else if (type == 2) {
+    return view->ParsePartialFromObjectKeyNameArray(
+        json.data(), json.size());
+  }
+  return view->ParsePartialFromObjectKeyTagArray(json.data(), json.size());
+}
+
+// Parses json as a whole input with every parser, which must all accept
+// or reject it and agree on the message.
+template <typename Message>
+void ExpectParsersAgree(const std::string &json,
+                        const google::protobuf::uint32 type,
+                        const bool booleans_as_numbers,
+                        const bool start_index_one) {
+  ExpectPushAgrees<Message>(
+      json, type, booleans_as_numbers, start_index_one, json.size());
+  ExpectPushAgrees<Message>(
+      json, type, booleans_as_numbers, start_index_one, json.size() / 2);
+
+  Message streamed;
+  google::protobuf::io::ArrayInputStream input(json.data(), json.size());
+  const bool stream_result = streamed.ParsePartialFromZeroCopyJsonStream(
+      type, booleans_as_numbers, start_index_one, &input) &&
+      sg::protobuf::ccjs::runtime::AtEndOfInput(&input);
+
+  Message indexed;
+  ASSERT_EQ(stream_result,
+            sg::protobuf::ccjs::runtime::ParseWithStructuralIndex(
+                &indexed, type, booleans_as_numbers, start_index_one,
+                NULL, json.data(), json.size())) << json;
+  typename Message::LazyView lazy;
+  ASSERT_EQ(stream_result,
+            LazyViewParse(json, type, start_index_one, &lazy) &&
+            lazy.ParseLazyFields()) << json;
+  if (stream_result) {
+    ASSERT_EQ(streamed.SerializeAsString(), indexed.SerializeAsString());
+    ASSERT_EQ(streamed.SerializeAsString(),
+              lazy.message().SerializeAsString());
+  }
+}
+
+// Truncates json, appends to it and replaces, inserts or deletes single
+// chars at every position.
+template <typename Message>
+void ExpectParsersAgreeOnEdits(const std::string &json,
+                               const google::protobuf::uint32 type,
+                               const bool booleans_as_numbers,
+                               const bool start_index_one) {
+  const char edits[] = "nul]t[{},:\"1-.e0fx \\";
+  ExpectParsersAgree<Message>(
+      json, type, booleans_as_numbers, start_index_one);
+  for (size_t i = 0; i <= json.size(); ++i) {
+    ExpectParsersAgree<Message>(json.substr(0, i), type,
+                                booleans_as_numbers, start_index_one);
+    ExpectParsersAgree<Message>(json + json.substr(0, i % 7), type,
+                                booleans_as_numbers, start_index_one);
+    for (const char *c = edits; *c != '\0'; ++c) {
+      std::string inserted = json;
+      inserted.insert(i, 1, *c);
+      ExpectParsersAgree<Message>(inserted, type, booleans_as_numbers,
+                                  start_index_one);
+      if (i < json.size()) {
+        std::string replaced = json;
+        replaced[i] = *c;
+        ExpectParsersAgree<Message>(replaced, type, booleans_as_numbers,
+                                    start_index_one);
+      }
+    }
+    if (i < json.size()) {
+      std::string deleted = json;
+      deleted.erase(i, 1);
+      ExpectParsersAgree<Message>(deleted, type, booleans_as_numbers,
+                                  start_index_one);
+    }
+  }
+}
+
+TEST(StructuralIndex, MatchesStream) {
+  ExpectParsersAgreeOnEdits<TestAllTypes>(pblite_golden, 1, true, false);
+  ExpectParsersAgreeOnEdits<TestAllTypes>(
+      pblite_zero_index_golden, 1, true, true);
+  ExpectParsersAgreeOnEdits<TestAllTypes>(
+      object_key_name_golden, 2, false, false);
+  ExpectParsersAgreeOnEdits<TestAllTypes>(
+      object_key_tag_golden, 3, false, false);
+  ExpectParsersAgreeOnEdits<TestAllTypes>(
+      object_key_tag_escapes_golden, 3, false, false);
+  ExpectParsersAgreeOnEdits<someprotopackage::TestPackageTypes>(
+      pblite_package_golden, 1, true, false);
+  ExpectParsersAgreeOnEdits<TestAllTypes>(
+      "{\"1\":5,\"999\":{\"a\":[1,\"]\\\"\",null]},\"2\":\"7\"}", 3,
+      false, false);
+}
+
+TEST(Lazy, Deserialization) {
+  TestAllTypes::LazyView pblite;
+  ASSERT_TRUE(pblite.ParsePartialFromPbLiteArray(
+      pblite_golden.data(), pblite_golden.size()));
+  ASSERT_EQ(101, pblite.message().optional_int32());
+  ASSERT_FALSE(pblite.message().has_optional_nested_message());
+  ASSERT_EQ(112, pblite.lazy_optional_nested_message()->b());
+  ASSERT_TRUE(pblite.message().has_optional_nested_message());
+  ASSERT_EQ(111, pblite.lazy_optionalgroup()->a());
+  ASSERT_TRUE(pblite.ParseLazyFields());
+  ValidateMessage(pblite.message());
+
+  TestAllTypes::LazyView zero_index;
+  ASSERT_TRUE(zero_index.ParsePartialFromPbLiteZeroIndexArray(
+      pblite_zero_index_golden.data(), pblite_zero_index_golden.size()));
+  ASSERT_TRUE(zero_index.ParseLazyFields());
+  ValidateMessage(zero_index.message());
+
+  TestAllTypes::LazyView object_key_name;
+  ASSERT_TRUE(object_key_name.ParsePartialFromObjectKeyNameArray(
+      object_key_name_golden.data(), object_key_name_golden.size()));
+  ASSERT_TRUE(object_key_name.ParseLazyFields());
+  ValidateMessage(object_key_name.message());
+
+  TestAllTypes::LazyView object_key_tag;
+  ASSERT_TRUE(object_key_tag.ParsePartialFromObjectKeyTagArray(
+      object_key_tag_golden.data(), object_key_tag_golden.size()));
+  ASSERT_TRUE(object_key_tag.ParseLazyFields());
+  ValidateMessage(object_key_tag.message());
+
+  // A skipped field is parsed whole on first access.
+  someprotopackage::TestPackageTypes::LazyView package;
+  ASSERT_TRUE(package.ParsePartialFromObjectKeyTagArray(
+      object_key_tag_package_golden.data(),
+      object_key_tag_package_golden.size()));
+  ASSERT_EQ(1, package.message().optional_int32());
+  ASSERT_FALSE(package.message().has_other_all());
+  ASSERT_EQ(112, package.lazy_other_all()->optional_nested_message().b());
+  ValidateMessage(package.message().other_all());
+
+  // Errors inside a skipped field surface once it is parsed.
+  const std::string invalid_nested = "{\"18\":{\"1\":\"x\"}}";
+  TestAllTypes::LazyView invalid;
+  ASSERT_TRUE(invalid.ParsePartialFromObjectKeyTagArray(
+      invalid_nested.data(), invalid_nested.size()));
+  ASSERT_FALSE(invalid.ParseLazyFields());
+
+  // The accessor reports what the eager parser rejects, on every call.
+  const std::string malformed_nested = "{\"18\":{\"1\":xx},\"1\":3}";
+  TestAllTypes eager;
+  ASSERT_FALSE(eager.ParsePartialFromObjectKeyTagArray(
+      malformed_nested.data(), malformed_nested.size()));
+  TestAllTypes::LazyView malformed;
+  ASSERT_TRUE(malformed.ParsePartialFromObjectKeyTagArray(
+      malformed_nested.data(), malformed_nested.size()));
+  ASSERT_EQ(3, malformed.message().optional_int32());
+  ASSERT_TRUE(malformed.lazy_optional_nested_message() == NULL);
+  ASSERT_TRUE(malformed.lazy_optional_nested_message() == NULL);
+  ASSERT_FALSE(malformed.ParseLazyFields());
+
+  // Parsing again starts over.
+  ASSERT_TRUE(malformed.ParsePartialFromObjectKeyTagArray(
+      object_key_tag_golden.data(), object_key_tag_golden.size()));
+  ASSERT_TRUE(malformed.ParseLazyFields());
+  ValidateMessage(malformed.message());
+}
+
+TEST(Lazy, RepeatedOccurrences) {
+  // Occurrences of a singular message field are merged in input order.
+  const std::string json =
+      "{\"18\":{\"1\":5},\"1\":3,\"18\":{\"1\":6}}";
+  TestAllTypes eager;
+  ASSERT_TRUE(eager.ParsePartialFromObjectKeyTagString(json));
+  TestAllTypes::LazyView lazy;
+  ASSERT_TRUE(lazy.ParsePartialFromObjectKeyTagArray(json.data(),
+                                                     json.size()));
+  ASSERT_EQ(6, lazy.lazy_optional_nested_message()->b());
+  ASSERT_EQ(eager.SerializeAsString(), lazy.message().SerializeAsString());
+
+  // The message of a view is an ordinary message once parsed.
+  const TestAllTypes copied(lazy.message());
+  ASSERT_EQ(eager.SerializeAsString(), copied.SerializeAsString());
+}
+
+TEST(Lazy, LargeDeserialization) {
+  TestAllTypes message;
+  PopulateLargeMessage(&message);
+  std::string json;
+  ASSERT_TRUE(message.SerializePartialToPbLiteString(&json));
+
+  TestAllTypes eager;
+  ASSERT_TRUE(eager.ParsePartialFromPbLiteString(json));
+  TestAllTypes::LazyView lazy;
+  ASSERT_TRUE(lazy.ParsePartialFromPbLiteArray(json.data(), json.size()));
+  ASSERT_TRUE(lazy.ParseLazyFields());
+  ASSERT_EQ(eager.SerializeAsString(), lazy.message().SerializeAsString());
+}
+
+template <typename Message>
+void ExpectPushMatchesStream(const std::string &json,
+                             const google::protobuf::uint32 type,
+                             const bool booleans_as_numbers,
+                             const bool start_index_one) {
+  Message streamed;
+  google::protobuf::io::ArrayInputStream input(json.data(), json.size());
+  ASSERT_TRUE(streamed.ParsePartialFromZeroCopyJsonStream(
+      type, booleans_as_numbers, start_index_one, &input));
+  const std::string expected = streamed.SerializeAsString();
+
+  for (size_t split = 0; split <= json.size(); ++split) {
+    Message pushed;
+    typename Message::PushParser parser(
+        &pushed, type, booleans_as_numbers, start_index_one);
+    ASSERT_TRUE(parser.Feed(json.data(), split));
+    ASSERT_TRUE(parser.Feed(json.data() + split, json.size() - split));
+    ASSERT_TRUE(parser.Finish());
+    ASSERT_EQ(expected, pushed.SerializeAsString());
+  }
+
+  Message pushed;
+  typename Message::PushParser parser(
+      &pushed, type, booleans_as_numbers, start_index_one);
+  for (size_t i = 0; i < json.size(); ++i) {
+    ASSERT_TRUE(parser.Feed(json.data() + i, 1));
+  }
+  ASSERT_TRUE(parser.Finish());
+  ASSERT_EQ(expected, pushed.SerializeAsString());
+}
+
+TEST(PushParser, SplitDeserialization) {
+  ExpectPushMatchesStream<TestAllTypes>(pblite_golden, 1, true, false);
+  ExpectPushMatchesStream<TestAllTypes>(
+      pblite_zero_index_golden, 1, true, true);
+  ExpectPushMatchesStream<TestAllTypes>(
+      large_int_pblite_golden, 1, true, false);
+  ExpectPushMatchesStream<TestAllTypes>(object_key_name_golden, 2, false,
+                                        false);
+  ExpectPushMatchesStream<TestAllTypes>(
+      large_int_object_key_name_golden, 2, false, false);
+  ExpectPushMatchesStream<TestAllTypes>(object_key_tag_golden, 3, false,
+                                        false);
+  ExpectPushMatchesStream<TestAllTypes>(
+      object_key_tag_escapes_golden, 3, false, false);
+  ExpectPushMatchesStream<someprotopackage::TestPackageTypes>(
+      pblite_package_golden, 1, true, false);
+  ExpectPushMatchesStream<someprotopackage::TestPackageTypes>(
+      object_key_tag_package_golden, 3, false, false);
+
+  // Unknown fields are skipped across chunks too.
+  ExpectPushMatchesStream<TestAllTypes>(
+      "{\"1\":5,\"999\":{\"a\":[1,\"]\\\"\",null]},\"2\":\"7\"}", 3,
+      false, false);
+}
+
+TEST(PushParser, MatchesStream) {
+  const std::string json[] = {
+      "[,]",
+      "[1,,2]",
+      "[1 2]",
+      "[null,5,]",
+      "[[[1,2]]]",
+      "[,,,,,,,,,,,,,,,,,,,[1,]]",
+      "{\"1\":5,}",
+      "{,\"1\":5}",
+      "{\"1\" 5}",
+      "{\"1\":5 \"2\":\"7\"}",
+      "{\"18\":{\"1\":xx},\"1\":3}",
+      "{\"31\":[1,2,]}",
+      "{\"31\":[1,,2]}",
+      "{\"1\":\"\\u12g4\"}",
+      "{\"14\":\"\\u00e9\\\"\"}",
+      "{\"1\":5}  x",
+      "{\"1\":5}}",
+      "{\"1\":-}",
+      "{\"1\":1e}",
+      "{\"13\":tru}",
+      "{\"13\":truex}",
+      "{\"999\":[1,{\"a\":]}]}",
+  };
+  for (size_t i = 0; i < sizeof(json) / sizeof(json[0]); ++i) {
+    const google::protobuf::uint32 type = json[i][0] == '[' ? 1 : 3;
+    for (size_t split = 0; split <= json[i].size() + 1; ++split) {
+      ExpectPushAgrees<TestAllTypes>(
+          json[i], type, type == 1, false, split);
+    }
+  }
+
+  // Truncated goldens at every split point.
+  for (size_t size = 0; size < pblite_golden.size(); size += 13) {
+    const std::string truncated = pblite_golden.substr(0, size);
+    for (size_t split = 0; split <= truncated.size() + 1; ++split) {
+      ExpectPushAgrees<TestAllTypes>(truncated, 1, true, false, split);
+    }
+  }
+  for (size_t size = 0; size < object_key_name_golden.size(); size += 13) {
+    const std::string truncated = object_key_name_golden.substr(0, size);
+    for (size_t split = 0; split <= truncated.size() + 1; ++split) {
+      ExpectPushAgrees<TestAllTypes>(truncated, 2, false, false, split);
+    }
+  }
+}
+
+TEST(PushParser, InvalidDeserialization) {
+  TestAllTypes truncated;
+  TestAllTypes::PushParser truncated_parser(&truncated, 3, false, false);
+  ASSERT_TRUE(truncated_parser.Feed(object_key_tag_golden.data(),
+                                    object_key_tag_golden.size() - 1));
+  ASSERT_FALSE(truncated_parser.Finish());
+
+  const std::string invalid = "{\"1\":\"x\"}";
+  TestAllTypes message;
+  TestAllTypes::PushParser parser(&message, 3, false, false);
+  ASSERT_TRUE(parser.Feed(invalid.data(), 5));
+  ASSERT_FALSE(parser.Feed(invalid.data() + 5, invalid.size() - 5));
+  ASSERT_FALSE(parser.Finish());
+}
+
+std::string WriteTempFile(const std::string &name,
+                          const std::string &contents) {
+  const std::string path = testing::TempDir() + name;
+  FILE *file = fopen(path.c_str(), "wb");
+  EXPECT_TRUE(file != NULL);
+  EXPECT_EQ(contents.size(),
+            fwrite(contents.data(), 1, contents.size(), file));
+  fclose(file);
+  return path;
+}
+
+TEST(File, Deserialization) {
+  TestAllTypes pblite;
+  ASSERT_TRUE(pblite.ParsePartialFromPbLiteFile(
+      WriteTempFile("pblite.json", pblite_golden).c_str()));
+  ValidateMessage(pblite);
+
+  TestAllTypes zero_index;
+  ASSERT_TRUE(zero_index.ParsePartialFromPbLiteZeroIndexFile(
+      WriteTempFile("zero_index.json", pblite_zero_index_golden).c_str()));
+  ValidateMessage(zero_index);
+
+  TestAllTypes object_key_name;
+  ASSERT_TRUE(object_key_name.ParsePartialFromObjectKeyNameFile(
+      WriteTempFile("name.json", object_key_name_golden).c_str()));
+  ValidateMessage(object_key_name);
+
+  TestAllTypes object_key_tag;
+  ASSERT_TRUE(object_key_tag.ParsePartialFromObjectKeyTagFile(
+      WriteTempFile("tag.json", object_key_tag_golden).c_str()));
+  ValidateMessage(object_key_tag);
+
+  TestAllTypes large;
+  PopulateLargeMessage(&large);
+  std::string json;
+  ASSERT_TRUE(large.SerializePartialToPbLiteString(&json));
+  TestAllTypes large_file;
+  ASSERT_TRUE(large_file.ParsePartialFromPbLiteFile(
+      WriteTempFile("large.json", json).c_str()));
+  ASSERT_EQ(large.SerializeAsString(), large_file.SerializeAsString());
+
+  TestAllTypes missing;
+  ASSERT_FALSE(missing.ParsePartialFromPbLiteFile(
+      (testing::TempDir() + "missing.json").c_str()));
+  TestAllTypes empty;
+  ASSERT_FALSE(empty.ParsePartialFromPbLiteFile(
+      WriteTempFile("empty.json", "").c_str()));
+  TestAllTypes directory;
+  ASSERT_FALSE(directory.ParsePartialFromPbLiteFile(
+      testing::TempDir().c_str()));
+
+  // A pipe cannot be mapped and is read instead.
+  int fds[2];
+  ASSERT_EQ(0, pipe(fds));
+  ASSERT_EQ(static_cast<ssize_t>(pblite_golden.size()),
+            write(fds[1], pblite_golden.data(), pblite_golden.size()));
+  close(fds[1]);
+  char pipe_path[32];
+  snprintf(pipe_path, sizeof(pipe_path), "/dev/fd/%d", fds[0]);
+  TestAllTypes piped;
+  ASSERT_TRUE(piped.ParsePartialFromPbLiteFile(pipe_path));
+  close(fds[0]);
+  ValidateMessage(piped);
+}
+
+bool CollectMessage(const TestAllTypes &message, void *arg) {
+  std::vector<std::string> *messages =
+      static_cast<std::vector<std::string> *>(arg);
+  messages->push_back(message.SerializeAsString());
+  return message.optional_int32() != 8;
+}
+
+TEST(Delimited, Deserialization) {
+  TestAllTypes expected;
+  ASSERT_TRUE(expected.ParsePartialFromObjectKeyTagString(
+      object_key_tag_golden));
+  const std::string lines = object_key_tag_golden + "\n{\"1\":7}\r\n\n" +
+                            object_key_tag_golden + "\n";
+
+  TestAllTypes message;
+  std::vector<std::string> messages;
+  google::protobuf::io::ArrayInputStream input(lines.data(), lines.size(),
+                                               5);
+  ASSERT_TRUE(message.ParsePartialDelimitedFromZeroCopyJsonStream(
+      3, false, false, &input, &CollectMessage, &messages));
+  ASSERT_EQ(3, messages.size());
+  ASSERT_EQ(expected.SerializeAsString(), messages[0]);
+  TestAllTypes second;
+  second.set_optional_int32(7);
+  ASSERT_EQ(second.SerializeAsString(), messages[1]);
+  ASSERT_EQ(expected.SerializeAsString(), messages[2]);
+
+  // Messages must be separated by line breaks.
+  const std::string same_line = "{\"1\":7}{\"1\":9}";
+  google::protobuf::io::ArrayInputStream same_line_input(
+      same_line.data(), same_line.size());
+  messages.clear();
+  ASSERT_FALSE(message.ParsePartialDelimitedFromZeroCopyJsonStream(
+      3, false, false, &same_line_input, &CollectMessage, &messages));
+  ASSERT_EQ(1, messages.size());
+
+  // Reading stops once the callback returns false.
+  const std::string lines_to_stop = "[null,7]\n[null,8]\n[null,7]\n";
+  google::protobuf::io::ArrayInputStream stop_input(lines_to_stop.data(),
+                                                    lines_to_stop.size());
+  messages.clear();
+  ASSERT_FALSE(message.ParsePartialDelimitedFromZeroCopyJsonStream(
+      1, true, false, &stop_input, &CollectMessage, &messages));
+  ASSERT_EQ(2, messages.size());
+}
+
+TEST(Parallel, Deserialization) {
+  TestAllTypes expected;
+  ASSERT_TRUE(expected.ParsePartialFromObjectKeyTagString(
+      object_key_tag_golden));
+  // Brackets and commas inside strings must not split the array. The
+  // array is large enough to be split into runs for up to 8 threads.
+  const std::string string_element = "{\"14\":\"],\\\"[{\"}";
+  std::string json = "[";
+  int count = 0;
+  for (; json.size() < 8 * CCJS_PARALLEL_ARRAY_MIN_SIZE; ++count) {
+    json += count ? "," : "";
+    json += count % 10 ? object_key_tag_golden : string_element;
+  }
+  json += "]";
+
+  for (int threads = 0; threads <= 8; ++threads) {
+    google::protobuf::RepeatedPtrField<TestAllTypes> messages;
+    messages.Add()->set_optional_int32(1);
+    ASSERT_TRUE(TestAllTypes::ParsePartialFromJsonArrayInParallel(
+        3, false, false, json.data(), json.size(), threads, &messages));
+    ASSERT_EQ(count + 1, messages.size());
+    ASSERT_EQ(1, messages.Get(0).optional_int32());
+    for (int i = 0; i < count; ++i) {
+      if (i % 10) {
+        ASSERT_EQ(expected.SerializeAsString(),
+                  messages.Get(i + 1).SerializeAsString());
+      } else {
+        ASSERT_EQ("],\"[{", messages.Get(i + 1).optional_string());
+      }
+    }
+  }
+
+  google::protobuf::RepeatedPtrField<TestAllTypes> empty;
+  ASSERT_TRUE(TestAllTypes::ParsePartialFromJsonArrayInParallel(
+      1, true, false, "[]", 2, 4, &empty));
+  ASSERT_EQ(0, empty.size());
+
+  // A single invalid element fails the whole array.
+  const std::string invalid = "[{\"1\":1},{\"1\":\"x\"},{\"1\":3}]";
+  google::protobuf::RepeatedPtrField<TestAllTypes> messages;
+  ASSERT_FALSE(TestAllTypes::ParsePartialFromJsonArrayInParallel(
+      3, false, false, invalid.data(), invalid.size(), 3, &messages));
+  ASSERT_EQ(0, messages.size());
+}
+
+TEST(Reparse, SteadyStateAllocations) {
+  // Strings past the small string buffer are reused as well.
+  TestAllTypes long_strings;
+  PopulateMessage(&long_strings);
+  long_strings.set_optional_string(std::string(100, 'x'));
+  long_strings.set_repeated_string(0, std::string(100, 'y'));
+  std::string long_strings_golden;
+  ASSERT_TRUE(long_strings.SerializePartialToObjectKeyTagString(
+      &long_strings_golden));
+
+  const std::string *goldens[] = {
+    &pblite_golden, &object_key_name_golden, &object_key_tag_golden,
+    &long_strings_golden,
+  };
+  for (int i = 0; i < 4; ++i) {
+    const std::string &golden = *goldens[i];
+    TestAllTypes message;
+    int allocations = 0;
+    for (int run = 0; run < 3; ++run) {
+      const int before = allocation_count;
+      bool result;
+      if (i == 0) {
+        result = message.ReparseFromPbLiteString(golden);
+      } else if (i == 1) {
+        result = message.ReparseFromObjectKeyNameString(golden);
+      } else {
+        result = message.ReparseFromObjectKeyTagString(golden);
+      }
+      allocations = allocation_count - before;
+      ASSERT_TRUE(result);
+    }
+    ASSERT_EQ(101, message.optional_int32());
+    ASSERT_EQ(112, message.optional_nested_message().b());
+    ASSERT_EQ(2, message.repeated_string_size());
+    ASSERT_EQ("bar", message.repeated_string(1));
+    ASSERT_EQ(i == 3 ? 100 : 4, message.optional_string().size());
+#ifdef CCJS_STRUCTURAL_INDEX_MIN_SIZE
+    // The structural index is built anew for every parse.
+    if (golden.size() >= CCJS_STRUCTURAL_INDEX_MIN_SIZE) {
+      continue;
+    }
+#endif
+    ASSERT_EQ(0, allocations);
+  }
+}
+
+TEST(Reserve, RepeatedFieldAllocations) {
+  std::string json = "{\"31\":[";
+  for (int i = 0; i < 1000; ++i) {
+    json += (i ? "," : "") + std::string("12345");
+  }
+  json += "],\"48\":[";
+  for (int i = 0; i < 1000; ++i) {
+    json += i ? ",{}" : "{}";
+  }
+  json += "]}";
+
+  TestAllTypes message;
+  const int before = allocation_count;
+  ASSERT_TRUE(message.ParsePartialFromObjectKeyTagString(json));
+  const int allocations = allocation_count - before;
+  ASSERT_EQ(1000, message.repeated_int32_size());
+  ASSERT_EQ(1000, message.repeated_nested_message_size());
+#ifdef CCJS_STRUCTURAL_INDEX_MIN_SIZE
+  // The structural index is built anew for every parse.
+  if (json.size() >= CCJS_STRUCTURAL_INDEX_MIN_SIZE) {
+    return;
+  }
+#endif
+  // Both arrays are grown once, followed by one allocation per message.
+  ASSERT_EQ(1002, allocations);
+}
+
+template <typename Message>
+void ExpectValidateMatchesParse(const std::string &json,
+                                const google::protobuf::uint32 type,
+                                const bool booleans_as_numbers,
+                                const bool start_index_one) {
+  Message message;
+  google::protobuf::io::ArrayInputStream parse_input(json.data(),
+                                                     json.size());
+  google::protobuf::io::ArrayInputStream validate_input(json.data(),
+                                                        json.size());
+  ASSERT_EQ(message.ParsePartialFromZeroCopyJsonStream(
+                type, booleans_as_numbers, start_index_one, &parse_input),
+            Message::ValidateZeroCopyJsonStream(
+                type, booleans_as_numbers, start_index_one,
+                &validate_input)) << json;
+}
+
+TEST(Validate, Deserialization) {
+  ASSERT_TRUE(TestAllTypes::ValidatePbLiteString(pblite_golden));
+  ASSERT_TRUE(TestAllTypes::ValidatePbLiteZeroIndexString(
+      pblite_zero_index_golden));
+  ASSERT_TRUE(TestAllTypes::ValidateObjectKeyNameString(
+      object_key_name_golden));
+  ASSERT_TRUE(TestAllTypes::ValidateObjectKeyTagString(
+      object_key_tag_golden));
+  ASSERT_TRUE(TestAllTypes::ValidateObjectKeyTagString(
+      object_key_tag_escapes_golden));
+  ASSERT_TRUE(someprotopackage::TestPackageTypes::ValidatePbLiteString(
+      pblite_package_golden));
+  ASSERT_FALSE(TestAllTypes::ValidateObjectKeyTagString("{\"1\":\"x\"}"));
+  ASSERT_FALSE(TestAllTypes::ValidateObjectKeyTagString("{\"21\":7}"));
+  ASSERT_FALSE(TestAllTypes::ValidateObjectKeyTagString(
+      "{\"18\":{\"1\":1.5}}"));
+
+  const int before = allocation_count;
+  ASSERT_TRUE(TestAllTypes::ValidateObjectKeyTagString(
+      object_key_tag_golden));
+  ASSERT_EQ(0, allocation_count - before);
+
+  // Validation agrees with parsing on every single-byte corruption.
+  const std::string *goldens[] = {
+    &pblite_golden, &pblite_zero_index_golden, &object_key_name_golden,
+    &object_key_tag_golden,
+  };
+  const char replacements[] = "0-9\"\\[]{},:ntx";
+  for (int i = 0; i < 4; ++i) {
+    const google::protobuf::uint32 type = i < 2 ? 1 : i;
+    for (size_t j = 0; j < goldens[i]->size(); ++j) {
+      ExpectValidateMatchesParse<TestAllTypes>(
+          goldens[i]->substr(0, j), type, i < 2, i == 1);
+      for (size_t k = 0; k + 1 < sizeof(replacements); ++k) {
+        std::string corrupted = *goldens[i];
+        corrupted[j] = replacements[k];
+        ExpectValidateMatchesParse<TestAllTypes>(
+            corrupted, type, i < 2, i == 1);
+      }
+    }
+  }
+}
+
+struct JsonFormat {
+  google::protobuf::uint32 type;
+  bool booleans_as_numbers;
+  bool start_index_one;
+  bool (TestAllTypes::*serialize)(std::string *output) const;
+  bool (TestAllTypes::*parse)(const std::string &input);
+  bool (*from_binary)(const std::string &input, std::string *output);
+  bool (*to_binary)(const std::string &input, std::string *output);
+};
+
+const JsonFormat json_formats[] = {
+  {1, true, false,
+   &TestAllTypes::SerializePartialToPbLiteString,
+   &TestAllTypes::ParsePartialFromPbLiteString,
+   &TestAllTypes::TranscodeBinaryToPbLiteString,
+   &TestAllTypes::TranscodePbLiteStringToBinary},
+  {1, true, true,
+   &TestAllTypes::SerializePartialToPbLiteZeroIndexString,
+   &TestAllTypes::ParsePartialFromPbLiteZeroIndexString,
+   &TestAllTypes::TranscodeBinaryToPbLiteZeroIndexString,
+   &TestAllTypes::TranscodePbLiteZeroIndexStringToBinary},
+  {2, false, false,
+   &TestAllTypes::SerializePartialToObjectKeyNameString,
+   &TestAllTypes::ParsePartialFromObjectKeyNameString,
+   &TestAllTypes::TranscodeBinaryToObjectKeyNameString,
+   &TestAllTypes::TranscodeObjectKeyNameStringToBinary},
+  {3, false, false,
+   &TestAllTypes::SerializePartialToObjectKeyTagString,
+   &TestAllTypes::ParsePartialFromObjectKeyTagString,
+   &TestAllTypes::TranscodeBinaryToObjectKeyTagString,
+   &TestAllTypes::TranscodeObjectKeyTagStringToBinary},
+};
+
+// Expects binary to transcode to the JSON of the message that the
+// protobuf parser reads from it, and the JSON to transcode back to binary
+// for the message that the JSON parser reads from it.
+void ExpectTranscodingMatchesParse(const std::string &binary) {
+  TestAllTypes message;
+  const bool parsed = message.ParsePartialFromString(binary);
+  for (size_t i = 0; i < sizeof(json_formats) / sizeof(JsonFormat); ++i) {
+    const JsonFormat &format = json_formats[i];
+    std::string json;
+    ASSERT_EQ(parsed, format.from_binary(binary, &json));
+    if (!parsed) {
+      continue;
+    }
+    std::string expected;
+    ASSERT_TRUE((message.*format.serialize)(&expected));
+    ASSERT_EQ(expected, json);
+
+    TestAllTypes from_json;
+    ASSERT_TRUE((from_json.*format.parse)(json));
+    std::string transcoded;
+    ASSERT_TRUE(format.to_binary(json, &transcoded));
+    TestAllTypes from_binary;
+    ASSERT_TRUE(from_binary.ParsePartialFromString(transcoded));
+    ASSERT_EQ(from_json.SerializePartialAsString(),
+              from_binary.SerializePartialAsString());
+  }
+}
+
+TEST(Binary, Transcoding) {
+  TestAllTypes message;
+  PopulateMessage(&message);
+  message.set_optional_int32(-101);
+  message.set_optional_sint64(-106);
+  message.set_optional_string(special_char_string);
+  message.add_repeated_bytes(std::string(200, 'x'));
+  const std::string binary = message.SerializePartialAsString();
+  ExpectTranscodingMatchesParse(binary);
+  for (size_t i = 0; i < binary.size(); ++i) {
+    SCOPED_TRACE(i);
+    ExpectTranscodingMatchesParse(binary.substr(0, i));
+  }
+
+  // Repeated fields and singular messages are merged across occurrences.
+  TestAllTypes first;
+  first.mutable_optional_nested_message()->set_b(1);
+  first.mutable_optionalgroup()->set_a(2);
+  first.add_repeated_int32(3);
+  TestAllTypes second;
+  second.mutable_optional_nested_message()->set_c(4);
+  second.add_repeated_int32(5);
+  ExpectTranscodingMatchesParse(first.SerializePartialAsString() +
+                                second.SerializePartialAsString() +
+                                first.SerializePartialAsString());
+
+  // Fields with another wire type than their declaration are rejected.
+  std::string json;
+  ASSERT_FALSE(TestAllTypes::TranscodeBinaryToObjectKeyTagString(
+      std::string("\x0d\x01\x00\x00\x00", 5), &json));
+
+  // The JSON grammar is the parser's.
+  std::string transcoded;
+  ASSERT_FALSE(TestAllTypes::TranscodeObjectKeyTagStringToBinary(
+      "{\"21\":7}", &transcoded));
+  for (size_t i = 0; i < object_key_tag_golden.size(); ++i) {
+    TestAllTypes parsed;
+    transcoded.clear();
+    ASSERT_EQ(parsed.ParsePartialFromObjectKeyTagString(
+                  object_key_tag_golden.substr(0, i)),
+              TestAllTypes::TranscodeObjectKeyTagStringToBinary(
+                  object_key_tag_golden.substr(0, i), &transcoded));
+  }
+}
+
+// Transcodes input from format from to format to.
+bool TranscodeJson(const JsonFormat &from,
+                   const std::string &input,
+                   const JsonFormat &to,
+                   std::string *output) {
+  return TestAllTypes::TranscodeJsonString(
+      from.type, from.booleans_as_numbers, from.start_index_one, input,
+      to.type, to.booleans_as_numbers, to.start_index_one, output);
+}
+
+TEST(Json, Transcoding) {
+  const size_t format_count = sizeof(json_formats) / sizeof(JsonFormat);
+  TestAllTypes message;
+  PopulateMessage(&message);
+  message.set_optional_int32(-101);
+  message.set_optional_string(special_char_string);
+  for (size_t i = 0; i < format_count; ++i) {
+    std::string input;
+    ASSERT_TRUE((message.*json_formats[i].serialize)(&input));
+    for (size_t j = 0; j < format_count; ++j) {
+      SCOPED_TRACE(i * format_count + j);
+      std::string expected;
+      ASSERT_TRUE((message.*json_formats[j].serialize)(&expected));
+      std::string json;
+      ASSERT_TRUE(TranscodeJson(json_formats[i], input, json_formats[j],
+                                &json));
+      ASSERT_EQ(expected, json);
+
+      // Values are recorded across the buffers of the input.
+      google::protobuf::io::ArrayInputStream chunked(
+          input.data(), input.size(), 3);
+      json.clear();
+      google::protobuf::io::StringOutputStream output(&json);
+      ASSERT_TRUE(TestAllTypes::TranscodeZeroCopyJsonStream(
+          json_formats[i].type, json_formats[i].booleans_as_numbers,
+          json_formats[i].start_index_one, &chunked,
+          json_formats[j].type, json_formats[j].booleans_as_numbers,
+          json_formats[j].start_index_one, &output));
+      ASSERT_EQ(expected, json);
+    }
+  }
+
+  // Numbers and strings are copied as written, fields are written in
+  // declaration order and unknown fields are dropped.
+  std::string json;
+  ASSERT_TRUE(TranscodeJson(
+      json_formats[2],
+      "{\"repeated_int32\":[1,2],\"unknown\":[{}],"
+      "\"optional_string\":\"\\u0041\",\"optional_double\":1.50,"
+      "\"repeated_int32\":[],\"repeated_int32\":[3],"
+      "\"optional_bool\":true,\"optional_nested_message\":{\"b\":7}}",
+      json_formats[3],
+      &json));
+  EXPECT_EQ("{\"12\":1.50,\"13\":true,\"14\":\"\\u0041\",\"18\":{\"1\":7},"
+            "\"31\":[1,2,3]}",
+            json);
+
+  // A singular message is not merged across occurrences.
+  json.clear();
+  ASSERT_FALSE(TranscodeJson(
+      json_formats[3], "{\"18\":{},\"18\":{}}", json_formats[2], &json));
+
+  // The grammar is the parser's.
+  for (size_t i = 0; i < object_key_tag_golden.size(); ++i) {
+    TestAllTypes parsed;
+    json.clear();
+    ASSERT_EQ(parsed.ParsePartialFromObjectKeyTagString(
+                  object_key_tag_golden.substr(0, i)),
+              TranscodeJson(json_formats[3],
+                            object_key_tag_golden.substr(0, i),
+                            json_formats[0],
+                            &json));
+  }
+}
+
+// Expects the table-driven CodeSizeTestAllTypes to accept json exactly
+// when TestAllTypes does, and to read the same message from it.
+void ExpectCodeSizeMatchesUnrolled(const std::string &json,
+                                   const google::protobuf::uint32 type,
+                                   const bool booleans_as_numbers,
+                                   const bool start_index_one) {
+  TestAllTypes unrolled;
+  google::protobuf::io::ArrayInputStream unrolled_input(
+      json.data(), json.size());
+  const bool parsed = unrolled.ParsePartialFromZeroCopyJsonStream(
+      type, booleans_as_numbers, start_index_one, &unrolled_input);
+
+  CodeSizeTestAllTypes compact;
+  google::protobuf::io::ArrayInputStream compact_input(
+      json.data(), json.size(), 5);
+  ASSERT_EQ(parsed, compact.ParsePartialFromZeroCopyJsonStream(
+      type, booleans_as_numbers, start_index_one, &compact_input));
+  google::protobuf::io::ArrayInputStream validate_input(
+      json.data(), json.size());
+  ASSERT_EQ(parsed, CodeSizeTestAllTypes::ValidateZeroCopyJsonStream(
+      type, booleans_as_numbers, start_index_one, &validate_input));
+  google::protobuf::io::ArrayInputStream transcode_input(
+      json.data(), json.size());
+  std::string binary;
+  ASSERT_EQ(parsed, CodeSizeTestAllTypes::TranscodeZeroCopyJsonStreamToBinary(
+      type, booleans_as_numbers, start_index_one, &transcode_input,
+      &binary));
+  if (!parsed) {
+    return;
+  }
+  ASSERT_EQ(unrolled.SerializePartialAsString(),
+            compact.SerializePartialAsString());
+  ASSERT_EQ(compact.SerializePartialAsString(), binary);
+  ExpectPushMatchesStream<CodeSizeTestAllTypes>(
+      json, type, booleans_as_numbers, start_index_one);
+}
+
+TEST(CodeSize, MatchesUnrolled) {
+  TestAllTypes unrolled;
+  PopulateMessage(&unrolled);
+  unrolled.set_optional_int32(-101);
+  unrolled.set_optional_string(special_char_string);
+  unrolled.add_repeated_uint64(18446744073709551615ULL);
+  unrolled.add_repeated_double(0.25);
+  unrolled.add_repeatedgroup()->add_a(3);
+  unrolled.add_repeated_nested_message()->set_c(4);
+  unrolled.add_repeated_nested_enum(TestAllTypes_NestedEnum_BAZ);
+  unrolled.add_repeated_int64_number(5);
+  CodeSizeTestAllTypes compact;
+  ASSERT_TRUE(compact.ParseFromString(unrolled.SerializeAsString()));
+
+  std::string expected[4];
+  std::string json[4];
+  ASSERT_TRUE(unrolled.SerializePartialToPbLiteString(&expected[0]));
+  ASSERT_TRUE(compact.SerializePartialToPbLiteString(&json[0]));
+  ASSERT_TRUE(unrolled.SerializePartialToPbLiteZeroIndexString(&expected[1]));
+  ASSERT_TRUE(compact.SerializePartialToPbLiteZeroIndexString(&json[1]));
+  ASSERT_TRUE(unrolled.SerializePartialToObjectKeyNameString(&expected[2]));
+  ASSERT_TRUE(compact.SerializePartialToObjectKeyNameString(&json[2]));
+  ASSERT_TRUE(unrolled.SerializePartialToObjectKeyTagString(&expected[3]));
+  ASSERT_TRUE(compact.SerializePartialToObjectKeyTagString(&json[3]));
+  const google::protobuf::uint32 types[4] = {1, 1, 2, 3};
+  const bool start_index_one[4] = {false, true, false, false};
+  for (int i = 0; i < 4; ++i) {
+    SCOPED_TRACE(i);
+    ASSERT_EQ(expected[i], json[i]);
+    CodeSizeTestAllTypes parsed;
+    google::protobuf::io::ArrayInputStream input(
+        json[i].data(), json[i].size());
+    ASSERT_TRUE(parsed.ParsePartialFromZeroCopyJsonStream(
+        types[i], i < 2, start_index_one[i], &input));
+    ASSERT_EQ(compact.SerializePartialAsString(),
+              parsed.SerializePartialAsString());
+    for (size_t size = 0; size <= json[i].size(); ++size) {
+      ExpectCodeSizeMatchesUnrolled(json[i].substr(0, size), types[i],
+                                    i < 2, start_index_one[i]);
+    }
+
+    std::string transcoded;
+    {
+      google::protobuf::io::StringOutputStream output(&transcoded);
+      const std::string binary = compact.SerializePartialAsString();
+      ASSERT_TRUE(CodeSizeTestAllTypes::TranscodeBinaryToZeroCopyJsonStream(
+          types[i], i < 2, start_index_one[i], binary.data(), binary.size(),
+          &output));
+    }
+    ASSERT_EQ(expected[i], transcoded);
+  }
+  std::string transcoded;
+  ASSERT_TRUE(CodeSizeTestAllTypes::TranscodeBinaryToPbLiteString(
+      compact.SerializePartialAsString(), &transcoded));
+  ASSERT_EQ(expected[0], transcoded);
+  transcoded.clear();
+  ASSERT_TRUE(CodeSizeTestAllTypes::TranscodeJsonString(
+      1, true, false, json[0], 2, false, false, &transcoded));
+  ASSERT_EQ(expected[2], transcoded);
+
+  // The grammar is the unrolled parser's, down to its rejections.
+  ExpectCodeSizeMatchesUnrolled(object_key_tag_golden, 3, false, false);
+  ExpectCodeSizeMatchesUnrolled(object_key_name_golden, 2, false, false);
+  ExpectCodeSizeMatchesUnrolled(pblite_golden, 1, true, false);
+  ExpectCodeSizeMatchesUnrolled("{\"21\":1}", 3, false, false);
+  ExpectCodeSizeMatchesUnrolled("{\"49\":[0,1]}", 3, false, false);
+  ExpectCodeSizeMatchesUnrolled("{\"1\":2147483648}", 3, false, false);
+  ExpectCodeSizeMatchesUnrolled("{\"2\":1}", 3, false, false);
+  ExpectCodeSizeMatchesUnrolled("{\"50\":\"1\"}", 3, false, false);
+  ExpectCodeSizeMatchesUnrolled("{\"13\":1}", 3, false, false);
+  ExpectCodeSizeMatchesUnrolled("{\"43\":[true,false]}", 3, false, false);
+  ExpectCodeSizeMatchesUnrolled("[null,1,[],[1,0]]", 1, true, true);
+  ExpectCodeSizeMatchesUnrolled("{\"18\":{},\"18\":{\"1\":2}}", 3, false,
+                                false);
+  ExpectCodeSizeMatchesUnrolled(
+      "{\"1\":5,\"999\":{\"a\":[1,\"]\\\"\",null]},\"2\":\"7\"}", 3, false,
+      false);
+  ExpectCodeSizeMatchesUnrolled("{\"optional_int32\":1,\"bogus\":2}", 2,
+                                false, false);
+  std::string binary_json;
+  ASSERT_FALSE(CodeSizeTestAllTypes::TranscodeBinaryToObjectKeyTagString(
+      std::string("\x0d\x01\x00\x00\x00", 5), &binary_json));
+}
+
+TEST(CodeSize, LargeDeserialization) {
+  TestAllTypes unrolled;
+  PopulateMessage(&unrolled);
+  PopulateLargeMessage(&unrolled);
+  CodeSizeTestAllTypes compact;
+  ASSERT_TRUE(compact.ParseFromString(unrolled.SerializeAsString()));
+
+  std::string json;
+  ASSERT_TRUE(compact.SerializePartialToObjectKeyNameString(&json));
+  std::string expected;
+  ASSERT_TRUE(unrolled.SerializePartialToObjectKeyNameString(&expected));
+  ASSERT_EQ(expected, json);
+
+  // Goes through the structural index above its minimum size.
+  CodeSizeTestAllTypes indexed;
+  ExpectIndexMatchesStream(json, 2, false, false, &indexed);
+  ASSERT_EQ(unrolled.SerializeAsString(), indexed.SerializeAsString());
+  // The compact parser records nothing, so the view parses eagerly.
+  CodeSizeTestAllTypes::LazyView lazy;
+  ASSERT_TRUE(lazy.ParsePartialFromObjectKeyNameArray(
+      json.data(), json.size()));
+  ASSERT_EQ(112, lazy.lazy_optional_nested_message()->b());
+  ASSERT_TRUE(lazy.ParseLazyFields());
+  ASSERT_EQ(unrolled.SerializeAsString(), lazy.message().SerializeAsString());
+}
+
 const char *usage = "ccjs_test\n";
 
 int main(int argc, char **argv) {
@@ -56,13 +56,22 @@
 
 #include "ccjs/code_generator.h"
 
+#include <ctype.h>
 #include <stdio.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "google/protobuf/descriptor.h"
+#include "google/protobuf/descriptor.pb.h"
 #include "google/protobuf/io/printer.h"
 #include "google/protobuf/io/zero_copy_stream.h"
 
+#include "js/generate_all.h"
 #include "js/int64_encoding.pb.h"
 
 namespace sg {
@@ -81,731 +90,463 @@ std::string ReplaceAll(
   return rtn;
 }
 
+// Collects the singular message fields of message, which lazy parsing
+// records instead of parsing.
+void LazyFields(
+    const google::protobuf::Descriptor *message,
+    std::vector<const google::protobuf::FieldDescriptor *> *fields) {
+  for (int i = 0; i < message->field_count(); ++i) {
+    const google::protobuf::FieldDescriptor *field = message->field(i);
+    if (field->label() !=
+            google::protobuf::FieldDescriptor::LABEL_REPEATED &&
+        (field->type() == google::protobuf::FieldDescriptor::TYPE_GROUP ||
+         field->type() == google::protobuf::FieldDescriptor::TYPE_MESSAGE)) {
+      fields->push_back(field);
+    }
+  }
+}
+
+// Whether message has a singular or repeated message field, which the
+// parsers hand their nested state to.
+bool HasMessageField(const google::protobuf::Descriptor *message) {
+  for (int i = 0; i < message->field_count(); ++i) {
+    if (message->field(i)->type() ==
+            google::protobuf::FieldDescriptor::TYPE_GROUP ||
+        message->field(i)->type() ==
+            google::protobuf::FieldDescriptor::TYPE_MESSAGE) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Formats the fully qualified C++ class name of a message type.
+std::string ClassName(const google::protobuf::Descriptor *message) {
+  return "::" + ReplaceAll(".", "::", message->full_name());
+}
+
+// Selects the C++ type, Read<reader>() scanner and quoting of the JSON
+// value of a numeric or enum field. 64-bit integers are quoted unless
+// the field is annotated with jstype.
+void NumberReader(const google::protobuf::FieldDescriptor *field,
+                  std::string *type,
+                  std::string *reader,
+                  std::string *quoted,
+                  std::string *enum_type) {
+  *type = "google::protobuf::int64";
+  *reader = "Int64";
+  *quoted = "true";
+  *enum_type = "";
+  if (field->options().GetExtension(jstype)) {
+    *quoted = "false";
+  }
+  if (field->type() == google::protobuf::FieldDescriptor::TYPE_DOUBLE) {
+    *type = "double";
+    *reader = "Double";
+    *quoted = "false";
+  } else if (
+      field->type() == google::protobuf::FieldDescriptor::TYPE_FLOAT) {
+    *type = "float";
+    *reader = "Float";
+    *quoted = "false";
+  } else if (
+      field->type() == google::protobuf::FieldDescriptor::TYPE_UINT64 ||
+      field->type() == google::protobuf::FieldDescriptor::TYPE_FIXED64) {
+    *type = "google::protobuf::uint64";
+    *reader = "UInt64";
+  } else if (
+      field->type() == google::protobuf::FieldDescriptor::TYPE_INT32 ||
+      field->type() == google::protobuf::FieldDescriptor::TYPE_SINT32 ||
+      field->type() == google::protobuf::FieldDescriptor::TYPE_SFIXED32) {
+    *type = "google::protobuf::int32";
+    *reader = "Int32";
+    *quoted = "false";
+  } else if (
+      field->type() == google::protobuf::FieldDescriptor::TYPE_UINT32 ||
+      field->type() == google::protobuf::FieldDescriptor::TYPE_FIXED32) {
+    *type = "google::protobuf::uint32";
+    *reader = "UInt32";
+    *quoted = "false";
+  } else if (
+      field->type() == google::protobuf::FieldDescriptor::TYPE_ENUM) {
+    *enum_type = ReplaceAll(".", "::", field->enum_type()->full_name());
+    *type = "google::protobuf::int32";
+    *reader = "Int32";
+    *quoted = "false";
+  }
+}
+
+// Emits the Read<reader> call for a numeric field followed by
+// <setter>(value), eg: this->set_<field>, or only the checks for an
+// empty setter. Enum values are range checked against the generated
+// <enum>_IsValid() before they are stored.
+void PrintReadNumber(
+    const std::string &reader,
+    const std::string &quoted,
+    const std::string &enum_type,
+    const std::string &setter,
+    google::protobuf::io::Printer *printer) {
+  printer->Print(
+      "if (!Read$reader$($quoted$, &value, input)) {\n"
+      "  RTN_FALSE;\n"
+      "}\n",
+      "reader", reader,
+      "quoted", quoted);
+  if (!enum_type.empty()) {
+    printer->Print(
+        "if (!$enum_type$_IsValid(value)) {\n"
+        "  RTN_FALSE;\n"
+        "}\n",
+        "enum_type", enum_type);
+  }
+  if (setter.empty()) {
+    return;
+  } else if (enum_type.empty()) {
+    printer->Print("$setter$(value);\n", "setter", setter);
+  } else {
+    printer->Print(
+        "$setter$(static_cast<$enum_type$> (value));\n",
+        "enum_type", enum_type,
+        "setter", setter);
+  }
+}
+
+// Formats the binary wire format tag of field number with wire_type.
+bool WireTag(const int number, const int wire_type, std::string *tag) {
+  char tag_str[13];  // ceiling(32/3) + sign char + NULL
+  if (snprintf(tag_str,
+               sizeof(tag_str),
+               "%u",
+               static_cast<unsigned int>(number) << 3 | wire_type) >= 13) {
+    return false;
+  }
+  *tag = tag_str;
+  return true;
+}
+
+// Selects the runtime WireEncoding and wire type of the values of a
+// numeric, enum or bool field.
+void WireEncoding(const google::protobuf::FieldDescriptor *field,
+                  std::string *encoding,
+                  int *wire_type) {
+  *encoding = "WIRE_VARINT";
+  *wire_type = 0;
+  switch (field->type()) {
+    case google::protobuf::FieldDescriptor::TYPE_SINT32:
+    case google::protobuf::FieldDescriptor::TYPE_SINT64:
+      *encoding = "WIRE_ZIGZAG";
+      break;
+    case google::protobuf::FieldDescriptor::TYPE_FIXED32:
+    case google::protobuf::FieldDescriptor::TYPE_SFIXED32:
+    case google::protobuf::FieldDescriptor::TYPE_FLOAT:
+      *encoding = "WIRE_FIXED32";
+      *wire_type = 5;
+      break;
+    case google::protobuf::FieldDescriptor::TYPE_FIXED64:
+    case google::protobuf::FieldDescriptor::TYPE_SFIXED64:
+    case google::protobuf::FieldDescriptor::TYPE_DOUBLE:
+      *encoding = "WIRE_FIXED64";
+      *wire_type = 1;
+      break;
+    default:
+      break;
+  }
+}
+
+// Emits the ReadString() of one string value into target or, for a
+// non-empty tag, its transcoding to a length-delimited field of output.
+void PrintReadString(const std::string &target,
+                     const std::string &tag,
+                     google::protobuf::io::Printer *printer) {
+  if (tag.empty()) {
+    printer->Print(
+        "if (!ReadString($target$, input)) {\n"
+        "  RTN_FALSE;\n"
+        "}\n",
+        "target", target);
+    return;
+  }
+  printer->Print(
+      "AppendVarint($tag$, output);\n"
+      "const size_t begin = BeginLengthDelimited(output);\n"
+      "if (!ReadString(output, input)) {\n"
+      "  RTN_FALSE;\n"
+      "}\n"
+      "EndLengthDelimited(begin, output);\n",
+      "tag", tag);
+}
+
+// Emits the call of parse for one nested message value. When
+// transcoding (for a non-empty tag) the value is written between tag and
+// end_tag for a group, or else as a length-delimited field.
+void PrintReadMessage(const std::string &parse,
+                      const std::string &tag,
+                      const std::string &end_tag,
+                      google::protobuf::io::Printer *printer) {
+  if (!tag.empty()) {
+    printer->Print("AppendVarint($tag$, output);\n", "tag", tag);
+    if (end_tag.empty()) {
+      printer->Print("const size_t begin = BeginLengthDelimited(output);\n");
+    }
+  }
+  printer->Print(
+      "if (!$parse$(type, "  // no newline
+      "booleans_as_numbers, start_index_one, input$output$)) {\n"
+      "  RTN_FALSE;\n"
+      "}\n",
+      "parse", parse,
+      "output", tag.empty() ? "" : ", output");
+  if (!end_tag.empty()) {
+    printer->Print("AppendVarint($tag$, output);\n", "tag", end_tag);
+  } else if (!tag.empty()) {
+    printer->Print("EndLengthDelimited(begin, output);\n");
+  }
+}
+
+// Selects the snprintf() format of the JSON value of a numeric or enum
+// field and the size of its buffer. 64-bit integers are quoted unless
+// the field is annotated with jstype.
+void NumberWriter(const google::protobuf::FieldDescriptor *field,
+                  std::string *format,
+                  std::string *buffer_size) {
+  *format = "\\\"%ld\\\"";
+  // ceiling(64/3) + sign char + 2 quotes + NULL;
+  *buffer_size = "26";
+  if (field->options().GetExtension(jstype)) {
+    *format = "%ld";
+    // ceiling(64/3) + sign char + NULL;
+    *buffer_size = "24";
+  }
+  if (field->type() == google::protobuf::FieldDescriptor::TYPE_DOUBLE ||
+      field->type() == google::protobuf::FieldDescriptor::TYPE_FLOAT) {
+    *format = "%g";
+  } else if (
+      field->type() == google::protobuf::FieldDescriptor::TYPE_UINT64 ||
+      field->type() == google::protobuf::FieldDescriptor::TYPE_FIXED64) {
+    if (field->options().GetExtension(jstype)) {
+      *format = "%lu";
+      *buffer_size = "23";  // ceiling(64/3) + NULL
+    } else {
+      *format = "\\\"%lu\\\"";
+      *buffer_size = "25";  // ceiling(64/3) + 2 quotes + NULL
+    }
+  } else if (
+      field->type() == google::protobuf::FieldDescriptor::TYPE_INT32 ||
+      field->type() == google::protobuf::FieldDescriptor::TYPE_SINT32 ||
+      field->type() == google::protobuf::FieldDescriptor::TYPE_SFIXED32 ||
+      field->type() == google::protobuf::FieldDescriptor::TYPE_ENUM) {
+    *format = "%d";
+    *buffer_size = "13";  // ceiling(32/3) + sign char + NULL
+  } else if (
+      field->type() == google::protobuf::FieldDescriptor::TYPE_UINT32 ||
+      field->type() == google::protobuf::FieldDescriptor::TYPE_FIXED32) {
+    *format = "%u";
+    *buffer_size = "12";  // ceiling(32/3) + NULL
+  }
+}
+
+// Emits the writing of the key of field: the null entries up to its slot
+// for PB_LITE, or else its name or number. The type, start_index_one and
+// cur_field_num of the writer are named with prefix.
+bool PrintWriteFieldKey(const google::protobuf::Descriptor *message,
+                        const google::protobuf::FieldDescriptor *field,
+                        const std::string &prefix,
+                        google::protobuf::io::Printer *printer) {
+  std::string rep_field_set =
+      "std::set<google::protobuf::uint32> rep_field_set;";
+  for (int j = 0; j < message->field_count(); ++j) {
+    if (message->field(j)->label() ==
+        google::protobuf::FieldDescriptor::LABEL_REPEATED) {
+      char field_number[13];  // ceiling(32/3) + sign char + NULL
+      if (snprintf(field_number,
+                   sizeof(field_number),
+                   "%d",
+                   message->field(j)->number()) >= 13) {
+        return false;
+      }
+      rep_field_set += ("rep_field_set.insert(" +
+                        std::string(field_number) +
+                        ");");
+    }
+  }
+
+  char field_number[13];  // ceiling(32/3) + sign char + NULL
+  if (snprintf(
+          field_number, sizeof(field_number), "%d", field->number()) >= 13) {
+    return false;
+  }
+  printer->Print(
+      "if ($prefix$type == PB_LITE) {\n"
+      "  $rep_field_set$\n"
+      "  if (!WritePbLiteNullEntries(\n"
+      "      $field_num$, rep_field_set, $prefix$start_index_one,\n"
+      "      &$prefix$cur_field_num, output)) {\n"
+      "    RTN_FALSE;\n"
+      "  }\n"
+      "} else {\n"
+      "  if ($prefix$type == OBJECT_KEY_TAG) {\n"
+      "    if (!WriteObjectKey(\"$field_num$\", prev_fields, output)) {\n"
+      "      RTN_FALSE;\n"
+      "    }\n"
+      "  } else if ($prefix$type == OBJECT_KEY_NAME) {\n"
+      "    if (!WriteObjectKey(\"$field_name$\", prev_fields, output)) {\n"
+      "      RTN_FALSE;\n"
+      "    }\n"
+      "  } else {\n"
+      "    RTN_FALSE;\n"
+      "  }\n"
+      "  prev_fields = true;\n"
+      "}\n",
+      "prefix", prefix,
+      "rep_field_set", rep_field_set,
+      "field_num", field_number,
+      "field_name", field->name());
+  return true;
+}
+
+// Emits a switch on the character position that best splits fields (all
+// with names of equal length) and recurses until one candidate is left,
+// which is then verified with memcmp. Field names are identifiers so
+// they can be printed as character literals as is.
+bool PrintFieldNameSwitch(
+    const std::vector<const google::protobuf::FieldDescriptor *> &fields,
+    google::protobuf::io::Printer *printer) {
+  if (fields.size() == 1) {
+    char length[13];  // ceiling(32/3) + sign char + NULL
+    char number[13];  // ceiling(32/3) + sign char + NULL
+    if (snprintf(length,
+                 sizeof(length),
+                 "%d",
+                 static_cast<int>(fields[0]->name().length())) >= 13 ||
+        snprintf(number, sizeof(number), "%d", fields[0]->number()) >= 13) {
+      return false;
+    }
+    printer->Print(
+        "if (memcmp(field_name, \"$name$\", $length$) == 0) {\n"
+        "  cur_field_num = $number$;\n"
+        "}\n",
+        "name", fields[0]->name(),
+        "length", length,
+        "number", number);
+    return true;
+  }
+
+  size_t position = 0;
+  size_t position_chars = 0;
+  for (size_t i = 0; i < fields[0]->name().length(); ++i) {
+    std::set<char> chars;
+    for (size_t j = 0; j < fields.size(); ++j) {
+      chars.insert(fields[j]->name()[i]);
+    }
+    if (chars.size() > position_chars) {
+      position = i;
+      position_chars = chars.size();
+    }
+  }
+  std::map<char, std::vector<const google::protobuf::FieldDescriptor *> >
+      partition;
+  for (size_t j = 0; j < fields.size(); ++j) {
+    partition[fields[j]->name()[position]].push_back(fields[j]);
+  }
+
+  char position_str[13];  // ceiling(32/3) + sign char + NULL
+  if (snprintf(position_str,
+               sizeof(position_str),
+               "%d",
+               static_cast<int>(position)) >= 13) {
+    return false;
+  }
+  printer->Print("switch (field_name[$position$]) {\n",
+                 "position", position_str);
+  printer->Indent();
+  for (std::map<char, std::vector<
+           const google::protobuf::FieldDescriptor *> >::const_iterator it =
+           partition.begin();
+       it != partition.end();
+       ++it) {
+    printer->Print("case '$char$':\n", "char", std::string(1, it->first));
+    printer->Indent();
+    if (!PrintFieldNameSwitch(it->second, printer)) {
+      return false;
+    }
+    printer->Print("break;\n");
+    printer->Outdent();
+  }
+  printer->Outdent();
+  printer->Print("}\n");
+  return true;
+}
+
+// Formats the length of the longest field name of message (at least 1)
+// for sizing key buffers.
+bool MaxFieldNameLength(const google::protobuf::Descriptor *message,
+                        std::string *max_length) {
+  size_t length = 1;
+  for (int i = 0; i < message->field_count(); ++i) {
+    length = std::max(length, message->field(i)->name().length());
+  }
+  char length_str[13];  // ceiling(32/3) + sign char + NULL
+  if (snprintf(length_str,
+               sizeof(length_str),
+               "%d",
+               static_cast<int>(length)) >= 13) {
+    return false;
+  }
+  *max_length = length_str;
+  return true;
+}
+
+// Emits the lookup of cur_field_num from field_name and field_name_size,
+// switching on the length first. Unknown names leave cur_field_num at 0
+// and an empty name marks the end of the object with -1.
+bool PrintFieldNameLookup(const google::protobuf::Descriptor *message,
+                          google::protobuf::io::Printer *printer) {
+  std::map<int, std::vector<const google::protobuf::FieldDescriptor *> >
+      fields_by_length;
+  for (int i = 0; i < message->field_count(); ++i) {
+    const google::protobuf::FieldDescriptor *field = message->field(i);
+    fields_by_length[field->name().length()].push_back(field);
+  }
+  printer->Print(
+      "cur_field_num = 0;\n"
+      "switch (field_name_size) {\n"
+      "  case 0:\n"
+      "    cur_field_num = -1;\n"
+      "    break;\n");
+  printer->Indent();
+  for (std::map<int, std::vector<
+           const google::protobuf::FieldDescriptor *> >::const_iterator it =
+           fields_by_length.begin();
+       it != fields_by_length.end();
+       ++it) {
+    char length[13];  // ceiling(32/3) + sign char + NULL
+    if (snprintf(length, sizeof(length), "%d", it->first) >= 13) {
+      return false;
+    }
+    printer->Print("case $length$:\n", "length", length);
+    printer->Indent();
+    if (!PrintFieldNameSwitch(it->second, printer)) {
+      return false;
+    }
+    printer->Print("break;\n");
+    printer->Outdent();
+  }
+  printer->Outdent();
+  printer->Print(
+      "}\n"
+      "\n");
+  return true;
+}
+
+// The JSON runtime the generated code calls into, see ccjs_runtime.h.
 const std::string cc_header_boilerplate =
-    // "#include <iostream>\n"
-    "#include <set>\n"
-    "#include <stdio.h>\n"
+    "#include \"ccjs/ccjs_runtime.h\"\n"
     "\n"
-    "#include <google/protobuf/io/zero_copy_stream.h>\n"
-    "#include <google/protobuf/io/zero_copy_stream_impl_lite.h>\n"
-    "#include <google/protobuf/stubs/common.h>\n"
-    "\n"
-    "namespace {\n"
-    "\n"
-    "#define PB_LITE 1\n"
-    "#define OBJECT_KEY_NAME 2\n"
-    "#define OBJECT_KEY_TAG 3\n"
-    "\n"
-    // "#define RTN_FALSE std::cout << __FILE__ << \":\"\\\n"
-    // "                            << __LINE__ << std::endl; exit(1)\n"
+    "#ifndef RTN_FALSE\n"
     "#define RTN_FALSE return false\n"
+    "#endif\n"
     "\n"
-    "bool WriteRaw(const std::string &value,\n"
-    "              google::protobuf::io::ZeroCopyOutputStream *output) {\n"
-    "  int bytes_remaining = value.length();\n"
-    "  while (bytes_remaining) {\n"
-    "    void *buffer;\n"
-    "    int size;\n"
-    "    if (!output->Next(&buffer, &size)) {\n"
-    "      RTN_FALSE;\n"
-    "    }\n"
-    "    const char *value_ptr = value.data() + (\n"
-    "        value.length() - bytes_remaining);\n"
-    "    if (size >= bytes_remaining) {\n"
-    "      memcpy(buffer, value_ptr, bytes_remaining);\n"
-    "      int bytes_to_return = size - bytes_remaining;\n"
-    "      if (bytes_to_return) {\n"
-    "        output->BackUp(bytes_to_return);\n"
-    "      }\n"
-    "      bytes_remaining = 0;\n"
-    "    } else if (size > 0) {\n"
-    "      memcpy(buffer, value_ptr, size);\n"
-    "      bytes_remaining -= size;\n"
-    "    }\n"
-    "  }\n"
-    "  return true;\n"
-    "}\n"
-    "\n"
-    "bool NextCppCharToJsonEscapedBuffer(\n"
-    "    char **src_ptr,\n"
-    "    const char *src_end_ptr,\n"
-    "    char *json_escaped_buf,\n"
-    "    google::protobuf::uint64 *json_escaped_size) {\n"
-    "  google::protobuf::uint64 src_len = src_end_ptr - *src_ptr;\n"
-    "\n"
-    "  // TODO(ahochhaus): json.org escapes '/', but goog.json does not.\n"
-    "\n"
-    "  // http://en.wikipedia.org/wiki/UTF-8\n"
-    "  google::protobuf::uint64 src_bytes = 0;\n"
-    "  char init_mask = 0;\n"
-    "  if ((**src_ptr & 0b10000000) == 0b00000000 && src_len >= 1) {\n"
-    "    // one byte sequence\n"
-    "    // 0xxxxxxx -> 0xxxxxxx\n"
-    "    const char c = *(*src_ptr)++ & 0b01111111;\n"
-    "    switch (c) {\n"
-    "      case '\"':\n"
-    "      case '\\\\':\n"
-    "        json_escaped_buf[0] = '\\\\';\n"
-    "        json_escaped_buf[1] = c;\n"
-    "        *json_escaped_size = 2;\n"
-    "        break;\n"
-    "      case '\\b':\n"
-    "        json_escaped_buf[0] = '\\\\';\n"
-    "        json_escaped_buf[1] = 'b';\n"
-    "        *json_escaped_size = 2;\n"
-    "        break;\n"
-    "      case '\\f':\n"
-    "        json_escaped_buf[0] = '\\\\';\n"
-    "        json_escaped_buf[1] = 'f';\n"
-    "        *json_escaped_size = 2;\n"
-    "        break;\n"
-    "      case '\\n':\n"
-    "        json_escaped_buf[0] = '\\\\';\n"
-    "        json_escaped_buf[1] = 'n';\n"
-    "        *json_escaped_size = 2;\n"
-    "        break;\n"
-    "      case '\\r':\n"
-    "        json_escaped_buf[0] = '\\\\';\n"
-    "        json_escaped_buf[1] = 'r';\n"
-    "        *json_escaped_size = 2;\n"
-    "        break;\n"
-    "      case '\\t':\n"
-    "        json_escaped_buf[0] = '\\\\';\n"
-    "        json_escaped_buf[1] = 't';\n"
-    "        *json_escaped_size = 2;\n"
-    "        break;\n"
-    "      default:\n"
-    "        json_escaped_buf[0] = c;\n"
-    "        *json_escaped_size = 1;\n"
-    "        break;\n"
-    "    }\n"
-    "    return true;\n"
-    "  } else if ((**src_ptr & 0b11100000) == 0b11000000 &&\n"
-    "             src_len >= 2) {\n"
-    "    // two byte sequence\n"
-    "    // 110yyyyy 10xxxxxx -> 00000yyy yyxxxxxx\n"
-    "    src_bytes = 2;\n"
-    "    init_mask = 0b00011111;\n"
-    "  } else if ((**src_ptr & 0b11110000) == 0b11100000 &&\n"
-    "             src_len >= 3) {\n"
-    "    // three byte sequence\n"
-    "    // 1110zzzz 10yyyyyy 10xxxxxx -> zzzzyyyy yyxxxxxx\n"
-    "    src_bytes = 3;\n"
-    "    init_mask = 0b00001111;\n"
-    "  } else if ((**src_ptr & 0b11111000) == 0b11110000 &&\n"
-    "             src_len >= 4) {\n"
-    "    // four byte sequence\n"
-    "    // 11110www 10zzzzzz 10yyyyyy 10xxxxxx -> "  // no newline
-    "000wwwzz zzzzyyyy yyxxxxxx\n"
-    "    src_bytes = 4;\n"
-    "    init_mask = 0b00000111;\n"
-    "  } else {\n"
-    "    // illegal encoding\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "\n"
-    "  google::protobuf::uint64 val = *(*src_ptr)++ & init_mask;\n"
-    "  for (google::protobuf::uint64 i = 1; i < src_bytes; ++i) {\n"
-    "    val = val << 6;\n"
-    "    val |= *(*src_ptr)++ & 0b00111111;\n"
-    "  }\n"
-    "\n"
-    "  if (snprintf(json_escaped_buf,\n"
-    "               sizeof(json_escaped_buf),\n"
-    "               \"\\\\u%04lx\",\n"
-    "               val) != 6) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  *json_escaped_size = 6;\n"
-    "\n"
-    "  return true;\n"
-    "}\n"
-    "bool WriteEscaped(\n"
-    "    const std::string &value,\n"
-    "    google::protobuf::io::ZeroCopyOutputStream *output) {\n"
-    "  char *src_ptr = const_cast<char *> (value.data());\n"
-    "  const char *src_end_ptr = src_ptr + value.length();\n"
-    "  std::string json_escaped_str;\n"
-    "  while (src_ptr < src_end_ptr) {\n"
-    "    char json_escaped_buf[7];\n"
-    "    google::protobuf::uint64 json_escaped_size;\n"
-    "    if (!NextCppCharToJsonEscapedBuffer(\n"
-    "      &src_ptr, src_end_ptr, json_escaped_buf, &json_escaped_size)) {\n"
-    "      RTN_FALSE;\n"
-    "    }\n"
-    "    json_escaped_str += std::string(json_escaped_buf,\n"
-    "                                    json_escaped_size);\n"
-    "  }\n"
-    "  if (!WriteRaw(json_escaped_str, output)) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  return true;\n"
-    "}\n"
-    "\n"
-    "bool WriteString(\n"
-    "    const std::string &value,\n"
-    "    google::protobuf::io::ZeroCopyOutputStream *output) {\n"
-    "  if (!WriteRaw(\"\\\"\", output)) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  if (!WriteEscaped(value, output)) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  if (!WriteRaw(\"\\\"\", output)) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  return true;\n"
-    "}\n"
-    "\n"
-    "bool WritePbLiteNullEntries(\n"
-    "    const google::protobuf::uint32 field_num,\n"
-    "    const std::set<google::protobuf::uint32> repeated_field_set,\n"
-    "    const bool start_index_one,\n"
-    "    google::protobuf::uint32 *cur_field_num,\n"
-    "    google::protobuf::io::ZeroCopyOutputStream *output) {\n"
-    "  if (*cur_field_num > field_num) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "\n"
-    "  while (*cur_field_num < field_num) {\n"
-    "    std::string write_str;\n"
-    "    if (!start_index_one) {\n"
-    "      write_str = (*cur_field_num != 0) ? \",\" : \"\";\n"
-    "    } else {\n"
-    "      write_str = (*cur_field_num != 1) ? \",\" : \"\";\n"
-    "    }\n"
-    "    if (repeated_field_set.find(*cur_field_num) ==\n"
-    "        repeated_field_set.end()) {\n"
-    "      write_str += \"null\";\n"
-    "    } else {\n"
-    "      write_str += \"[]\";\n"
-    "    }\n"
-    "    if (!WriteRaw(write_str, output)) {\n"
-    "      RTN_FALSE;\n"
-    "    }\n"
-    "    ++(*cur_field_num);\n"
-    "  }\n"
-    "  if (!start_index_one || *cur_field_num != 1) {\n"
-    "    if (!WriteRaw(\",\", output)) {\n"
-    "      RTN_FALSE;\n"
-    "    }\n"
-    "  }\n"
-    "  ++(*cur_field_num);\n"
-    "  return true;\n"
-    "}\n"
-    "\n"
-    "bool WriteObjectKey(\n"
-    "    const std::string &key,\n"
-    "    const bool prev_fields,\n"
-    "    google::protobuf::io::ZeroCopyOutputStream *output) {\n"
-    "  if (prev_fields) {\n"
-    "    if (!WriteRaw(\",\", output)) {\n"
-    "      RTN_FALSE;\n"
-    "    }\n"
-    "  }\n"
-    "  if (!WriteRaw(\"\\\"\", output)) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  if (!WriteRaw(key, output)) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  if (!WriteRaw(\"\\\":\", output)) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  return true;\n"
-    "}\n"
-    "\n"
-    "enum Token {\n"
-    "  TOKEN_NONE,\n"
-    "  TOKEN_CURLY_OPEN,\n"
-    "  TOKEN_CURLY_CLOSE,\n"
-    "  TOKEN_SQUARE_OPEN,\n"
-    "  TOKEN_SQUARE_CLOSE,\n"
-    "  TOKEN_COLON,\n"
-    "  TOKEN_COMMA,\n"
-    "  TOKEN_STRING,\n"
-    "  TOKEN_NUMBER,\n"
-    "  TOKEN_NULL,\n"
-    "  TOKEN_TRUE,\n"
-    "  TOKEN_FALSE\n"
-    "};\n"
-    "\n"
-    "bool ReadToken(const bool eat_single_char_token,\n"
-    "               Token *token,\n"
-    "               google::protobuf::io::ZeroCopyInputStream *input) {\n"
-    "  char token_buffer[5];\n"
-    "  int token_buffer_chars = 0;\n"
-    "  *token = TOKEN_NONE;\n"
-    "\n"
-    "  const void *read_buffer;\n"
-    "  int read_size;\n"
-    "  while (input->Next(&read_buffer, &read_size)) {\n"
-    "    if (read_size > 0) {\n"
-    "      int extra_chars_read = read_size - (5 - token_buffer_chars);\n"
-    "      if (extra_chars_read < 0) {\n"
-    "        extra_chars_read = 0;\n"
-    "      }\n"
-    "      int token_size = 0;\n"
-    "      for (int i = 0; i < read_size && token_buffer_chars < 5; ++i) {\n"
-    "        token_buffer[token_buffer_chars++] = "  // no newline
-    "static_cast<const char *> (\n"
-    "            read_buffer)[i];\n"
-    "      }\n"
-    "      switch (token_buffer[0]) {\n"
-    "        case '{':\n"
-    "          *token = TOKEN_CURLY_OPEN;\n"
-    "          token_size = eat_single_char_token ? 1 : 0;\n"
-    "          break;\n"
-    "        case '}':\n"
-    "          *token = TOKEN_CURLY_CLOSE;\n"
-    "          token_size = eat_single_char_token ? 1 : 0;\n"
-    "          break;\n"
-    "        case '[':\n"
-    "          *token = TOKEN_SQUARE_OPEN;\n"
-    "          token_size = eat_single_char_token ? 1 : 0;\n"
-    "          break;\n"
-    "        case ']':\n"
-    "          *token = TOKEN_SQUARE_CLOSE;\n"
-    "          token_size = eat_single_char_token ? 1 : 0;\n"
-    "          break;\n"
-    "        case ':':\n"
-    "          *token = TOKEN_COLON;\n"
-    "          token_size = eat_single_char_token ? 1 : 0;\n"
-    "          break;\n"
-    "        case ',':\n"
-    "          *token = TOKEN_COMMA;\n"
-    "          token_size = eat_single_char_token ? 1 : 0;\n"
-    "          break;\n"
-    "        case '\"':\n"
-    "          *token = TOKEN_STRING;\n"
-    "          token_size = eat_single_char_token ? 1 : 0;\n"
-    "          break;\n"
-    "        case '-':\n"
-    "        case '0':\n"
-    "        case '1':\n"
-    "        case '2':\n"
-    "        case '3':\n"
-    "        case '4':\n"
-    "        case '5':\n"
-    "        case '6':\n"
-    "        case '7':\n"
-    "        case '8':\n"
-    "        case '9':\n"
-    "          *token = TOKEN_NUMBER;\n"
-    "          token_size = 0;\n"
-    "          break;\n"
-    "        case 'n':\n"
-    "          if (token_buffer_chars >= 4 &&\n"
-    "              token_buffer[1] == 'u' &&\n"
-    "              token_buffer[2] == 'l' &&\n"
-    "              token_buffer[3] == 'l') {\n"
-    "            *token = TOKEN_NULL;\n"
-    "            token_size = 4;\n"
-    "          }\n"
-    "          break;\n"
-    "        case 't':\n"
-    "          if (token_buffer_chars >= 4 &&\n"
-    "              token_buffer[1] == 'r' &&\n"
-    "              token_buffer[2] == 'u' &&\n"
-    "              token_buffer[3] == 'e') {\n"
-    "            *token = TOKEN_TRUE;\n"
-    "            token_size = 4;\n"
-    "          }\n"
-    "          break;\n"
-    "        case 'f':\n"
-    "          if (token_buffer_chars >= 5 &&\n"
-    "              token_buffer[1] == 'a' &&\n"
-    "              token_buffer[2] == 'l' &&\n"
-    "              token_buffer[3] == 's' &&\n"
-    "              token_buffer[4] == 'e') {\n"
-    "            *token = TOKEN_FALSE;\n"
-    "            token_size = 5;\n"
-    "          }\n"
-    "          break;\n"
-    "        default:\n"
-    "          RTN_FALSE;\n"
-    "          break;\n"
-    "      }\n"
-    "      if (*token != TOKEN_NONE) {\n"
-    "        input->BackUp("  // no newline
-    "extra_chars_read + (token_buffer_chars - token_size));\n"
-    "        return true;\n"
-    "      } else if (token_buffer_chars == 5) {\n"
-    "        RTN_FALSE;\n"
-    "      }\n"
-    "    }\n"
-    "  }\n"
-    "  if (token_buffer_chars > 0) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  return true;\n"
-    "}\n"
-    "\n"
-    "bool ReadString(std::string *value,\n"
-    "                google::protobuf::io::ZeroCopyInputStream *input) {\n"
-    "  const void *read_buffer;\n"
-    "  char utf8_buf[5];\n"
-    "  enum ParseState {\n"
-    "    NORMAL,\n"
-    "    ESCAPE,\n"
-    "    UTF0,\n"
-    "    UTF1,\n"
-    "    UTF2,\n"
-    "    UTF3,\n"
-    "  };\n"
-    "  ParseState state = NORMAL;\n"
-    "  int read_size;\n"
-    "  while (input->Next(&read_buffer, &read_size)) {\n"
-    "    if (read_size > 0) {\n"
-    "      const char *read_buf = static_cast<const char *> (read_buffer);\n"
-    "      for (int i = 0; i < read_size; ++i) {\n"
-    "        const char cur_char = read_buf[i];\n"
-    "        if (state == NORMAL) {\n"
-    "          switch (cur_char) {\n"
-    "            case '\\\\':\n"
-    "              state = ESCAPE;\n"
-    "              break;\n"
-    "            case '\"':\n"
-    "              input->BackUp(read_size - i - 1);\n"
-    "              return true;\n"
-    "              break;\n"
-    "            default:\n"
-    "              value->append(1, cur_char);\n"
-    "              break;\n"
-    "          }\n"
-    "        } else if (state == ESCAPE) {\n"
-    "          switch (cur_char) {\n"
-    "            case '\"':\n"
-    "            case '\\\\':\n"
-    "              value->append(1, cur_char);\n"
-    "              state = NORMAL;\n"
-    "              break;\n"
-    "            case 'b':\n"
-    "              value->append(1, '\\b');\n"
-    "              state = NORMAL;\n"
-    "              break;\n"
-    "            case 'f':\n"
-    "              value->append(1, '\\f');\n"
-    "              state = NORMAL;\n"
-    "              break;\n"
-    "            case 'n':\n"
-    "              value->append(1, '\\n');\n"
-    "              state = NORMAL;\n"
-    "              break;\n"
-    "            case 'r':\n"
-    "              value->append(1, '\\r');\n"
-    "              state = NORMAL;\n"
-    "              break;\n"
-    "            case 't':\n"
-    "              value->append(1, '\\t');\n"
-    "              state = NORMAL;\n"
-    "              break;\n"
-    "            case 'u':\n"
-    "              state = UTF0;\n"
-    "              break;\n"
-    "            default:\n"
-    "              RTN_FALSE;\n"
-    "              break;\n"
-    "          }\n"
-    "        } else if (state == UTF0) {\n"
-    "          utf8_buf[0] = cur_char;\n"
-    "          state = UTF1;\n"
-    "        } else if (state == UTF1) {\n"
-    "          utf8_buf[1] = cur_char;\n"
-    "          state = UTF2;\n"
-    "        } else if (state == UTF2) {\n"
-    "          utf8_buf[2] = cur_char;\n"
-    "          state = UTF3;\n"
-    "        } else if (state == UTF3) {\n"
-    "          utf8_buf[3] = cur_char;\n"
-    "          utf8_buf[4] = '\\0';\n"
-    "          state = NORMAL;\n"
-    "\n"
-    "          google::protobuf::uint64 val;\n"
-    "          if (sscanf(utf8_buf, \"%04lx\", &val) != 1) {\n"
-    "            RTN_FALSE;\n"
-    "          }\n"
-    "          if (val < 0x00080) {\n"
-    "            // one byte sequence\n"
-    "            // 0xxxxxxx -> 0xxxxxxx\n"
-    "            char output[1];\n"
-    "            output[0] = 0b00000000 | (val & 0b01111111);\n"
-    "            value->append(output, sizeof(output));\n"
-    "          } else if (val < 0x00800) {\n"
-    "            // two byte sequence\n"
-    "            // 00000yyy yyxxxxxx -> 110yyyyy 10xxxxxx\n"
-    "            char output[2];\n"
-    "            output[0] = 0b11000000 | (val >> 6 & 0b00011111);\n"
-    "            output[1] = 0b10000000 | (val & 0b00111111);\n"
-    "            value->append(output, sizeof(output));\n"
-    "          } else if (val < 0x10000) {\n"
-    "            // three byte sequence\n"
-    "            // zzzzyyyy yyxxxxxx -> 1110zzzz 10yyyyyy 10xxxxxx\n"
-    "            char output[3];\n"
-    "            output[0] = 0b11100000 | (val >> 12 & 0b00001111);\n"
-    "            output[1] = 0b10000000 | (val >> 6 & 0b00111111);\n"
-    "            output[2] = 0b10000000 | (val & 0b00111111);\n"
-    "            value->append(output, sizeof(output));\n"
-    "          } else if (val < 0x11000) {\n"
-    "            // four byte sequence\n"
-    "            // 000wwwzz zzzzyyyy yyxxxxxx -> " // no newline
-    "11110www 10zzzzzz 10yyyyyy 10xxxxxx\n"
-    "            char output[4];\n"
-    "            output[0] = 0b11110000 | (val >> 18 & 0b00000111);\n"
-    "            output[1] = 0b10000000 | (val >> 12 & 0b00111111);\n"
-    "            output[2] = 0b10000000 | (val >> 6 & 0b00111111);\n"
-    "            output[3] = 0b10000000 | (val & 0b00111111);\n"
-    "            value->append(output, sizeof(output));\n"
-    "          } else {\n"
-    "            RTN_FALSE;\n"
-    "          }\n"
-    "        } else {\n"
-    "          RTN_FALSE;\n"
-    "        }\n"
-    "      }\n"
-    "    }\n"
-    "  }\n"
-    "  RTN_FALSE;\n"
-    "}\n"
-    "\n"
-    "bool ReadNumber(std::string *value,\n"
-    "                google::protobuf::io::ZeroCopyInputStream *input) {\n"
-    "  const void *read_buffer;\n"
-    "  int read_size;\n"
-    "  enum State {\n"
-    "    PRE_SIGN,\n"
-    "    PRE_WHOLE,\n"
-    "    WHOLE,\n"
-    "    PRE_FRACTION,\n"
-    "    FRACTION,\n"
-    "    PRE_EXP,\n"
-    "    EXP_SIGN,\n"
-    "    PRE_EXP_DIGIT,\n"
-    "    EXP_DIGIT\n"
-    "  };\n"
-    "  State state = PRE_SIGN;\n"
-    "  while (input->Next(&read_buffer, &read_size)) {\n"
-    "    if (read_size > 0) {\n"
-    "      const char *read_buf = static_cast<const char *> (read_buffer);\n"
-    "      for (int i = 0; i < read_size; ++i) {\n"
-    "        char read_char = read_buf[i];\n"
-    "        switch (state) {\n"
-    "          case PRE_SIGN:\n"
-    "            if (read_char == '-') {\n"
-    "              state = PRE_WHOLE;\n"
-    "            } else if (read_char == '0') {\n"
-    "              state = PRE_FRACTION;\n"
-    "            } else if (read_char >= '1' && read_char <= '9') {\n"
-    "              state = WHOLE;\n"
-    "            } else {\n"
-    "              RTN_FALSE;\n"
-    "            }\n"
-    "            break;\n"
-    "          case PRE_WHOLE:\n"
-    "            if (read_char == '0') {\n"
-    "              state = PRE_FRACTION;\n"
-    "            } else if (read_char >= '1' && read_char <= '9') {\n"
-    "              state = WHOLE;\n"
-    "            } else {\n"
-    "              RTN_FALSE;\n"
-    "            }\n"
-    "            break;\n"
-    "          case WHOLE:\n"
-    "            if (read_char >= '0' && read_char <= '9') {\n"
-    "              // state = WHOLE;\n"
-    "            } else if (read_char == '.') {\n"
-    "              state = FRACTION;\n"
-    "            } else if (read_char == 'e' || read_char == 'E') {\n"
-    "              state = EXP_SIGN;\n"
-    "            } else if (read_char == '\"' ||\n"
-    "                       read_char == ',' ||\n"
-    "                       read_char == '}' ||\n"
-    "                       read_char == ']') {\n"
-    "              input->BackUp(read_size - i);\n"
-    "              return true;\n"
-    "            } else {\n"
-    "              RTN_FALSE;\n"
-    "            }\n"
-    "            break;\n"
-    "          case PRE_FRACTION:\n"
-    "            if (read_char == '.') {\n"
-    "              state = FRACTION;\n"
-    "            } else if (read_char == 'e' || read_char == 'E') {\n"
-    "              state = EXP_SIGN;\n"
-    "            } else if (read_char == '\"' ||\n"
-    "                       read_char == ',' ||\n"
-    "                       read_char == '}' ||\n"
-    "                       read_char == ']') {\n"
-    "              input->BackUp(read_size - i);\n"
-    "              return true;\n"
-    "            } else {\n"
-    "              RTN_FALSE;\n"
-    "            }\n"
-    "            break;\n"
-    "          case FRACTION:\n"
-    "            if (read_char >= '0' && read_char <= '9') {\n"
-    "              // state = FRACTION;\n"
-    "            } else if (read_char == 'e' || read_char == 'E') {\n"
-    "              state = EXP_SIGN;\n"
-    "            } else if (read_char == '\"' ||\n"
-    "                       read_char == ',' ||\n"
-    "                       read_char == '}' ||\n"
-    "                       read_char == ']') {\n"
-    "              input->BackUp(read_size - i);\n"
-    "              return true;\n"
-    "            } else {\n"
-    "              RTN_FALSE;\n"
-    "            }\n"
-    "            break;\n"
-    "          case PRE_EXP:\n"
-    "            if (read_char == 'e' || read_char == 'E') {\n"
-    "              state = EXP_SIGN;\n"
-    "            } else if (read_char == '\"' ||\n"
-    "                       read_char == ',' ||\n"
-    "                       read_char == '}' ||\n"
-    "                       read_char == ']') {\n"
-    "              input->BackUp(read_size - i);\n"
-    "              return true;\n"
-    "            } else {\n"
-    "              RTN_FALSE;\n"
-    "            }\n"
-    "            break;\n"
-    "          case EXP_SIGN:\n"
-    "            if (read_char == '+' || read_char == '-') {\n"
-    "              state = PRE_EXP_DIGIT;\n"
-    "            } else if (read_char >= '0' && read_char <= '9') {\n"
-    "              state = EXP_DIGIT;\n"
-    "            } else {\n"
-    "              RTN_FALSE;\n"
-    "            }\n"
-    "            break;\n"
-    "          case PRE_EXP_DIGIT:\n"
-    "            if (read_char >= '0' && read_char <= '9') {\n"
-    "              state = EXP_DIGIT;\n"
-    "            } else {\n"
-    "              RTN_FALSE;\n"
-    "            }\n"
-    "            break;\n"
-    "          case EXP_DIGIT:\n"
-    "            if (read_char >= '0' && read_char <= '9') {\n"
-    "              // state = EXP_DIGIT;\n"
-    "            } else if (read_char == '\"' ||\n"
-    "                       read_char == ',' ||\n"
-    "                       read_char == '}' ||\n"
-    "                       read_char == ']') {\n"
-    "              input->BackUp(read_size - i);\n"
-    "              return true;\n"
-    "            } else {\n"
-    "              RTN_FALSE;\n"
-    "            }\n"
-    "            break;\n"
-    "          default:\n"
-    "            RTN_FALSE;\n"
-    "            break;\n"
-    "        }\n"
-    "        value->append(1, read_char);\n"
-    "      }\n"
-    "    }\n"
-    "  }\n"
-    "  RTN_FALSE;\n"
-    "}\n"
-    "\n"
-    "bool ReadNumberFromString(\n"
-    "    std::string *value,\n"
-    "    google::protobuf::io::ZeroCopyInputStream *input) {\n"
-    "  Token token;\n"
-    "  if (!ReadToken(true, &token, input) || token != TOKEN_STRING) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  if (!ReadNumber(value, input)) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  if (!ReadToken(true, &token, input) || token != TOKEN_STRING) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  return true;\n"
-    "}\n"
-    "\n"
-    "bool ReadPbLiteNextTag(\n"
-    "    google::protobuf::int32 *cur_field_num,\n"
-    "    Token *token,\n"
-    "    google::protobuf::io::ZeroCopyInputStream *input) {\n"
-    "  while (ReadToken(false, token, input)) {\n"
-    "    if (*token == TOKEN_NULL) {\n"
-    "      // multi char tokens are always eaten\n"
-    "      continue;\n"
-    "    } else if (*token == TOKEN_COMMA) {\n"
-    "      if (!ReadToken(true, token, input) ||\n"
-    "          *token != TOKEN_COMMA) {\n"
-    "        RTN_FALSE;\n"
-    "      }\n"
-    "      ++*cur_field_num;\n"
-    "    } else if (*token == TOKEN_SQUARE_CLOSE) {\n"
-    "      *cur_field_num = -1;\n"
-    "      return true;\n"
-    "    } else if (*token == TOKEN_NONE) {\n"
-    "      RTN_FALSE;\n"
-    "    } else {\n"
-    "      return true;\n"
-    "    }\n"
-    "  }\n"
-    "  RTN_FALSE;\n"
-    "}\n"
-    "\n"
-    "bool ReadObjectKeyName(\n"
-    "    std::string *value,\n"
-    "    Token *token,\n"
-    "    google::protobuf::io::ZeroCopyInputStream *input) {\n"
-    "  if (!ReadToken(false, token, input)) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  if (*token == TOKEN_COMMA) {\n"
-    "    if (!ReadToken(true, token, input) ||\n"
-    "        !ReadToken(false, token, input)) {\n"
-    "      RTN_FALSE;\n"
-    "    }\n"
-    "  } else if (*token == TOKEN_CURLY_CLOSE) {\n"
-    "      *value = \"\";\n"
-    "      return true;\n"
-    "  }\n"
-    "  if (!ReadToken(true, token, input) ||\n"
-    "      *token != TOKEN_STRING) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  if (!ReadString(value, input)) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  if (value->empty()) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  if (!ReadToken(true, token, input) || *token != TOKEN_COLON) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  if (!ReadToken(false, token, input)) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  return true;\n"
-    "}\n"
-    "\n"
-    "bool ReadObjectKeyTag(\n"
-    "    google::protobuf::int32 *cur_field_num,\n"
-    "    Token *token,\n"
-    "    google::protobuf::io::ZeroCopyInputStream *input) {\n"
-    "  std::string value;\n"
-    "  if (!ReadObjectKeyName(&value, token, input)) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  if (value.empty()) {\n"
-    "    *cur_field_num = -1;\n"
-    "    return true;\n"
-    "  }\n"
-    "  if (sscanf(value.c_str(), \"%d\", cur_field_num) != 1) {\n"
-    "    RTN_FALSE;\n"
-    "  }\n"
-    "  return true;\n"
-    "}\n"
-    "\n"
-    "}  // namespace\n"
+    "using namespace sg::protobuf::ccjs::runtime;  // NOLINT\n"
     "\n";
 
 }  // namespace internal
@@ -817,9 +558,16 @@ CodeGenerator::~CodeGenerator() {}
 
 bool CodeGenerator::HeaderFile(
     const std::string &output_h_file_name,
-    const std::string &class_scope,
+    const google::protobuf::Descriptor *message,
     google::protobuf::compiler::OutputDirectory *output_directory,
     std::string *error) const {
+  const std::string class_scope = "class_scope:" + message->full_name();
+  // The class being declared is only known by its own name yet.
+  std::string class_name = message->full_name();
+  if (!message->file()->package().empty()) {
+    class_name = class_name.substr(message->file()->package().size() + 1);
+  }
+  class_name = internal::ReplaceAll(".", "_", class_name);
   google::protobuf::internal::scoped_ptr<
     google::protobuf::io::ZeroCopyOutputStream> output_h(
         output_directory->OpenForInsert(output_h_file_name,
@@ -848,6 +596,119 @@ bool CodeGenerator::HeaderFile(
       "    const bool start_index_one,\n"
       "    google::protobuf::io::ZeroCopyInputStream *input);\n"
       "\n"
+      "// The Validate*() variants accept exactly the inputs that the\n"
+      "// matching ParsePartialFrom*() accepts but store nothing, and so\n"
+      "// do not allocate for well-formed inputs.\n"
+      "static bool ValidateZeroCopyJsonStream(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    google::protobuf::io::ZeroCopyInputStream *input);\n"
+      "\n"
+      "static bool ValidatePbLiteArray(const void *data, int size);\n"
+      "\n"
+      "static bool ValidatePbLiteString(const std::string &input);\n"
+      "\n"
+      "static bool ValidatePbLiteZeroIndexArray(const void *data, int size);\n"
+      "\n"
+      "static bool ValidatePbLiteZeroIndexString(const std::string &input);\n"
+      "\n"
+      "static bool ValidateObjectKeyNameArray(const void *data, int size);\n"
+      "\n"
+      "static bool ValidateObjectKeyNameString(const std::string &input);\n"
+      "\n"
+      "static bool ValidateObjectKeyTagArray(const void *data, int size);\n"
+      "\n"
+      "static bool ValidateObjectKeyTagString(const std::string &input);\n"
+      "\n"
+      "// The Transcode*ToBinary() variants append the binary wire format of\n"
+      "// the JSON that the matching ParsePartialFrom*() accepts to output\n"
+      "// without building a message, with fields in the order of the JSON.\n"
+      "// On failure output is left with a partial value.\n"
+      "static bool TranscodeZeroCopyJsonStreamToBinary(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    google::protobuf::io::ZeroCopyInputStream *input,\n"
+      "    std::string *output);\n"
+      "\n"
+      "static bool TranscodePbLiteStringToBinary(\n"
+      "    const std::string &input, std::string *output);\n"
+      "\n"
+      "static bool TranscodePbLiteZeroIndexStringToBinary(\n"
+      "    const std::string &input, std::string *output);\n"
+      "\n"
+      "static bool TranscodeObjectKeyNameStringToBinary(\n"
+      "    const std::string &input, std::string *output);\n"
+      "\n"
+      "static bool TranscodeObjectKeyTagStringToBinary(\n"
+      "    const std::string &input, std::string *output);\n"
+      "\n"
+      "// The TranscodeBinaryTo*() variants write the JSON that\n"
+      "// SerializePartialTo*() writes for the binary message in data without\n"
+      "// parsing it into a message. Unknown fields are dropped. Mismatched\n"
+      "// wire types and unknown enum values, which the protobuf parser keeps\n"
+      "// as unknown fields, are rejected.\n"
+      "static bool TranscodeBinaryToZeroCopyJsonStream(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    const void *data,\n"
+      "    int size,\n"
+      "    google::protobuf::io::ZeroCopyOutputStream *output);\n"
+      "\n"
+      "static bool TranscodeBinaryToPbLiteString(\n"
+      "    const std::string &input, std::string *output);\n"
+      "\n"
+      "static bool TranscodeBinaryToPbLiteZeroIndexString(\n"
+      "    const std::string &input, std::string *output);\n"
+      "\n"
+      "static bool TranscodeBinaryToObjectKeyNameString(\n"
+      "    const std::string &input, std::string *output);\n"
+      "\n"
+      "static bool TranscodeBinaryToObjectKeyTagString(\n"
+      "    const std::string &input, std::string *output);\n"
+      "\n"
+      "// TranscodeZeroCopyJsonStream() and TranscodeJsonString() rewrite\n"
+      "// the JSON that ParsePartialFromZeroCopyJsonStream() accepts into\n"
+      "// the JSON that SerializePartialToZeroCopyJsonStream() writes in the\n"
+      "// output format, without building a message. Numbers and strings\n"
+      "// are copied verbatim. Each message is held until it is complete, as\n"
+      "// its fields are written in declaration order. Unknown fields are\n"
+      "// dropped, and a singular message field that occurs more than once,\n"
+      "// which the parser merges, is rejected.\n"
+      "static bool TranscodeZeroCopyJsonStream(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    google::protobuf::io::ZeroCopyInputStream *input,\n"
+      "    const google::protobuf::uint32 output_type,\n"
+      "    const bool output_booleans_as_numbers,\n"
+      "    const bool output_start_index_one,\n"
+      "    google::protobuf::io::ZeroCopyOutputStream *output);\n"
+      "\n"
+      "static bool TranscodeJsonString(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    const std::string &input,\n"
+      "    const google::protobuf::uint32 output_type,\n"
+      "    const bool output_booleans_as_numbers,\n"
+      "    const bool output_start_index_one,\n"
+      "    std::string *output);\n"
+      "\n"
+      "// Parses the value at structurals[*cursor] of a structural index over\n"
+      "// data, see CCJS_STRUCTURAL_INDEX_MIN_SIZE.\n"
+      "bool ParsePartialFromStructuralIndex(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    ::sg::protobuf::ccjs::runtime::LazySpans *lazy,\n"
+      "    const char *data,\n"
+      "    const google::protobuf::uint32 *structurals,\n"
+      "    const size_t structural_count,\n"
+      "    size_t *cursor);\n"
+      "\n"
       "bool ParsePartialFromPbLiteArray(const void *data, int size);\n"
       "\n"
       "bool ParsePartialFromPbLiteZeroIndexArray(\n"
@@ -865,7 +726,108 @@ bool CodeGenerator::HeaderFile(
       "bool ParsePartialFromObjectKeyTagArray(const void *data, int size);\n"
       "\n"
       "bool ParsePartialFromObjectKeyTagString(const std::string &output);\n"
-      "\n");
+      "\n"
+      "// The ReparseFrom*() variants clear the message and parse into it in\n"
+      "// place, so that the strings, repeated fields and nested messages of\n"
+      "// an earlier parse are reused. Reparsing same-shaped inputs below\n"
+      "// CCJS_STRUCTURAL_INDEX_MIN_SIZE then performs no allocations.\n"
+      "bool ReparseFromPbLiteArray(const void *data, int size);\n"
+      "\n"
+      "bool ReparseFromPbLiteZeroIndexArray(const void *data, int size);\n"
+      "\n"
+      "bool ReparseFromPbLiteString(const std::string &input);\n"
+      "\n"
+      "bool ReparseFromPbLiteZeroIndexString(const std::string &input);\n"
+      "\n"
+      "bool ReparseFromObjectKeyNameArray(const void *data, int size);\n"
+      "\n"
+      "bool ReparseFromObjectKeyNameString(const std::string &input);\n"
+      "\n"
+      "bool ReparseFromObjectKeyTagArray(const void *data, int size);\n"
+      "\n"
+      "bool ReparseFromObjectKeyTagString(const std::string &input);\n"
+      "\n"
+      "// The Parse*File() variants parse the file at path straight from a\n"
+      "// read-only mapping, including files of more than 2 GB.\n"
+      "bool ParsePartialFromPbLiteFile(const char *path);\n"
+      "\n"
+      "bool ParsePartialFromPbLiteZeroIndexFile(const char *path);\n"
+      "\n"
+      "bool ParsePartialFromObjectKeyNameFile(const char *path);\n"
+      "\n"
+      "bool ParsePartialFromObjectKeyTagFile(const char *path);\n"
+      "\n"
+      "// Parses newline-delimited messages with the type and flags of\n"
+      "// ParsePartialFromZeroCopyJsonStream() into this message, which is\n"
+      "// cleared and reused for every line, and calls callback after each\n"
+      "// one. Returns false on the first invalid line or once callback does.\n"
+      "bool ParsePartialDelimitedFromZeroCopyJsonStream(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    google::protobuf::io::ZeroCopyInputStream *input,\n"
+      "    bool (*callback)(const $class$ &message, void *arg),\n"
+      "    void *arg);\n"
+      "\n"
+      "// Appends the messages of the JSON array in data to messages. The\n"
+      "// array is split at its top-level commas and the elements are parsed\n"
+      "// in order on thread_count threads, or one per CPU for 0, but on\n"
+      "// fewer for small arrays, see CCJS_PARALLEL_ARRAY_MIN_SIZE.\n"
+      "static bool ParsePartialFromJsonArrayInParallel(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    const void *data,\n"
+      "    size_t size,\n"
+      "    int thread_count,\n"
+      "    google::protobuf::RepeatedPtrField<$class$> *messages);\n"
+      "\n"
+      "// Parses input that arrives in chunks with the type and flags of\n"
+      "// ParsePartialFromZeroCopyJsonStream(). Open messages and arrays are\n"
+      "// kept on an explicit stack so that only the token at the end of a\n"
+      "// chunk is buffered. Feed() returns false once the input is invalid,\n"
+      "// Finish() also when the message is incomplete.\n"
+      "class PushParser {\n"
+      " public:\n"
+      "  PushParser($class$ *message,\n"
+      "             const google::protobuf::uint32 type,\n"
+      "             const bool booleans_as_numbers,\n"
+      "             const bool start_index_one);\n"
+      "  ~PushParser();\n"
+      "\n"
+      "  bool Feed(const char *data, size_t size);\n"
+      "\n"
+      "  bool Finish();\n"
+      "\n"
+      " private:\n"
+      "  struct State;\n"
+      "  State *state_;\n"
+      "\n"
+      "  PushParser(const PushParser &);\n"
+      "  void operator=(const PushParser &);\n"
+      "};\n"
+      "\n"
+      "// Applies one event of a PushParser to this message.\n"
+      "bool PushParseStep(const int event,\n"
+      "                   const bool booleans_as_numbers,\n"
+      "                   const char *text,\n"
+      "                   const int text_size,\n"
+      "                   google::protobuf::int32 *field_num,\n"
+      "                   int *kind,\n"
+      "                   void **child,\n"
+      "                   void *child_step);\n"
+      "\n",
+      "class", class_name);
+
+  std::vector<const google::protobuf::FieldDescriptor *> lazy_fields;
+  internal::LazyFields(message, &lazy_fields);
+  if (!lazy_fields.empty()) {
+    h_printer.Print(
+        "// Parses into a message of this type but only records where its\n"
+        "// singular message fields are. Defined after the class.\n"
+        "class LazyView;\n"
+        "\n");
+  }
 
   if (h_printer.failed()) {
     *error = "CppJsCodeGenerator detected write error.";
@@ -877,15 +839,19 @@ bool CodeGenerator::HeaderFile(
 
 bool CodeGenerator::CppFileHelperFunctions(
     const std::string &output_cc_file_name,
+    const bool code_size,
     google::protobuf::compiler::OutputDirectory *output_directory,
     std::string *error) const {
-  // Note: These functions should really be inserted at the global_scope
-  // however they need to come at the start of the file so we insert them
+  // Note: The runtime should really be included at the global_scope
+  // however it needs to come before the generated code so we insert it
   // after the includes instead.
   google::protobuf::internal::scoped_ptr<
     google::protobuf::io::ZeroCopyOutputStream> output_cc(
         output_directory->OpenForInsert(output_cc_file_name, "includes"));
   google::protobuf::io::Printer cc_printer(output_cc.get(), '$');
+  if (code_size) {
+    cc_printer.Print("#include \"ccjs/ccjs_compact.h\"\n");
+  }
   cc_printer.Print(internal::cc_header_boilerplate.c_str());
 
   if (cc_printer.failed()) {
@@ -898,102 +864,51 @@ bool CodeGenerator::CppFileHelperFunctions(
 
 
 bool CodeGenerator::SerializePartialToZeroCopyJsonStream(
-    const std::string &output_cc_file_name,
     const google::protobuf::Descriptor *message,
-    google::protobuf::compiler::OutputDirectory *output_directory,
+    google::protobuf::io::Printer *cc_printer,
     std::string *error) const {
-  google::protobuf::internal::scoped_ptr<
-    google::protobuf::io::ZeroCopyOutputStream> output_cc(
-        output_directory->OpenForInsert(output_cc_file_name,
-                                        "namespace_scope"));
-  google::protobuf::io::Printer cc_printer(output_cc.get(), '$');
   const std::string base = message->containing_type() ?
       message->containing_type()->full_name() + "_" : "";
   const std::string cc_class_name = base + message->name();
 
-  cc_printer.Print(
+  cc_printer->Print(
       "bool $name$::SerializePartialToZeroCopyJsonStream(\n"
       "    const google::protobuf::uint32 type,\n"
       "    const bool booleans_as_numbers,\n"
       "    const bool start_index_one,\n"
       "    google::protobuf::io::ZeroCopyOutputStream *output) const {\n",
       "name", cc_class_name);
-  cc_printer.Indent();
+  cc_printer->Indent();
   if (message->field_count()) {
-    cc_printer.Print(
+    cc_printer->Print(
         "google::protobuf::uint32 cur_field_num = start_index_one ? 1 : 0;\n"
         "bool prev_fields = false;\n");
   }
-  cc_printer.Print(
+  cc_printer->Print(
       "if (!WriteRaw(type == PB_LITE ? \"[\" : \"{\", output)) {\n"
       "  RTN_FALSE;\n"
       "}\n");
 
-  std::string rep_field_set =
-      "std::set<google::protobuf::uint32> rep_field_set;";
-  for (int j = 0; j < message->field_count(); ++j) {
-    const google::protobuf::FieldDescriptor *field = message->field(j);
-    if (field->label() == google::protobuf::FieldDescriptor::LABEL_REPEATED) {
-      char field_number[13];  // ceiling(32/3) + sign char + NULL
-      if (snprintf(field_number,
-                   sizeof(field_number),
-                   "%d",
-                   field->number()) >= 13) {
-        return false;
-      }
-      rep_field_set += ("rep_field_set.insert(" +
-                        std::string(field_number) +
-                        ");");
-    }
-  }
-
   for (int j = 0; j < message->field_count(); ++j) {
     const google::protobuf::FieldDescriptor *field = message->field(j);
     if (field->label() != google::protobuf::FieldDescriptor::LABEL_REPEATED) {
-      cc_printer.Print("// $name$\n"
+      cc_printer->Print("// $name$\n"
                         "if (has_$name$()) {\n",
                         "name", field->lowercase_name());
     } else {
-      cc_printer.Print("// $name$\n"
+      cc_printer->Print("// $name$\n"
                         "if (this->$name$_size() > 0) {\n",
                         "name", field->lowercase_name());
     }
-    cc_printer.Indent();
+    cc_printer->Indent();
 
-    char field_number[13];  // ceiling(32/3) + sign char + NULL
-    if (snprintf(
-            field_number, sizeof(field_number), "%d", field->number()) >= 13) {
+    if (!internal::PrintWriteFieldKey(message, field, "", cc_printer)) {
       return false;
     }
-    cc_printer.Print(
-        "if (type == PB_LITE) {\n"
-        "  $rep_field_set$\n"
-        "  if (!WritePbLiteNullEntries(\n"
-        "      $field_num$, rep_field_set, start_index_one, &cur_field_num,\n"
-        "      output)) {\n"
-        "    RTN_FALSE;\n"
-        "  }\n"
-        "} else {\n"
-        "  if (type == OBJECT_KEY_TAG) {\n"
-        "    if (!WriteObjectKey(\"$field_num$\", prev_fields, output)) {\n"
-        "      RTN_FALSE;\n"
-        "    }\n"
-        "  } else if (type == OBJECT_KEY_NAME) {\n"
-        "    if (!WriteObjectKey(\"$field_name$\", prev_fields, output)) {\n"
-        "      RTN_FALSE;\n"
-        "    }\n"
-        "  } else {\n"
-        "    RTN_FALSE;\n"
-        "  }\n"
-        "  prev_fields = true;\n"
-        "}\n",
-        "rep_field_set", rep_field_set,
-        "field_num", field_number,
-        "field_name", field->name());
 
     if (field->label() ==
         google::protobuf::FieldDescriptor::LABEL_REPEATED) {
-      cc_printer.Print(
+      cc_printer->Print(
           "if (!WriteRaw(\"[\", output)) {\n"
           "  RTN_FALSE;\n"
           "}\n");
@@ -1002,7 +917,7 @@ bool CodeGenerator::SerializePartialToZeroCopyJsonStream(
     if (field->type() == google::protobuf::FieldDescriptor::TYPE_BOOL) {
       if (field->label() !=
           google::protobuf::FieldDescriptor::LABEL_REPEATED) {
-        cc_printer.Print(
+        cc_printer->Print(
             "if (booleans_as_numbers) {\n"
             "  if (!WriteRaw(this->$name$() ? \"1\" : \"0\", output)) {\n"
             "    RTN_FALSE;\n"
@@ -1015,7 +930,7 @@ bool CodeGenerator::SerializePartialToZeroCopyJsonStream(
             "}\n",
             "name", field->lowercase_name());
       } else {
-        cc_printer.Print(
+        cc_printer->Print(
             "for (int i = 0; i < this->$name$_size(); ++i) {\n"
             "  if (!WriteRaw(this->$name$(i) ? \"1\" : \"0\", output)) {\n"
             "    RTN_FALSE;\n"
@@ -1033,13 +948,13 @@ bool CodeGenerator::SerializePartialToZeroCopyJsonStream(
         field->type() == google::protobuf::FieldDescriptor::TYPE_STRING) {
       if (field->label() !=
           google::protobuf::FieldDescriptor::LABEL_REPEATED) {
-        cc_printer.Print(
+        cc_printer->Print(
             "if (!WriteString(this->$name$(), output)) {\n"
             "  RTN_FALSE;\n"
             "}\n",
             "name", field->lowercase_name());
       } else {
-        cc_printer.Print(
+        cc_printer->Print(
             "for (int i = 0; i < this->$name$_size(); ++i) {\n"
             "  if (!WriteString(this->$name$(i), output)) {\n"
             "    RTN_FALSE;\n"
@@ -1057,7 +972,7 @@ bool CodeGenerator::SerializePartialToZeroCopyJsonStream(
         field->type() == google::protobuf::FieldDescriptor::TYPE_MESSAGE) {
       if (field->label() !=
           google::protobuf::FieldDescriptor::LABEL_REPEATED) {
-        cc_printer.Print(
+        cc_printer->Print(
             "if (!this->$name$()."  // no newline
             "SerializePartialToZeroCopyJsonStream(type, "  // no newline
             "booleans_as_numbers, start_index_one, output)) {\n"
@@ -1065,7 +980,7 @@ bool CodeGenerator::SerializePartialToZeroCopyJsonStream(
             "}\n",
             "name", field->lowercase_name());
       } else {
-        cc_printer.Print(
+        cc_printer->Print(
             "for (int i = 0; i < this->$name$_size(); ++i) {\n"
             "  if (!this->$name$(i)."  // no newline
             "SerializePartialToZeroCopyJsonStream(type, "  // no newline
@@ -1081,43 +996,12 @@ bool CodeGenerator::SerializePartialToZeroCopyJsonStream(
             "name", field->lowercase_name());
       }
     } else {
-      std::string format_string = "\\\"%ld\\\"";
-      // ceiling(64/3) + sign char + 2 quotes + NULL;
-      std::string buffer_size = "26";
-      if (field->options().GetExtension(jstype)) {
-        format_string = "%ld";
-        // ceiling(64/3) + sign char + NULL;
-        std::string buffer_size = "24";
-      }
-      if (field->type() == google::protobuf::FieldDescriptor::TYPE_DOUBLE ||
-          field->type() == google::protobuf::FieldDescriptor::TYPE_FLOAT) {
-        format_string = "%g";
-      } else if (
-          field->type() == google::protobuf::FieldDescriptor::TYPE_UINT64 ||
-          field->type() == google::protobuf::FieldDescriptor::TYPE_FIXED64) {
-        if (field->options().GetExtension(jstype)) {
-          format_string = "%lu";
-          buffer_size = "23";  // ceiling(64/3) + NULL
-        } else {
-          format_string = "\\\"%lu\\\"";
-          buffer_size = "25";  // ceiling(64/3) + 2 quotes + NULL
-        }
-      } else if (
-          field->type() == google::protobuf::FieldDescriptor::TYPE_INT32 ||
-          field->type() == google::protobuf::FieldDescriptor::TYPE_SINT32 ||
-          field->type() == google::protobuf::FieldDescriptor::TYPE_SFIXED32 ||
-          field->type() == google::protobuf::FieldDescriptor::TYPE_ENUM) {
-        format_string = "%d";
-        buffer_size = "13";  // ceiling(32/3) + sign char + NULL
-      } else if (
-          field->type() == google::protobuf::FieldDescriptor::TYPE_UINT32 ||
-          field->type() == google::protobuf::FieldDescriptor::TYPE_FIXED32) {
-        format_string = "%u";
-        buffer_size = "12";  // ceiling(32/3) + NULL
-      }
+      std::string format_string;
+      std::string buffer_size;
+      internal::NumberWriter(field, &format_string, &buffer_size);
       if (field->label() !=
           google::protobuf::FieldDescriptor::LABEL_REPEATED) {
-        cc_printer.Print(
+        cc_printer->Print(
             "{\n"
             "  char buffer[$buffer_size$];\n"
             "  if (snprintf(buffer, sizeof(buffer), "  // no newline
@@ -1133,7 +1017,7 @@ bool CodeGenerator::SerializePartialToZeroCopyJsonStream(
             "buffer_size", buffer_size,
             "format", format_string);
       } else {
-        cc_printer.Print(
+        cc_printer->Print(
             "for (int i = 0; i < this->$name$_size(); ++i) {\n"
             "  char buffer[$buffer_size$];\n"
             "  if (snprintf(buffer,\n"
@@ -1159,27 +1043,45 @@ bool CodeGenerator::SerializePartialToZeroCopyJsonStream(
 
     if (field->label() ==
         google::protobuf::FieldDescriptor::LABEL_REPEATED) {
-      cc_printer.Print(
+      cc_printer->Print(
           "if (!WriteRaw(\"]\", output)) {\n"
           "  RTN_FALSE;\n"
           "}\n");
     }
 
-    cc_printer.Outdent();
-    cc_printer.Print("}\n"
+    cc_printer->Outdent();
+    cc_printer->Print("}\n"
                       "\n");
   }
 
   // TODO(ahochhaus): Serialize unknown fields.
-  cc_printer.Print(
+  cc_printer->Print(
       "if (!WriteRaw(type == PB_LITE ? \"]\" : \"}\", output)) {\n"
       "  RTN_FALSE;\n"
       "}\n"
       "return true;\n");
-  cc_printer.Outdent();
-  cc_printer.Print(
+  cc_printer->Outdent();
+  cc_printer->Print(
       "}\n"
-      "\n"
+      "\n");
+
+  if (cc_printer->failed()) {
+    *error = "CppJsCodeGenerator detected write error.";
+    return false;
+  }
+
+  return true;
+}
+
+bool CodeGenerator::SerializePartialToStrings(
+    const google::protobuf::Descriptor *message,
+    google::protobuf::io::Printer *cc_printer,
+    std::string *error) const {
+  const std::string base = message->containing_type() ?
+      message->containing_type()->full_name() + "_" : "";
+  const std::string cc_class_name = base + message->name();
+
+  cc_printer->Print(
       "bool $name$::SerializePartialToPbLiteString(\n"
       "    std::string *output) const {\n"
       "  google::protobuf::io::StringOutputStream target(output);\n"
@@ -1210,7 +1112,7 @@ bool CodeGenerator::SerializePartialToZeroCopyJsonStream(
       "\n",
       "name", cc_class_name);
 
-  if (cc_printer.failed()) {
+  if (cc_printer->failed()) {
     *error = "CppJsCodeGenerator detected write error.";
     return false;
   }
@@ -1219,28 +1121,66 @@ bool CodeGenerator::SerializePartialToZeroCopyJsonStream(
 }
 
 bool CodeGenerator::ParsePartialFromZeroCopyJsonStream(
-    const std::string &output_cc_file_name,
     const google::protobuf::Descriptor *message,
-    google::protobuf::compiler::OutputDirectory *output_directory,
+    const ParseMode mode,
+    google::protobuf::io::Printer *cc_printer,
     std::string *error) const {
-  google::protobuf::internal::scoped_ptr<
-    google::protobuf::io::ZeroCopyOutputStream> output_cc(
-        output_directory->OpenForInsert(output_cc_file_name,
-                                        "namespace_scope"));
-  google::protobuf::io::Printer cc_printer(output_cc.get(), '$');
   const std::string base = message->containing_type() ?
       message->containing_type()->full_name() + "_" : "";
   const std::string cc_class_name = base + message->name();
 
-  cc_printer.Print(
-      "bool $name$::ParsePartialFromZeroCopyJsonStream(\n"
+  // The validator and the transcoders are the parser with every store
+  // left out or replaced, so that all accept exactly the same inputs.
+  std::string function = "ParsePartialFromZeroCopyJsonStream";
+  std::string input = "input";
+  std::string output;
+  if (mode == VALIDATE) {
+    function = "ValidateZeroCopyJsonStream";
+  } else if (mode == TRANSCODE) {
+    function = "TranscodeZeroCopyJsonStreamToBinary";
+    output = ",\n    std::string *output";
+  } else if (mode == TRANSCODE_JSON) {
+    function = "TranscodeZeroCopyJsonStream";
+    input = "source";
+    output = ",\n"
+        "    const google::protobuf::uint32 output_type,\n"
+        "    const bool output_booleans_as_numbers,\n"
+        "    const bool output_start_index_one,\n"
+        "    google::protobuf::io::ZeroCopyOutputStream *output";
+  }
+  cc_printer->Print(
+      "bool $name$::$function$(\n"
       "    const google::protobuf::uint32 type,\n"
       "    const bool booleans_as_numbers,\n"
       "    const bool start_index_one,\n"
-      "    google::protobuf::io::ZeroCopyInputStream *input) {\n",
-      "name", cc_class_name);
-  cc_printer.Indent();
-  cc_printer.Print(
+      "    google::protobuf::io::ZeroCopyInputStream *$input$$output$) {\n",
+      "name", cc_class_name,
+      "function", function,
+      "input", input,
+      "output", output);
+  cc_printer->Indent();
+  if (mode == VALIDATE || mode == TRANSCODE_JSON) {
+    // Only the strings that are read are discarded.
+    for (int i = 0; i < message->field_count(); ++i) {
+      if (message->field(i)->type() ==
+              google::protobuf::FieldDescriptor::TYPE_BYTES ||
+          message->field(i)->type() ==
+              google::protobuf::FieldDescriptor::TYPE_STRING) {
+        cc_printer->Print("DiscardedString discarded;\n");
+        break;
+      }
+    }
+  }
+  if (mode == TRANSCODE_JSON) {
+    cc_printer->Print(
+        "// Numbers and strings are recorded into values as they are read,\n"
+        "// and messages transcoded into it, until all fields are known.\n"
+        "RecordingInputStream recording(source);\n"
+        "google::protobuf::io::ZeroCopyInputStream *input = &recording;\n"
+        "std::string values;\n"
+        "std::vector<JsonValue> fields;\n");
+  }
+  cc_printer->Print(
       "Token token;\n"
       "if (!ReadToken(true, &token, input) ||\n"
       "    (type == PB_LITE && token != TOKEN_SQUARE_OPEN) ||\n"
@@ -1249,120 +1189,231 @@ bool CodeGenerator::ParsePartialFromZeroCopyJsonStream(
       "}\n"
       "\n"
       "google::protobuf::int32 cur_field_num = start_index_one ? 1 : 0;\n"
+      "bool first_tag = true;\n"
       "while (true) {\n"
       "  if (type == PB_LITE) {\n"
-      "    if (!ReadPbLiteNextTag(&cur_field_num, &token, input)) {\n"
+      "    if (!ReadPbLiteNextTag(\n"
+      "            first_tag, &cur_field_num, &token, input)) {\n"
       "      RTN_FALSE;\n"
       "    }\n"
-      "  } else if (type == OBJECT_KEY_NAME) {\n"
-      "    std::string field_name;\n"
-      "    if (!ReadObjectKeyName(&field_name, &token, input)) {\n"
-      "      RTN_FALSE;\n"
-      "    }\n");
+      "  } else if (type == OBJECT_KEY_NAME) {\n");
 
-  cc_printer.Indent();
-  cc_printer.Indent();
-  cc_printer.Print(
-      "if (field_name.empty()) {\n"
-      "  cur_field_num = -1;\n"
-      "}");
-  for (int i = 0; i < message->field_count(); ++i) {
-    const google::protobuf::FieldDescriptor *field = message->field(i);
-    char field_number[13];  // ceiling(32/3) + sign char + NULL
-    if (snprintf(
-            field_number, sizeof(field_number), "%d", field->number()) >= 13) {
-      return false;
-    }
-    cc_printer.Print(
-        " else if (field_name == \"$name$\") {\n"
-        "  cur_field_num = $number$;\n"
-        "}",
-        "name", field->name(),
-        "number", field_number);
+  cc_printer->Indent();
+  cc_printer->Indent();
+  std::string max_length;
+  if (!internal::MaxFieldNameLength(message, &max_length)) {
+    return false;
   }
-  cc_printer.Print(
-      " else {\n"
-      "  // TODO(ahochhaus): process unknown fields.\n"
-      "  cur_field_num = 0;\n"
-      "}\n"
-      "\n");
-  cc_printer.Outdent();
-  cc_printer.Outdent();
+  cc_printer->Print(
+      "char field_name[$max_length$];\n"
+      "int field_name_size;\n"
+      "if (!ReadObjectKey(first_tag, field_name, sizeof(field_name), "
+      "&field_name_size,\n"
+      "                   &token, input)) {\n"
+      "  RTN_FALSE;\n"
+      "}\n",
+      "max_length", max_length);
+  if (!internal::PrintFieldNameLookup(message, cc_printer)) {
+    return false;
+  }
+  cc_printer->Outdent();
+  cc_printer->Outdent();
 
-  cc_printer.Print(
+  cc_printer->Print(
       "  } else if (type == OBJECT_KEY_TAG) {\n"
-      "    if (!ReadObjectKeyTag(&cur_field_num, &token, input)) {\n"
+      "    if (!ReadObjectKeyTag(\n"
+      "            first_tag, &cur_field_num, &token, input)) {\n"
       "      RTN_FALSE;\n"
       "    }\n"
       "  } else {\n"
       "    RTN_FALSE;\n"
       "  }\n"
+      "  first_tag = false;\n"
       "  if (cur_field_num < 0) {\n"
       "    if (!ReadToken(true, &token, input) ||\n"
       "        (type == PB_LITE && token != TOKEN_SQUARE_CLOSE) ||\n"
       "        (type != PB_LITE && token != TOKEN_CURLY_CLOSE)) {\n"
       "      RTN_FALSE;\n"
       "    }\n"
-      "    return true;\n"
-      "  }\n");
-  cc_printer.Indent();
+      "    $end$\n"
+      "  }\n",
+      "end", mode == TRANSCODE_JSON ? "break;" : "return true;");
+  cc_printer->Indent();
   if (message->field_count() > 0) {
-    cc_printer.Print("switch (cur_field_num) {\n");
+    cc_printer->Print("switch (cur_field_num) {\n");
   }
-  cc_printer.Indent();
+  cc_printer->Indent();
 
   for (int j = 0; j < message->field_count(); ++j) {
     const google::protobuf::FieldDescriptor *field = message->field(j);
+    const bool repeated =
+        field->label() == google::protobuf::FieldDescriptor::LABEL_REPEATED;
+    const bool nested =
+        field->type() == google::protobuf::FieldDescriptor::TYPE_GROUP ||
+        field->type() == google::protobuf::FieldDescriptor::TYPE_MESSAGE;
+    const bool scalar = !nested &&
+        field->type() != google::protobuf::FieldDescriptor::TYPE_BYTES &&
+        field->type() != google::protobuf::FieldDescriptor::TYPE_STRING;
 
     char field_number[13];  // ceiling(32/3) + sign char + NULL
     if (snprintf(
             field_number, sizeof(field_number), "%d", field->number()) >= 13) {
       return false;
     }
-    cc_printer.Print("// $name$\n"
+    cc_printer->Print("// $name$\n"
                       "case $number$:\n",
                       "number", field_number,
                       "name", field->lowercase_name());
-    cc_printer.Indent();
+    cc_printer->Indent();
 
-    if (field->label() ==
-        google::protobuf::FieldDescriptor::LABEL_REPEATED) {
-      cc_printer.Print(
+    if (repeated) {
+      cc_printer->Print(
           "if (!ReadToken(true, &token, input) ||\n"
           "    token != TOKEN_SQUARE_OPEN) {\n"
           "  RTN_FALSE;\n"
           "}\n");
+      if (mode == PARSE) {
+        cc_printer->Print(
+            "this->mutable_$name$()->Reserve(\n"
+            "    this->$name$_size() + CountArrayElements(input));\n",
+            "name", field->lowercase_name());
+      }
     }
 
+    std::string type;
+    std::string reader;
+    std::string quoted;
+    std::string enum_type;
+    internal::NumberReader(field, &type, &reader, &quoted, &enum_type);
     if (field->type() == google::protobuf::FieldDescriptor::TYPE_BOOL) {
-      if (field->label() !=
-          google::protobuf::FieldDescriptor::LABEL_REPEATED) {
-        cc_printer.Print(
+      type = "bool";
+    }
+
+    // Transcoding appends numbers and booleans through a WireValueWriter
+    // in place of the setter, and the other values with their tags.
+    std::string store = (repeated ? "this->add_" : "this->set_") +
+        field->lowercase_name();
+    std::string tag;
+    std::string end_tag;
+    const bool packed = mode == TRANSCODE && field->is_packed();
+    if (mode == TRANSCODE) {
+      std::string encoding;
+      int wire_type = 2;
+      if (scalar) {
+        internal::WireEncoding(field, &encoding, &wire_type);
+      } else if (
+          field->type() == google::protobuf::FieldDescriptor::TYPE_GROUP) {
+        wire_type = 3;
+        if (!internal::WireTag(field->number(), 4, &end_tag)) {
+          return false;
+        }
+      }
+      if (!internal::WireTag(field->number(), wire_type, &tag)) {
+        return false;
+      }
+      if (scalar) {
+        cc_printer->Print(
+            "{\n"
+            "  WireValueWriter<$type$> values = {$tag$, $encoding$, output};\n",
+            "type", type,
+            "tag", packed ? "0" : tag,
+            "encoding", encoding);
+        cc_printer->Indent();
+        store = "values.Add";
+      }
+      if (packed) {
+        std::string packed_tag;
+        if (!internal::WireTag(field->number(), 2, &packed_tag)) {
+          return false;
+        }
+        cc_printer->Print(
+            "AppendVarint($tag$, output);\n"
+            "const size_t packed_begin = BeginLengthDelimited(output);\n",
+            "tag", packed_tag);
+      }
+    }
+
+    // Transcoding to JSON records the text of numbers and strings,
+    // rewrites booleans through a JsonBoolWriter and transcodes messages.
+    const bool recorded = mode == TRANSCODE_JSON && !nested &&
+        field->type() != google::protobuf::FieldDescriptor::TYPE_BOOL;
+    if (mode == TRANSCODE_JSON) {
+      if (nested && !repeated) {
+        cc_printer->Print(
+            "if (HasJsonValue(fields, $number$)) {\n"
+            "  RTN_FALSE;\n"
+            "}\n",
+            "number", field_number);
+      }
+      cc_printer->Print(
+          "{\n"
+          "  const size_t begin = values.size();\n");
+      cc_printer->Indent();
+      if (field->type() == google::protobuf::FieldDescriptor::TYPE_BOOL) {
+        cc_printer->Print(
+            "JsonBoolWriter bools = {$as_numbers$, 0, &values};\n",
+            "as_numbers", repeated ? "true" : "output_booleans_as_numbers");
+        store = "bools.Add";
+      } else if (recorded) {
+        cc_printer->Print("recording.Record(&values);\n");
+      }
+    }
+
+    if (field->type() == google::protobuf::FieldDescriptor::TYPE_BOOL) {
+      if (mode == VALIDATE) {
+        if (repeated) {
+          cc_printer->Print(
+              "while (true) {\n"
+              "  if (!ReadToken(true, &token, input)) {\n"
+              "    RTN_FALSE;\n"
+              "  }\n"
+              "  if (token == TOKEN_SQUARE_CLOSE) {\n"
+              "    break;\n"
+              "  }\n");
+          cc_printer->Indent();
+        }
+        cc_printer->Print(
             "if (booleans_as_numbers && token == TOKEN_NUMBER) {\n"
-            "  if (!ReadToken(true, &token, input)) {\n"
+            "  google::protobuf::uint32 value;\n"
+            "  if (!ReadUInt32(false, &value, input) || value > 1) {\n"
             "    RTN_FALSE;\n"
             "  }\n"
-            "  std::string number;\n"
-            "  if (!ReadNumber(&number, input)) {\n"
+            "} else if (booleans_as_numbers ||\n"
+            "           (token != TOKEN_TRUE && token != TOKEN_FALSE)) {\n"
+            "  RTN_FALSE;\n"
+            "}\n");
+        if (repeated) {
+          cc_printer->Outdent();
+          cc_printer->Print(
+              "  if (!ReadArraySeparator(&token, input)) {\n"
+              "    RTN_FALSE;\n"
+              "  }\n"
+              "  if (token == TOKEN_SQUARE_CLOSE) {\n"
+              "    break;\n"
+              "  }\n"
+              "}\n");
+        }
+      } else if (!repeated) {
+        cc_printer->Print(
+            "if (booleans_as_numbers && token == TOKEN_NUMBER) {\n"
+            "  if (!ReadToken(true, &token, input)) {\n"
             "    RTN_FALSE;\n"
             "  }\n"
-            "  if (number == \"1\") {\n"
-            "    this->set_$name$(true);\n"
-            "  } else if (number == \"0\") {\n"
-            "    this->set_$name$(false);\n"
-            "  } else {\n"
+            "  google::protobuf::uint32 value;\n"
+            "  if (!ReadUInt32(false, &value, input) || value > 1) {\n"
             "    RTN_FALSE;\n"
             "  }\n"
+            "  $store$(value == 1);\n"
             "} else if (!booleans_as_numbers && token == TOKEN_TRUE) {\n"
-            "  this->set_$name$(true);\n"
+            "  $store$(true);\n"
             "} else if (!booleans_as_numbers && token == TOKEN_FALSE) {\n"
-            "  this->set_$name$(false);\n"
+            "  $store$(false);\n"
             "} else {\n"
             "  RTN_FALSE;\n"
             "}\n",
-            "name", field->lowercase_name());
+            "store", store);
       } else {
-        cc_printer.Print(
+        cc_printer->Print(
             "while (true) {\n"
             "  if (!ReadToken(true, &token, input)) {\n"
             "    RTN_FALSE;\n"
@@ -1370,98 +1421,99 @@ bool CodeGenerator::ParsePartialFromZeroCopyJsonStream(
             "  if (token == TOKEN_SQUARE_CLOSE) {\n"
             "    break;\n"
             "  } else if (booleans_as_numbers && token == TOKEN_NUMBER) {\n"
-            "    std::string number;\n"
-            "    if (!ReadNumber(&number, input)) {\n"
-            "      RTN_FALSE;\n"
-            "    }\n"
-            "    if (number == \"1\") {\n"
-            "      this->add_$name$(true);\n"
-            "    } else if (number == \"0\") {\n"
-            "      this->add_$name$(false);\n"
-            "    } else {\n"
+            "    google::protobuf::uint32 value;\n"
+            "    if (!ReadUInt32(false, &value, input) || value > 1) {\n"
             "      RTN_FALSE;\n"
             "    }\n"
+            "    $store$(value == 1);\n"
             "  } else if (!booleans_as_numbers && token == TOKEN_TRUE) {\n"
-            "    this->add_$name$(true);\n"
+            "    $store$(true);\n"
             "  } else if (!booleans_as_numbers && token == TOKEN_FALSE) {\n"
-            "    this->add_$name$(false);\n"
+            "    $store$(false);\n"
             "  } else {\n"
             "    RTN_FALSE;\n"
             "  }\n"
-            "  if (!ReadToken(true, &token, input)) {\n"
+            "  if (!ReadArraySeparator(&token, input)) {\n"
             "    RTN_FALSE;\n"
             "  }\n"
             "  if (token == TOKEN_SQUARE_CLOSE) {\n"
             "    break;\n"
-            "  } else if (token == TOKEN_COMMA) {\n"
-            "    continue;\n"
-            "  } else {\n"
-            "    RTN_FALSE;\n"
             "  }\n"
             "}\n",
-            "name", field->lowercase_name());
+            "store", store);
       }
     } else if (
         field->type() == google::protobuf::FieldDescriptor::TYPE_BYTES ||
         field->type() == google::protobuf::FieldDescriptor::TYPE_STRING) {
-      if (field->label() !=
-          google::protobuf::FieldDescriptor::LABEL_REPEATED) {
-        cc_printer.Print(
+      std::string value =
+          mode == VALIDATE || mode == TRANSCODE_JSON ? "&discarded" : "value";
+      if (!repeated) {
+        cc_printer->Print(
             "if (!ReadToken(true, &token, input) || token != TOKEN_STRING) {\n"
             "  RTN_FALSE;\n"
             "}\n"
-            "{\n"
-            "  std::string value;\n"
-            "  if (!ReadString(&value, input)) {\n"
-            "    RTN_FALSE;\n"
-            "  }\n"
-            "  this->set_$name$(value);\n"
-            "}\n",
-            "name", field->lowercase_name());
+            "{\n");
+        cc_printer->Indent();
+        if (mode == PARSE) {
+          cc_printer->Print(
+              "std::string *value = this->mutable_$name$();\n"
+              "value->clear();\n",
+              "name", field->lowercase_name());
+        }
       } else {
-        cc_printer.Print(
+        cc_printer->Print(
             "while (true) {\n"
             "  if (!ReadToken(true, &token, input)) {\n"
             "    RTN_FALSE;\n"
             "  }\n"
             "  if (token == TOKEN_SQUARE_CLOSE) {\n"
             "    break;\n"
-            "  } else if (token == TOKEN_STRING) {\n"
-            "    std::string value;\n"
-            "    if (!ReadString(&value, input)) {\n"
-            "      RTN_FALSE;\n"
-            "    }\n"
-            "    this->add_$name$(value);\n"
+            "  } else if (token == TOKEN_STRING) {\n");
+        cc_printer->Indent();
+        cc_printer->Indent();
+        if (mode == PARSE) {
+          value = "this->add_" + field->lowercase_name() + "()";
+        }
+      }
+      internal::PrintReadString(value, tag, cc_printer);
+      if (!repeated) {
+        cc_printer->Outdent();
+        cc_printer->Print("}\n");
+      } else {
+        cc_printer->Outdent();
+        cc_printer->Outdent();
+        cc_printer->Print(
             "  } else {\n"
             "    RTN_FALSE;\n"
             "  }\n"
-            "  if (!ReadToken(true, &token, input)) {\n"
+            "  if (!ReadArraySeparator(&token, input)) {\n"
             "    RTN_FALSE;\n"
             "  }\n"
             "  if (token == TOKEN_SQUARE_CLOSE) {\n"
             "    break;\n"
-            "  } else if (token == TOKEN_COMMA) {\n"
-            "    continue;\n"
-            "  } else {\n"
-            "    RTN_FALSE;\n"
             "  }\n"
-            "}\n",
-            "name", field->lowercase_name());
+            "}\n");
       }
-    } else if (
-        field->type() == google::protobuf::FieldDescriptor::TYPE_GROUP ||
-        field->type() == google::protobuf::FieldDescriptor::TYPE_MESSAGE) {
-      if (field->label() !=
-          google::protobuf::FieldDescriptor::LABEL_REPEATED) {
-        cc_printer.Print(
-            "if (!this->mutable_$name$()->"  // no newline
-            "ParsePartialFromZeroCopyJsonStream(type, "  // no newline
-            "booleans_as_numbers, start_index_one, input)) {\n"
-            "  RTN_FALSE;\n"
-            "}\n",
-            "name", field->lowercase_name());
+    } else if (nested) {
+      std::string parse;
+      if (mode == PARSE) {
+        parse = (repeated ? "this->add_" : "this->mutable_") +
+            field->lowercase_name() + "()->ParsePartialFromZeroCopyJsonStream";
+      } else {
+        parse = internal::ClassName(field->message_type()) + "::";
+        if (mode == VALIDATE) {
+          parse += "ValidateZeroCopyJsonStream";
+        } else if (mode == TRANSCODE) {
+          parse += "TranscodeZeroCopyJsonStreamToBinary";
+        } else {
+          parse += "TranscodeZeroCopyJsonStream";
+        }
+      }
+      if (!repeated) {
+        cc_printer->Print("{\n");
+        cc_printer->Indent();
       } else {
-        cc_printer.Print(
+        cc_printer->Print(
             "while (true) {\n"
             "  if (!ReadToken(false, &token, input)) {\n"
             "    RTN_FALSE;\n"
@@ -1471,96 +1523,83 @@ bool CodeGenerator::ParsePartialFromZeroCopyJsonStream(
             "    ReadToken(true, &token, input);\n"
             "    break;\n"
             "  } else if (type == PB_LITE && token == TOKEN_SQUARE_OPEN ||\n"
-            "             type != PB_LITE && token == TOKEN_CURLY_OPEN) {\n"
-            "    if (!this->add_$name$()->"  // no newline
-            "ParsePartialFromZeroCopyJsonStream(type, "  // no newline
-            "booleans_as_numbers, start_index_one, input)) {\n"
-            "      RTN_FALSE;\n"
-            "    }\n"
+            "             type != PB_LITE && token == TOKEN_CURLY_OPEN) {\n");
+        cc_printer->Indent();
+        cc_printer->Indent();
+      }
+      if (mode == TRANSCODE_JSON) {
+        if (repeated) {
+          cc_printer->Print(
+              "if (values.size() != begin) {\n"
+              "  values.push_back(',');\n"
+              "}\n");
+        }
+        cc_printer->Print(
+            "google::protobuf::io::StringOutputStream nested(&values);\n"
+            "if (!$parse$(\n"
+            "        type, booleans_as_numbers, start_index_one, input,\n"
+            "        output_type, output_booleans_as_numbers,\n"
+            "        output_start_index_one, &nested)) {\n"
+            "  RTN_FALSE;\n"
+            "}\n",
+            "parse", parse);
+      } else {
+        internal::PrintReadMessage(parse, tag, end_tag, cc_printer);
+      }
+      if (!repeated) {
+        cc_printer->Outdent();
+        cc_printer->Print("}\n");
+      } else {
+        cc_printer->Outdent();
+        cc_printer->Outdent();
+        cc_printer->Print(
             "  } else {\n"
             "    RTN_FALSE;\n"
             "  }\n"
-            "  if (!ReadToken(true, &token, input)) {\n"
+            "  if (!ReadArraySeparator(&token, input)) {\n"
             "    RTN_FALSE;\n"
             "  }\n"
             "  if (token == TOKEN_SQUARE_CLOSE) {\n"
             "    break;\n"
-            "  } else if (token == TOKEN_COMMA) {\n"
-            "    continue;\n"
-            "  } else {\n"
-            "    RTN_FALSE;\n"
             "  }\n"
-            "}\n",
-            "name", field->lowercase_name());
+            "}\n");
       }
     } else {
-      std::string type = "google::protobuf::int64";
-      std::string format_string = "%ld";
-      std::string type_cast = "&value";
-      std::string number_type = "FromString";
-      if (field->options().GetExtension(jstype)) {
-        number_type = "";
-      }
-      if (field->type() == google::protobuf::FieldDescriptor::TYPE_DOUBLE) {
-        type = "double";
-        format_string = "%lg";
-        number_type = "";
-      } else if (
-          field->type() == google::protobuf::FieldDescriptor::TYPE_FLOAT) {
-        type = "float";
-        format_string = "%g";
-        number_type = "";
-      } else if (
-          field->type() == google::protobuf::FieldDescriptor::TYPE_UINT64 ||
-          field->type() == google::protobuf::FieldDescriptor::TYPE_FIXED64) {
-        type = "google::protobuf::uint64";
-        format_string = "%lu";
-      } else if (
-          field->type() == google::protobuf::FieldDescriptor::TYPE_INT32 ||
-          field->type() == google::protobuf::FieldDescriptor::TYPE_SINT32 ||
-          field->type() == google::protobuf::FieldDescriptor::TYPE_SFIXED32) {
-        type = "google::protobuf::int32";
-        format_string = "%d";
-        number_type = "";
-      } else if (
-          field->type() == google::protobuf::FieldDescriptor::TYPE_UINT32 ||
-          field->type() == google::protobuf::FieldDescriptor::TYPE_FIXED32) {
-        type = "google::protobuf::uint32";
-        format_string = "%u";
-        number_type = "";
-      } else if (
-          field->type() == google::protobuf::FieldDescriptor::TYPE_ENUM) {
-        type = internal::ReplaceAll(
-            ".", "::", field->enum_type()->full_name());
-        format_string = "%d";
-        type_cast = "reinterpret_cast<google::protobuf::int32 *> (&value)";
-        number_type = "";
-      }
-
-      if (field->label() !=
-          google::protobuf::FieldDescriptor::LABEL_REPEATED) {
-        cc_printer.Print(
+      const std::string setter =
+          mode == VALIDATE || mode == TRANSCODE_JSON ? "" : store;
+      if (!repeated) {
+        cc_printer->Print(
             "{\n"
-            "  std::string number;\n"
-            "  if (!ReadNumber$number_type$(&number, input)) {\n"
-            "    RTN_FALSE;\n"
-            "  }\n"
             "  $type$ value;\n",
-            "type", type,
-            "number_type", number_type);
-        cc_printer.Print(
-            "  if (sscanf(number.c_str(),\n"
-            "             \"$format_string$\",\n"
-            "             $type_cast$) != 1) {\n"
-            "    RTN_FALSE;\n"
-            "  }\n"
-            "  this->set_$name$(value);\n"
+            "type", type);
+        cc_printer->Indent();
+        internal::PrintReadNumber(reader, quoted, enum_type, setter,
+                                  cc_printer);
+        cc_printer->Outdent();
+        cc_printer->Print("}\n");
+      } else if (enum_type.empty() &&
+                 reader != "Double" && reader != "Float") {
+        std::string values = "&values";
+        if (mode == PARSE) {
+          values = "this->mutable_" + field->lowercase_name() + "()";
+        } else if (mode == VALIDATE || mode == TRANSCODE_JSON) {
+          values = "static_cast<google::protobuf::RepeatedField<" + type +
+              "> *>(NULL)";
+        }
+        cc_printer->Print(
+            "if (!ReadIntegerArray($quoted$,\n"
+            "                      $signed$,\n"
+            "                      std::numeric_limits<$type$>::max(),\n"
+            "                      $values$,\n"
+            "                      input)) {\n"
+            "  RTN_FALSE;\n"
             "}\n",
-            "name", field->lowercase_name(),
-            "format_string", format_string,
-            "type_cast", type_cast);
+            "quoted", quoted,
+            "signed", reader[0] == 'I' ? "true" : "false",
+            "type", type,
+            "values", values);
       } else {
-        cc_printer.Print(
+        cc_printer->Print(
             "while (true) {\n"
             "  if (!ReadToken(false, &token, input)) {\n"
             "    RTN_FALSE;\n"
@@ -1569,79 +1608,314 @@ bool CodeGenerator::ParsePartialFromZeroCopyJsonStream(
             "    ReadToken(true, &token, input);\n"
             "    break;\n"
             "  } else if (token == TOKEN_NUMBER || token == TOKEN_STRING) {\n"
-            "    std::string number;\n"
-            "    if (!ReadNumber$number_type$(&number, input)) {\n"
-            "      RTN_FALSE;\n"
-            "    }\n"
             "    $type$ value;\n",
-            "type", type,
-            "number_type", number_type);
-        cc_printer.Print(
-            "    if (sscanf(number.c_str(),\n"
-            "               \"$format_string$\",\n"
-            "               $type_cast$) != 1) {\n"
-            "      RTN_FALSE;\n"
-            "    }\n"
-            "    this->add_$name$(value);\n"
+            "type", type);
+        cc_printer->Indent();
+        cc_printer->Indent();
+        internal::PrintReadNumber(reader, quoted, enum_type, setter,
+                                  cc_printer);
+        cc_printer->Outdent();
+        cc_printer->Outdent();
+        cc_printer->Print(
             "  } else {\n"
             "    RTN_FALSE;\n"
             "  }\n"
-            "  if (!ReadToken(true, &token, input)) {\n"
+            "  if (!ReadArraySeparator(&token, input)) {\n"
             "    RTN_FALSE;\n"
             "  }\n"
             "  if (token == TOKEN_SQUARE_CLOSE) {\n"
             "    break;\n"
-            "  } else if (token == TOKEN_COMMA) {\n"
-            "    continue;\n"
-            "  } else {\n"
-            "    RTN_FALSE;\n"
             "  }\n"
-            "}\n",
-            "name", field->lowercase_name(),
-            "format_string", format_string,
-            "type_cast", type_cast);
+            "}\n");
       }
     }
 
-    cc_printer.Print("break;\n");
-    cc_printer.Outdent();
-    cc_printer.Print("\n");
+    if (packed) {
+      cc_printer->Print("EndLengthDelimited(packed_begin, output);\n");
+    }
+    if (mode == TRANSCODE && scalar) {
+      cc_printer->Outdent();
+      cc_printer->Print("}\n");
+    }
+    if (mode == TRANSCODE_JSON) {
+      if (recorded) {
+        cc_printer->Print("recording.Record(NULL);\n");
+      }
+      cc_printer->Print(
+          "AddJsonValue($number$, begin, $elements$, values, &fields);\n",
+          "number", field_number,
+          "elements", recorded && repeated ? "true" : "false");
+      cc_printer->Outdent();
+      cc_printer->Print("}\n");
+    }
+    cc_printer->Print("break;\n");
+    cc_printer->Outdent();
+    cc_printer->Print("\n");
   }
-
-  // TODO(ahochhaus): Deserialize unknown fields.
-
-  cc_printer.Outdent();
+  // Unknown fields are skipped so that newer clients can add fields.
+  cc_printer->Outdent();
   if (message->field_count() > 0) {
-    cc_printer.Print(
+    cc_printer->Print(
         "  default:\n"
-        "    RTN_FALSE;\n"
+        "    if (!SkipValue(token, input)) {\n"
+        "      RTN_FALSE;\n"
+        "    }\n"
         "    break;\n"
         "}\n");
+  } else {
+    cc_printer->Print(
+        "if (!SkipValue(token, input)) {\n"
+        "  RTN_FALSE;\n"
+        "}\n");
   }
-  cc_printer.Outdent();
-  cc_printer.Print(
+  cc_printer->Outdent();
+  cc_printer->Print(
       "}\n"
       "\n");
 
-  cc_printer.Outdent();
-  cc_printer.Print(
-      "  RTN_FALSE;\n"
-      "}\n"
-      "\n"
+  if (mode != TRANSCODE_JSON) {
+    cc_printer->Outdent();
+    cc_printer->Print(
+        "  RTN_FALSE;\n"
+        "}\n"
+        "\n");
+  } else {
+    // The fields are written in the order and format of
+    // SerializePartialToZeroCopyJsonStream(), with the writer's state
+    // prefixed so as not to clash with the parser's.
+    cc_printer->Print("std::stable_sort(fields.begin(), fields.end());\n");
+    if (message->field_count() > 0) {
+      cc_printer->Print(
+          "google::protobuf::uint32 output_cur_field_num =\n"
+          "    output_start_index_one ? 1 : 0;\n"
+          "bool prev_fields = false;\n"
+          "const JsonValue *first;\n"
+          "const JsonValue *last;\n");
+    }
+    cc_printer->Print(
+        "if (!WriteRaw(output_type == PB_LITE ? \"[\" : \"{\", output)) {\n"
+        "  RTN_FALSE;\n"
+        "}\n"
+        "\n");
+    for (int j = 0; j < message->field_count(); ++j) {
+      const google::protobuf::FieldDescriptor *field = message->field(j);
+      char field_number[13];  // ceiling(32/3) + sign char + NULL
+      if (snprintf(field_number,
+                   sizeof(field_number),
+                   "%d",
+                   field->number()) >= 13) {
+        return false;
+      }
+      cc_printer->Print(
+          "// $name$\n"
+          "FindJsonValues(fields, $number$, &first, &last);\n"
+          "if (first != last) {\n",
+          "name", field->lowercase_name(),
+          "number", field_number);
+      cc_printer->Indent();
+      if (!internal::PrintWriteFieldKey(
+              message, field, "output_", cc_printer)) {
+        return false;
+      }
+      cc_printer->Print(
+          "if (!WriteJsonValues(values, first, last, $repeated$, output)) {\n"
+          "  RTN_FALSE;\n"
+          "}\n",
+          "repeated", field->label() ==
+              google::protobuf::FieldDescriptor::LABEL_REPEATED ?
+              "true" : "false");
+      cc_printer->Outdent();
+      cc_printer->Print("}\n"
+                       "\n");
+    }
+    cc_printer->Print(
+        "if (!WriteRaw(output_type == PB_LITE ? \"]\" : \"}\", output)) {\n"
+        "  RTN_FALSE;\n"
+        "}\n"
+        "return true;\n");
+    cc_printer->Outdent();
+    cc_printer->Print(
+        "}\n"
+        "\n");
+  }
+
+  if (cc_printer->failed()) {
+    *error = "CppJsCodeGenerator detected write error.";
+    return false;
+  }
+
+  return true;
+}
+
+bool CodeGenerator::ParseEntryPoints(
+    const google::protobuf::Descriptor *message,
+    const ParseMode mode,
+    google::protobuf::io::Printer *cc_printer,
+    std::string *error) const {
+  const std::string base = message->containing_type() ?
+      message->containing_type()->full_name() + "_" : "";
+  const std::string cc_class_name = base + message->name();
+
+  if (mode == TRANSCODE_JSON) {
+    cc_printer->Print(
+        "bool $name$::TranscodeJsonString(\n"
+        "    const google::protobuf::uint32 type,\n"
+        "    const bool booleans_as_numbers,\n"
+        "    const bool start_index_one,\n"
+        "    const std::string &input,\n"
+        "    const google::protobuf::uint32 output_type,\n"
+        "    const bool output_booleans_as_numbers,\n"
+        "    const bool output_start_index_one,\n"
+        "    std::string *output) {\n"
+        "  google::protobuf::io::ArrayInputStream source(\n"
+        "      input.data(), input.size());\n"
+        "  google::protobuf::io::StringOutputStream target(output);\n"
+        "  return TranscodeZeroCopyJsonStream(\n"
+        "      type, booleans_as_numbers, start_index_one, &source,\n"
+        "      output_type, output_booleans_as_numbers,\n"
+        "      output_start_index_one, &target) &&\n"
+        "         AtEndOfInput(&source);\n"
+        "}\n"
+        "\n",
+        "name", cc_class_name);
+    if (cc_printer->failed()) {
+      *error = "CppJsCodeGenerator detected write error.";
+      return false;
+    }
+    return true;
+  }
+  if (mode == VALIDATE) {
+    cc_printer->Print(
+        "bool $name$::ValidatePbLiteArray(const void *data, int size) {\n"
+        "  google::protobuf::io::ArrayInputStream input(data, size);\n"
+        "  return ValidateZeroCopyJsonStream(PB_LITE, true, false, &input) &&\n"
+        "         AtEndOfInput(&input);\n"
+        "}\n"
+        "\n"
+        "bool $name$::ValidatePbLiteString(const std::string &input) {\n"
+        "  return ValidatePbLiteArray(input.data(), input.size());\n"
+        "}\n"
+        "\n"
+        "bool $name$::ValidatePbLiteZeroIndexArray(\n"
+        "    const void *data, int size) {\n"
+        "  google::protobuf::io::ArrayInputStream input(data, size);\n"
+        "  return ValidateZeroCopyJsonStream(PB_LITE, true, true, &input) &&\n"
+        "         AtEndOfInput(&input);\n"
+        "}\n"
+        "\n"
+        "bool $name$::ValidatePbLiteZeroIndexString(\n"
+        "    const std::string &input) {\n"
+        "  return ValidatePbLiteZeroIndexArray(input.data(), input.size());\n"
+        "}\n"
+        "\n"
+        "bool $name$::ValidateObjectKeyNameArray(\n"
+        "    const void *data, int size) {\n"
+        "  google::protobuf::io::ArrayInputStream input(data, size);\n"
+        "  return ValidateZeroCopyJsonStream(\n"
+        "      OBJECT_KEY_NAME, false, false, &input) &&\n"
+        "         AtEndOfInput(&input);\n"
+        "}\n"
+        "\n"
+        "bool $name$::ValidateObjectKeyNameString(\n"
+        "    const std::string &input) {\n"
+        "  return ValidateObjectKeyNameArray(input.data(), input.size());\n"
+        "}\n"
+        "\n"
+        "bool $name$::ValidateObjectKeyTagArray(\n"
+        "    const void *data, int size) {\n"
+        "  google::protobuf::io::ArrayInputStream input(data, size);\n"
+        "  return ValidateZeroCopyJsonStream(\n"
+        "      OBJECT_KEY_TAG, false, false, &input) &&\n"
+        "         AtEndOfInput(&input);\n"
+        "}\n"
+        "\n"
+        "bool $name$::ValidateObjectKeyTagString(\n"
+        "    const std::string &input) {\n"
+        "  return ValidateObjectKeyTagArray(input.data(), input.size());\n"
+        "}\n"
+        "\n",
+        "name", cc_class_name);
+    if (cc_printer->failed()) {
+      *error = "CppJsCodeGenerator detected write error.";
+      return false;
+    }
+    return true;
+  }
+  if (mode == TRANSCODE) {
+    cc_printer->Print(
+        "bool $name$::TranscodePbLiteStringToBinary(\n"
+        "    const std::string &input, std::string *output) {\n"
+        "  google::protobuf::io::ArrayInputStream source(\n"
+        "      input.data(), input.size());\n"
+        "  return TranscodeZeroCopyJsonStreamToBinary(\n"
+        "      PB_LITE, true, false, &source, output) &&\n"
+        "         AtEndOfInput(&source);\n"
+        "}\n"
+        "\n"
+        "bool $name$::TranscodePbLiteZeroIndexStringToBinary(\n"
+        "    const std::string &input, std::string *output) {\n"
+        "  google::protobuf::io::ArrayInputStream source(\n"
+        "      input.data(), input.size());\n"
+        "  return TranscodeZeroCopyJsonStreamToBinary(\n"
+        "      PB_LITE, true, true, &source, output) &&\n"
+        "         AtEndOfInput(&source);\n"
+        "}\n"
+        "\n"
+        "bool $name$::TranscodeObjectKeyNameStringToBinary(\n"
+        "    const std::string &input, std::string *output) {\n"
+        "  google::protobuf::io::ArrayInputStream source(\n"
+        "      input.data(), input.size());\n"
+        "  return TranscodeZeroCopyJsonStreamToBinary(\n"
+        "      OBJECT_KEY_NAME, false, false, &source, output) &&\n"
+        "         AtEndOfInput(&source);\n"
+        "}\n"
+        "\n"
+        "bool $name$::TranscodeObjectKeyTagStringToBinary(\n"
+        "    const std::string &input, std::string *output) {\n"
+        "  google::protobuf::io::ArrayInputStream source(\n"
+        "      input.data(), input.size());\n"
+        "  return TranscodeZeroCopyJsonStreamToBinary(\n"
+        "      OBJECT_KEY_TAG, false, false, &source, output) &&\n"
+        "         AtEndOfInput(&source);\n"
+        "}\n"
+        "\n",
+        "name", cc_class_name);
+    if (cc_printer->failed()) {
+      *error = "CppJsCodeGenerator detected write error.";
+      return false;
+    }
+    return true;
+  }
+
+  cc_printer->Print(
       "bool $name$::ParsePartialFromPbLiteArray(\n"
       "    const void *data, int size) {\n"
+      "#ifdef CCJS_STRUCTURAL_INDEX_MIN_SIZE\n"
+      "  if (size >= CCJS_STRUCTURAL_INDEX_MIN_SIZE) {\n"
+      "    return ParseWithStructuralIndex(\n"
+      "        this, PB_LITE, true, false, NULL, data, size);\n"
+      "  }\n"
+      "#endif\n"
       "  google::protobuf::io::ArrayInputStream input(\n"
       "      reinterpret_cast<const google::protobuf::uint8 *>(data), size);\n"
       "  return ParsePartialFromZeroCopyJsonStream(\n"
-      "      PB_LITE, true, false, &input);\n"
+      "      PB_LITE, true, false, &input) &&\n"
+      "         AtEndOfInput(&input);\n"
       "}\n"
       "\n"
       "bool $name$::ParsePartialFromPbLiteZeroIndexArray(\n"
       "    const void *data, int size) {\n"
+      "#ifdef CCJS_STRUCTURAL_INDEX_MIN_SIZE\n"
+      "  if (size >= CCJS_STRUCTURAL_INDEX_MIN_SIZE) {\n"
+      "    return ParseWithStructuralIndex(\n"
+      "        this, PB_LITE, true, true, NULL, data, size);\n"
+      "  }\n"
+      "#endif\n"
       "  google::protobuf::io::ArrayInputStream input(\n"
       "      reinterpret_cast<const google::protobuf::uint8 *>(data), size);\n"
       "  return ParsePartialFromZeroCopyJsonStream(\n"
-      "      PB_LITE, true, true, &input);\n"
+      "      PB_LITE, true, true, &input) &&\n"
+      "         AtEndOfInput(&input);\n"
       "}\n"
       "\n"
       "bool $name$::ParsePartialFromPbLiteString(\n"
@@ -1657,10 +1931,17 @@ bool CodeGenerator::ParsePartialFromZeroCopyJsonStream(
       "\n"
       "bool $name$::ParsePartialFromObjectKeyNameArray(\n"
       "    const void *data, int size) {\n"
+      "#ifdef CCJS_STRUCTURAL_INDEX_MIN_SIZE\n"
+      "  if (size >= CCJS_STRUCTURAL_INDEX_MIN_SIZE) {\n"
+      "    return ParseWithStructuralIndex(\n"
+      "        this, OBJECT_KEY_NAME, false, false, NULL, data, size);\n"
+      "  }\n"
+      "#endif\n"
       "  google::protobuf::io::ArrayInputStream input(\n"
       "      reinterpret_cast<const google::protobuf::uint8 *>(data), size);\n"
       "  return ParsePartialFromZeroCopyJsonStream(\n"
-      "      OBJECT_KEY_NAME, false, false, &input);\n"
+      "      OBJECT_KEY_NAME, false, false, &input) &&\n"
+      "         AtEndOfInput(&input);\n"
       "}\n"
       "\n"
       "bool $name$::ParsePartialFromObjectKeyNameString(\n"
@@ -1671,10 +1952,17 @@ bool CodeGenerator::ParsePartialFromZeroCopyJsonStream(
       "\n"
       "bool $name$::ParsePartialFromObjectKeyTagArray(\n"
       "    const void *data, int size) {\n"
+      "#ifdef CCJS_STRUCTURAL_INDEX_MIN_SIZE\n"
+      "  if (size >= CCJS_STRUCTURAL_INDEX_MIN_SIZE) {\n"
+      "    return ParseWithStructuralIndex(\n"
+      "        this, OBJECT_KEY_TAG, false, false, NULL, data, size);\n"
+      "  }\n"
+      "#endif\n"
       "  google::protobuf::io::ArrayInputStream input(\n"
       "      reinterpret_cast<const google::protobuf::uint8 *>(data), size);\n"
       "  return ParsePartialFromZeroCopyJsonStream(\n"
-      "      OBJECT_KEY_TAG, false, false, &input);\n"
+      "      OBJECT_KEY_TAG, false, false, &input) &&\n"
+      "         AtEndOfInput(&input);\n"
       "}\n"
       "\n"
       "bool $name$::ParsePartialFromObjectKeyTagString(\n"
@@ -1682,51 +1970,1305 @@ bool CodeGenerator::ParsePartialFromZeroCopyJsonStream(
       "  return ParsePartialFromObjectKeyTagArray(\n"
       "      output.data(), output.size());\n"
       "}\n"
-      "\n",
-      "name", cc_class_name);
-
-  if (cc_printer.failed()) {
-    *error = "CppJsCodeGenerator detected write error.";
-    return false;
-  }
-
-  return true;
-}
-
-bool CodeGenerator::InstrumentMessage(
-    const std::string &output_h_file_name,
-    const std::string &output_cc_file_name,
-    const google::protobuf::Descriptor *message,
-    google::protobuf::compiler::OutputDirectory *output_directory,
-    std::string *error) const {
-  const std::string class_scope = "class_scope:" + message->full_name();
-  if (!CodeGenerator::HeaderFile(output_h_file_name,
-                                 class_scope,
-                                 output_directory,
-                                 error)) {
-    return false;
-  }
-  if (!CodeGenerator::SerializePartialToZeroCopyJsonStream(
-          output_cc_file_name,
-          message,
-          output_directory,
-          error)) {
-    return false;
-  }
-  if (!CodeGenerator::ParsePartialFromZeroCopyJsonStream(
-          output_cc_file_name,
-          message,
-          output_directory,
-          error)) {
-    return false;
-  }
-
-  for (int i = 0; i < message->nested_type_count(); ++i) {
-    const google::protobuf::Descriptor *sub_message = message->nested_type(i);
-    if (!InstrumentMessage(output_h_file_name,
-                           output_cc_file_name,
-                           sub_message,
-                           output_directory,
+      "\n"
+      "bool $name$::ReparseFromPbLiteArray(\n"
+      "    const void *data, int size) {\n"
+      "  Clear();\n"
+      "  return ParsePartialFromPbLiteArray(data, size);\n"
+      "}\n"
+      "\n"
+      "bool $name$::ReparseFromPbLiteString(\n"
+      "    const std::string &input) {\n"
+      "  return ReparseFromPbLiteArray(input.data(), input.size());\n"
+      "}\n"
+      "\n"
+      "bool $name$::ReparseFromPbLiteZeroIndexArray(\n"
+      "    const void *data, int size) {\n"
+      "  Clear();\n"
+      "  return ParsePartialFromPbLiteZeroIndexArray(data, size);\n"
+      "}\n"
+      "\n"
+      "bool $name$::ReparseFromPbLiteZeroIndexString(\n"
+      "    const std::string &input) {\n"
+      "  return ReparseFromPbLiteZeroIndexArray(input.data(), input.size());\n"
+      "}\n"
+      "\n"
+      "bool $name$::ReparseFromObjectKeyNameArray(\n"
+      "    const void *data, int size) {\n"
+      "  Clear();\n"
+      "  return ParsePartialFromObjectKeyNameArray(data, size);\n"
+      "}\n"
+      "\n"
+      "bool $name$::ReparseFromObjectKeyNameString(\n"
+      "    const std::string &input) {\n"
+      "  return ReparseFromObjectKeyNameArray(input.data(), input.size());\n"
+      "}\n"
+      "\n"
+      "bool $name$::ReparseFromObjectKeyTagArray(\n"
+      "    const void *data, int size) {\n"
+      "  Clear();\n"
+      "  return ParsePartialFromObjectKeyTagArray(data, size);\n"
+      "}\n"
+      "\n"
+      "bool $name$::ReparseFromObjectKeyTagString(\n"
+      "    const std::string &input) {\n"
+      "  return ReparseFromObjectKeyTagArray(input.data(), input.size());\n"
+      "}\n"
+      "\n"
+      "bool $name$::ParsePartialFromPbLiteFile(const char *path) {\n"
+      "  return ParseFile(this, path, PB_LITE, true, false);\n"
+      "}\n"
+      "\n"
+      "bool $name$::ParsePartialFromPbLiteZeroIndexFile(const char *path) {\n"
+      "  return ParseFile(this, path, PB_LITE, true, true);\n"
+      "}\n"
+      "\n"
+      "bool $name$::ParsePartialFromObjectKeyNameFile(const char *path) {\n"
+      "  return ParseFile(this, path, OBJECT_KEY_NAME, false, false);\n"
+      "}\n"
+      "\n"
+      "bool $name$::ParsePartialFromObjectKeyTagFile(const char *path) {\n"
+      "  return ParseFile(this, path, OBJECT_KEY_TAG, false, false);\n"
+      "}\n"
+      "\n"
+      "bool $name$::ParsePartialDelimitedFromZeroCopyJsonStream(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    google::protobuf::io::ZeroCopyInputStream *input,\n"
+      "    bool (*callback)(const $name$ &message, void *arg),\n"
+      "    void *arg) {\n"
+      "  return ParseDelimited(this, type, booleans_as_numbers,\n"
+      "                        start_index_one, input, callback, arg);\n"
+      "}\n"
+      "\n"
+      "bool $name$::ParsePartialFromJsonArrayInParallel(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    const void *data,\n"
+      "    size_t size,\n"
+      "    int thread_count,\n"
+      "    google::protobuf::RepeatedPtrField<$name$> *messages) {\n"
+      "  return ParseArrayOfMessages(type, booleans_as_numbers,\n"
+      "                              start_index_one, data, size,\n"
+      "                              thread_count, messages);\n"
+      "}\n"
+      "\n",
+      "name", cc_class_name);
+
+  if (cc_printer->failed()) {
+    *error = "CppJsCodeGenerator detected write error.";
+    return false;
+  }
+
+  return true;
+}
+
+bool CodeGenerator::TranscodeBinaryToZeroCopyJsonStream(
+    const google::protobuf::Descriptor *message,
+    google::protobuf::io::Printer *cc_printer,
+    std::string *error) const {
+  const std::string base = message->containing_type() ?
+      message->containing_type()->full_name() + "_" : "";
+  const std::string cc_class_name = base + message->name();
+
+  // Fields are written in the order and format of
+  // SerializePartialToZeroCopyJsonStream(), each from the occurrences
+  // that IndexWireFields() found for its number.
+  cc_printer->Print(
+      "bool $name$::TranscodeBinaryToZeroCopyJsonStream(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    const void *data,\n"
+      "    int size,\n"
+      "    google::protobuf::io::ZeroCopyOutputStream *output) {\n",
+      "name", cc_class_name);
+  cc_printer->Indent();
+  cc_printer->Print(
+      "const google::protobuf::uint8 *bytes =\n"
+      "    static_cast<const google::protobuf::uint8 *>(data);\n"
+      "std::vector<WireField> fields;\n"
+      "if (!IndexWireFields(bytes, size, &fields)) {\n"
+      "  RTN_FALSE;\n"
+      "}\n");
+  if (message->field_count()) {
+    cc_printer->Print(
+        "google::protobuf::uint32 cur_field_num = start_index_one ? 1 : 0;\n"
+        "bool prev_fields = false;\n"
+        "const WireField *first;\n"
+        "const WireField *last;\n");
+  }
+  cc_printer->Print(
+      "if (!WriteRaw(type == PB_LITE ? \"[\" : \"{\", output)) {\n"
+      "  RTN_FALSE;\n"
+      "}\n"
+      "\n");
+
+  for (int j = 0; j < message->field_count(); ++j) {
+    const google::protobuf::FieldDescriptor *field = message->field(j);
+    const bool repeated =
+        field->label() == google::protobuf::FieldDescriptor::LABEL_REPEATED;
+
+    char field_number[13];  // ceiling(32/3) + sign char + NULL
+    if (snprintf(
+            field_number, sizeof(field_number), "%d", field->number()) >= 13) {
+      return false;
+    }
+    cc_printer->Print(
+        "// $name$\n"
+        "FindWireFields(fields, $number$, &first, &last);\n"
+        "if (first != last) {\n",
+        "name", field->lowercase_name(),
+        "number", field_number);
+    cc_printer->Indent();
+    if (!internal::PrintWriteFieldKey(message, field, "", cc_printer)) {
+      return false;
+    }
+    if (repeated) {
+      cc_printer->Print(
+          "if (!WriteRaw(\"[\", output)) {\n"
+          "  RTN_FALSE;\n"
+          "}\n");
+    }
+
+    if (field->type() == google::protobuf::FieldDescriptor::TYPE_GROUP ||
+        field->type() == google::protobuf::FieldDescriptor::TYPE_MESSAGE) {
+      const std::string wire_type =
+          field->type() == google::protobuf::FieldDescriptor::TYPE_GROUP ?
+          "WireFormatLite::WIRETYPE_START_GROUP" :
+          "WireFormatLite::WIRETYPE_LENGTH_DELIMITED";
+      if (!repeated) {
+        cc_printer->Print(
+            "std::string merged;\n"
+            "const google::protobuf::uint8 *value;\n"
+            "int value_size;\n"
+            "if (!MergeWireFields(bytes, first, last, $wire_type$,\n"
+            "                     &merged, &value, &value_size) ||\n"
+            "    !$class$::TranscodeBinaryToZeroCopyJsonStream(\n"
+            "        type, booleans_as_numbers, start_index_one,\n"
+            "        value, value_size, output)) {\n"
+            "  RTN_FALSE;\n"
+            "}\n",
+            "wire_type", wire_type,
+            "class", internal::ClassName(field->message_type()));
+      } else {
+        cc_printer->Print(
+            "for (const WireField *field = first; field != last; ++field) {\n"
+            "  if (field->wire_type != $wire_type$ ||\n"
+            "      !$class$::TranscodeBinaryToZeroCopyJsonStream(\n"
+            "          type, booleans_as_numbers, start_index_one,\n"
+            "          bytes + field->begin, field->end - field->begin,\n"
+            "          output)) {\n"
+            "    RTN_FALSE;\n"
+            "  }\n"
+            "  if (field + 1 != last && !WriteRaw(\",\", output)) {\n"
+            "    RTN_FALSE;\n"
+            "  }\n"
+            "}\n",
+            "wire_type", wire_type,
+            "class", internal::ClassName(field->message_type()));
+      }
+    } else if (
+        field->type() == google::protobuf::FieldDescriptor::TYPE_BYTES ||
+        field->type() == google::protobuf::FieldDescriptor::TYPE_STRING) {
+      cc_printer->Print(
+          "for (const WireField *field = $begin$; field != last; ++field) {\n"
+          "  if (field->wire_type !=\n"
+          "          WireFormatLite::WIRETYPE_LENGTH_DELIMITED ||\n"
+          "      !WriteString(\n"
+          "          reinterpret_cast<const char *>(bytes) + field->begin,\n"
+          "          field->end - field->begin, output)) {\n"
+          "    RTN_FALSE;\n"
+          "  }\n"
+          "  if (field + 1 != last && !WriteRaw(\",\", output)) {\n"
+          "    RTN_FALSE;\n"
+          "  }\n"
+          "}\n",
+          "begin", repeated ? "first" : "last - 1");
+    } else {
+      std::string type;
+      std::string reader;
+      std::string quoted;
+      std::string enum_type;
+      internal::NumberReader(field, &type, &reader, &quoted, &enum_type);
+      std::string encoding;
+      int wire_type;
+      internal::WireEncoding(field, &encoding, &wire_type);
+      std::string decode = "static_cast<" + type + ">(bits)";
+      if (field->type() == google::protobuf::FieldDescriptor::TYPE_BOOL) {
+        type = "bool";
+        decode = "bits != 0";
+      } else if (reader == "Float") {
+        decode = "WireFormatLite::DecodeFloat(\n"
+            "    static_cast<google::protobuf::uint32>(bits))";
+      } else if (reader == "Double") {
+        decode = "WireFormatLite::DecodeDouble(bits)";
+      }
+
+      // Repeated fields may also be packed into length-delimited values,
+      // which ReadWireInteger() then reads one value at a time.
+      cc_printer->Print(
+          "bool first_value = true;\n"
+          "for (const WireField *field = $begin$; field != last; ++field) {\n"
+          "  const google::protobuf::uint8 *p = bytes + field->begin;\n"
+          "  if (field->wire_type != WireTypeOf($encoding$)$packed$) {\n"
+          "    RTN_FALSE;\n"
+          "  }\n"
+          "  while (p != bytes + field->end) {\n"
+          "    google::protobuf::uint64 bits;\n"
+          "    if (!ReadWireInteger($encoding$, &p, bytes + field->end,\n"
+          "                         &bits)) {\n"
+          "      RTN_FALSE;\n"
+          "    }\n"
+          "    if (!first_value && !WriteRaw(\",\", output)) {\n"
+          "      RTN_FALSE;\n"
+          "    }\n"
+          "    first_value = false;\n",
+          "begin", repeated ? "first" : "last - 1",
+          "encoding", encoding,
+          "packed", repeated ?
+              " &&\n      field->wire_type != "
+              "WireFormatLite::WIRETYPE_LENGTH_DELIMITED" : "");
+      cc_printer->Indent();
+      cc_printer->Indent();
+      cc_printer->Print(
+          "const $type$ value = $decode$;\n",
+          "type", type,
+          "decode", decode);
+      if (!enum_type.empty()) {
+        cc_printer->Print(
+            "if (!$enum_type$_IsValid(value)) {\n"
+            "  RTN_FALSE;\n"
+            "}\n",
+            "enum_type", enum_type);
+      }
+      if (field->type() == google::protobuf::FieldDescriptor::TYPE_BOOL) {
+        cc_printer->Print(
+            "if (!WriteRaw($value$, output)) {\n"
+            "  RTN_FALSE;\n"
+            "}\n",
+            "value", repeated ? "value ? \"1\" : \"0\"" :
+                "booleans_as_numbers ? (value ? \"1\" : \"0\") :\n"
+                "    (value ? \"true\" : \"false\")");
+      } else {
+        std::string format_string;
+        std::string buffer_size;
+        internal::NumberWriter(field, &format_string, &buffer_size);
+        cc_printer->Print(
+            "char buffer[$buffer_size$];\n"
+            "if (snprintf(buffer, sizeof(buffer), "  // no newline
+            "\"$format$\", value) >= $buffer_size$) {\n"
+            "  RTN_FALSE;\n"
+            "}\n"
+            "if (!WriteRaw(buffer, output)) {\n"
+            "  RTN_FALSE;\n"
+            "}\n",
+            "buffer_size", buffer_size,
+            "format", format_string);
+      }
+      cc_printer->Outdent();
+      cc_printer->Outdent();
+      cc_printer->Print(
+          "  }\n"
+          "}\n");
+    }
+
+    if (repeated) {
+      cc_printer->Print(
+          "if (!WriteRaw(\"]\", output)) {\n"
+          "  RTN_FALSE;\n"
+          "}\n");
+    }
+    cc_printer->Outdent();
+    cc_printer->Print("}\n"
+                     "\n");
+  }
+
+  cc_printer->Print(
+      "if (!WriteRaw(type == PB_LITE ? \"]\" : \"}\", output)) {\n"
+      "  RTN_FALSE;\n"
+      "}\n"
+      "return true;\n");
+  cc_printer->Outdent();
+  cc_printer->Print(
+      "}\n"
+      "\n");
+
+  if (cc_printer->failed()) {
+    *error = "CppJsCodeGenerator detected write error.";
+    return false;
+  }
+
+  return true;
+}
+
+bool CodeGenerator::TranscodeBinaryToStrings(
+    const google::protobuf::Descriptor *message,
+    google::protobuf::io::Printer *cc_printer,
+    std::string *error) const {
+  const std::string base = message->containing_type() ?
+      message->containing_type()->full_name() + "_" : "";
+  const std::string cc_class_name = base + message->name();
+
+  cc_printer->Print(
+      "bool $name$::TranscodeBinaryToPbLiteString(\n"
+      "    const std::string &input, std::string *output) {\n"
+      "  google::protobuf::io::StringOutputStream target(output);\n"
+      "  return TranscodeBinaryToZeroCopyJsonStream(\n"
+      "      PB_LITE, true, false, input.data(), input.size(), &target);\n"
+      "}\n"
+      "\n"
+      "bool $name$::TranscodeBinaryToPbLiteZeroIndexString(\n"
+      "    const std::string &input, std::string *output) {\n"
+      "  google::protobuf::io::StringOutputStream target(output);\n"
+      "  return TranscodeBinaryToZeroCopyJsonStream(\n"
+      "      PB_LITE, true, true, input.data(), input.size(), &target);\n"
+      "}\n"
+      "\n"
+      "bool $name$::TranscodeBinaryToObjectKeyNameString(\n"
+      "    const std::string &input, std::string *output) {\n"
+      "  google::protobuf::io::StringOutputStream target(output);\n"
+      "  return TranscodeBinaryToZeroCopyJsonStream(\n"
+      "      OBJECT_KEY_NAME, false, false, input.data(), input.size(),\n"
+      "      &target);\n"
+      "}\n"
+      "\n"
+      "bool $name$::TranscodeBinaryToObjectKeyTagString(\n"
+      "    const std::string &input, std::string *output) {\n"
+      "  google::protobuf::io::StringOutputStream target(output);\n"
+      "  return TranscodeBinaryToZeroCopyJsonStream(\n"
+      "      OBJECT_KEY_TAG, false, false, input.data(), input.size(),\n"
+      "      &target);\n"
+      "}\n"
+      "\n",
+      "name", cc_class_name);
+
+  if (cc_printer->failed()) {
+    *error = "CppJsCodeGenerator detected write error.";
+    return false;
+  }
+
+  return true;
+}
+
+bool CodeGenerator::ParsePartialFromStructuralIndex(
+    const google::protobuf::Descriptor *message,
+    google::protobuf::io::Printer *cc_printer,
+    std::string *error) const {
+  const std::string base = message->containing_type() ?
+      message->containing_type()->full_name() + "_" : "";
+  const std::string cc_class_name = base + message->name();
+  std::string max_length;
+  if (!internal::MaxFieldNameLength(message, &max_length)) {
+    return false;
+  }
+  std::vector<const google::protobuf::FieldDescriptor *> lazy_fields;
+  internal::LazyFields(message, &lazy_fields);
+
+  cc_printer->Print(
+      "bool $name$::ParsePartialFromStructuralIndex(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    LazySpans *$lazy$,\n"
+      "    const char *data,\n"
+      "    const google::protobuf::uint32 *structurals,\n"
+      "    const size_t structural_count,\n"
+      "    size_t *cursor) {\n"
+      "  const StructuralIndex index = {\n"
+      "      data, structurals, structural_count};\n",
+      "name", cc_class_name,
+      "lazy", lazy_fields.empty() ? "/* lazy */" : "lazy");
+  cc_printer->Print(
+      "  google::protobuf::int32 cur_field_num = 0;\n"
+      "  for (bool first = true; ; first = false) {\n"
+      "    if (type == PB_LITE) {\n"
+      "      if (!IndexPbLiteNextTag(index, first, start_index_one, cursor,\n"
+      "                              &cur_field_num)) {\n"
+      "        RTN_FALSE;\n"
+      "      }\n"
+      "    } else if (type == OBJECT_KEY_NAME) {\n"
+      "      char field_name_buffer[$max_length$];\n"
+      "      const char *field_name;\n"
+      "      int field_name_size;\n"
+      "      if (!IndexObjectKey(index, first, field_name_buffer,\n"
+      "                          sizeof(field_name_buffer), cursor,\n"
+      "                          &field_name, &field_name_size)) {\n"
+      "        RTN_FALSE;\n"
+      "      }\n",
+      "max_length", max_length);
+  cc_printer->Indent();
+  cc_printer->Indent();
+  cc_printer->Indent();
+  if (!internal::PrintFieldNameLookup(message, cc_printer)) {
+    return false;
+  }
+  cc_printer->Outdent();
+  cc_printer->Outdent();
+  cc_printer->Outdent();
+  cc_printer->Print(
+      "    } else if (type == OBJECT_KEY_TAG) {\n"
+      "      if (!IndexObjectKeyTag(index, first, cursor, &cur_field_num)) {\n"
+      "        RTN_FALSE;\n"
+      "      }\n"
+      "    } else {\n"
+      "      RTN_FALSE;\n"
+      "    }\n"
+      "    if (cur_field_num < 0) {\n"
+      "      return true;\n"
+      "    }\n");
+  cc_printer->Indent();
+  cc_printer->Indent();
+  cc_printer->Print("switch (cur_field_num) {\n");
+  cc_printer->Indent();
+
+  for (int j = 0; j < message->field_count(); ++j) {
+    const google::protobuf::FieldDescriptor *field = message->field(j);
+    const bool repeated =
+        field->label() == google::protobuf::FieldDescriptor::LABEL_REPEATED;
+
+    char field_number[13];  // ceiling(32/3) + sign char + NULL
+    if (snprintf(
+            field_number, sizeof(field_number), "%d", field->number()) >= 13) {
+      return false;
+    }
+    cc_printer->Print("// $name$\n"
+                     "case $number$: {\n",
+                     "number", field_number,
+                     "name", field->lowercase_name());
+    cc_printer->Indent();
+
+    if (repeated) {
+      cc_printer->Print(
+          "if (!IndexEnterValue(index, cursor)) {\n"
+          "  RTN_FALSE;\n"
+          "}\n"
+          "this->mutable_$name$()->Reserve(\n"
+          "    this->$name$_size() + IndexCountElements(index, *cursor));\n"
+          "for (bool first_element = true; ; first_element = false) {\n"
+          "  bool more;\n"
+          "  if (!IndexNextElement(index, first_element, cursor, &more)) {\n"
+          "    RTN_FALSE;\n"
+          "  }\n"
+          "  if (!more) {\n"
+          "    break;\n"
+          "  }\n",
+          "name", field->lowercase_name());
+      cc_printer->Indent();
+    }
+    const std::string setter = repeated ? "add" : "set";
+
+    if (field->type() == google::protobuf::FieldDescriptor::TYPE_BOOL) {
+      cc_printer->Print(
+          "bool value;\n"
+          "if (!IndexReadBool(index, booleans_as_numbers, cursor, &value)) {\n"
+          "  RTN_FALSE;\n"
+          "}\n"
+          "this->$setter$_$name$(value);\n",
+          "setter", setter,
+          "name", field->lowercase_name());
+    } else if (
+        field->type() == google::protobuf::FieldDescriptor::TYPE_BYTES ||
+        field->type() == google::protobuf::FieldDescriptor::TYPE_STRING) {
+      cc_printer->Print(
+          "if (!IndexReadString(index, cursor,\n"
+          "                     this->$accessor$_$name$())) {\n"
+          "  RTN_FALSE;\n"
+          "}\n",
+          "accessor", repeated ? "add" : "mutable",
+          "name", field->lowercase_name());
+    } else if (
+        field->type() == google::protobuf::FieldDescriptor::TYPE_GROUP ||
+        field->type() == google::protobuf::FieldDescriptor::TYPE_MESSAGE) {
+      if (!repeated) {
+        cc_printer->Print(
+            "if (lazy != NULL) {\n"
+            "  const char *span;\n"
+            "  int span_size;\n"
+            "  if (!IndexEnterValue(index, cursor) ||\n"
+            "      !IndexSkipNested(index, cursor, &span, &span_size)) {\n"
+            "    RTN_FALSE;\n"
+            "  }\n"
+            "  lazy->Record($number$, span, span_size);\n"
+            "  break;\n"
+            "}\n",
+            "number", field_number);
+      }
+      cc_printer->Print(
+          "if (!IndexEnterValue(index, cursor) ||\n"
+          "    !this->$accessor$_$name$()->ParsePartialFromStructuralIndex(\n"
+          "        type, booleans_as_numbers, start_index_one, NULL,\n"
+          "        data, structurals, structural_count, cursor)) {\n"
+          "  RTN_FALSE;\n"
+          "}\n",
+          "accessor", repeated ? "add" : "mutable",
+          "name", field->lowercase_name());
+    } else {
+      std::string type;
+      std::string reader;
+      std::string quoted;
+      std::string enum_type;
+      internal::NumberReader(field, &type, &reader, &quoted, &enum_type);
+      cc_printer->Print(
+          "const char *span;\n"
+          "int span_size;\n"
+          "if (!IndexValueSpan(index, $quoted$, cursor, &span, &span_size)) {\n"
+          "  RTN_FALSE;\n"
+          "}\n"
+          "google::protobuf::io::ArrayInputStream span_input(\n"
+          "    span, span_size);\n"
+          "google::protobuf::io::ZeroCopyInputStream *input = &span_input;\n"
+          "$type$ value;\n",
+          "quoted", quoted,
+          "type", type);
+      internal::PrintReadNumber(
+          reader, quoted, enum_type,
+          "this->" + setter + "_" + field->lowercase_name(), cc_printer);
+    }
+
+    if (repeated) {
+      cc_printer->Outdent();
+      cc_printer->Print("}\n");
+    }
+    cc_printer->Print("break;\n");
+    cc_printer->Outdent();
+    cc_printer->Print(
+        "}\n"
+        "\n");
+  }
+
+  cc_printer->Outdent();
+  cc_printer->Print(
+      "  default:\n"
+      "    if (!IndexSkipValue(index, cursor)) {\n"
+      "      RTN_FALSE;\n"
+      "    }\n"
+      "    break;\n"
+      "}\n");
+  cc_printer->Outdent();
+  cc_printer->Outdent();
+  cc_printer->Print(
+      "  }\n"
+      "}\n"
+      "\n");
+
+  if (cc_printer->failed()) {
+    *error = "CppJsCodeGenerator detected write error.";
+    return false;
+  }
+
+  return true;
+}
+
+bool CodeGenerator::LazyViewClass(
+    const google::protobuf::Descriptor *message,
+    google::protobuf::io::Printer *h_printer,
+    std::string *error) const {
+  std::vector<const google::protobuf::FieldDescriptor *> lazy_fields;
+  internal::LazyFields(message, &lazy_fields);
+  if (lazy_fields.empty()) {
+    return true;
+  }
+  std::string class_name = message->full_name();
+  if (!message->file()->package().empty()) {
+    class_name = class_name.substr(message->file()->package().size() + 1);
+  }
+  class_name = internal::ReplaceAll(".", "_", class_name);
+
+  h_printer->Print(
+      "// The Parse*() variants clear the message and parse data into it,\n"
+      "// skipping over the singular message fields. data must outlive the\n"
+      "// view. lazy_<field>() parses a skipped field into the message on\n"
+      "// first access and returns NULL, now and later, if it is invalid.\n"
+      "// message() holds the fields parsed so far, call ParseLazyFields()\n"
+      "// before reading it whole.\n"
+      "class $class$::LazyView {\n"
+      " public:\n"
+      "  LazyView();\n"
+      "  ~LazyView();\n"
+      "\n"
+      "  bool ParsePartialFromPbLiteArray(const void *data, int size);\n"
+      "\n"
+      "  bool ParsePartialFromPbLiteZeroIndexArray(\n"
+      "      const void *data, int size);\n"
+      "\n"
+      "  bool ParsePartialFromObjectKeyNameArray(const void *data, int size);\n"
+      "\n"
+      "  bool ParsePartialFromObjectKeyTagArray(const void *data, int size);\n"
+      "\n",
+      "class", class_name);
+  for (size_t i = 0; i < lazy_fields.size(); ++i) {
+    h_printer->Print(
+        "  const $type$ *lazy_$field$();\n"
+        "\n",
+        "type", internal::ClassName(lazy_fields[i]->message_type()),
+        "field", lazy_fields[i]->lowercase_name());
+  }
+  h_printer->Print(
+      "  bool ParseLazyFields();\n"
+      "\n"
+      "  const $class$ &message() const;\n"
+      "\n"
+      " private:\n"
+      "  bool Parse(const google::protobuf::uint32 type,\n"
+      "             const bool booleans_as_numbers,\n"
+      "             const bool start_index_one,\n"
+      "             const void *data,\n"
+      "             int size);\n"
+      "\n"
+      "  $class$ message_;\n"
+      "  ::sg::protobuf::ccjs::runtime::LazySpans *spans_;\n"
+      "\n"
+      "  LazyView(const LazyView &);\n"
+      "  void operator=(const LazyView &);\n"
+      "};\n"
+      "\n",
+      "class", class_name);
+
+  if (h_printer->failed()) {
+    *error = "CppJsCodeGenerator detected write error.";
+    return false;
+  }
+
+  return true;
+}
+
+bool CodeGenerator::LazyParseFunctions(
+    const google::protobuf::Descriptor *message,
+    google::protobuf::io::Printer *cc_printer,
+    std::string *error) const {
+  const std::string base = message->containing_type() ?
+      message->containing_type()->full_name() + "_" : "";
+  const std::string cc_class_name = base + message->name();
+  std::vector<const google::protobuf::FieldDescriptor *> lazy_fields;
+  internal::LazyFields(message, &lazy_fields);
+  if (lazy_fields.empty()) {
+    return true;
+  }
+
+  cc_printer->Print(
+      "$name$::LazyView::LazyView()\n"
+      "    : spans_(new LazySpans) {\n"
+      "}\n"
+      "\n"
+      "$name$::LazyView::~LazyView() {\n"
+      "  delete spans_;\n"
+      "}\n"
+      "\n"
+      "bool $name$::LazyView::ParsePartialFromPbLiteArray(\n"
+      "    const void *data, int size) {\n"
+      "  return Parse(PB_LITE, true, false, data, size);\n"
+      "}\n"
+      "\n"
+      "bool $name$::LazyView::ParsePartialFromPbLiteZeroIndexArray(\n"
+      "    const void *data, int size) {\n"
+      "  return Parse(PB_LITE, true, true, data, size);\n"
+      "}\n"
+      "\n"
+      "bool $name$::LazyView::ParsePartialFromObjectKeyNameArray(\n"
+      "    const void *data, int size) {\n"
+      "  return Parse(OBJECT_KEY_NAME, false, false, data, size);\n"
+      "}\n"
+      "\n"
+      "bool $name$::LazyView::ParsePartialFromObjectKeyTagArray(\n"
+      "    const void *data, int size) {\n"
+      "  return Parse(OBJECT_KEY_TAG, false, false, data, size);\n"
+      "}\n"
+      "\n"
+      "bool $name$::LazyView::Parse(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    const void *data,\n"
+      "    int size) {\n"
+      "  message_.Clear();\n"
+      "  spans_->Reset(type, booleans_as_numbers, start_index_one);\n"
+      "  return ParseWithStructuralIndex(\n"
+      "      &message_, type, booleans_as_numbers, start_index_one, spans_,\n"
+      "      data, size);\n"
+      "}\n"
+      "\n",
+      "name", cc_class_name);
+  for (size_t i = 0; i < lazy_fields.size(); ++i) {
+    char field_number[13];  // ceiling(32/3) + sign char + NULL
+    if (snprintf(field_number, sizeof(field_number), "%d",
+                 lazy_fields[i]->number()) >= 13) {
+      return false;
+    }
+    cc_printer->Print(
+        "const $type$ *$name$::LazyView::lazy_$field$() {\n"
+        "  if (spans_->Pending($number$) &&\n"
+        "      !spans_->Parse($number$, message_.mutable_$field$())) {\n"
+        "    return NULL;\n"
+        "  }\n"
+        "  return &message_.$field$();\n"
+        "}\n"
+        "\n",
+        "type", internal::ClassName(lazy_fields[i]->message_type()),
+        "name", cc_class_name,
+        "field", lazy_fields[i]->lowercase_name(),
+        "number", field_number);
+  }
+  cc_printer->Print(
+      "bool $name$::LazyView::ParseLazyFields() {\n",
+      "name", cc_class_name);
+  for (size_t i = 0; i < lazy_fields.size(); ++i) {
+    cc_printer->Print(
+        "  if (lazy_$field$() == NULL) {\n"
+        "    RTN_FALSE;\n"
+        "  }\n",
+        "field", lazy_fields[i]->lowercase_name());
+  }
+  cc_printer->Print(
+      "  return true;\n"
+      "}\n"
+      "\n"
+      "const $name$ &$name$::LazyView::message() const {\n"
+      "  return message_;\n"
+      "}\n"
+      "\n",
+      "name", cc_class_name);
+
+  if (cc_printer->failed()) {
+    *error = "CppJsCodeGenerator detected write error.";
+    return false;
+  }
+
+  return true;
+}
+
+bool CodeGenerator::PushParserClass(
+    const google::protobuf::Descriptor *message,
+    google::protobuf::io::Printer *cc_printer,
+    std::string *error) const {
+  const std::string base = message->containing_type() ?
+      message->containing_type()->full_name() + "_" : "";
+  const std::string cc_class_name = base + message->name();
+
+  cc_printer->Print(
+      "struct $name$::PushParser::State : public PushState {\n"
+      "};\n"
+      "\n"
+      "$name$::PushParser::PushParser(\n"
+      "    $name$ *message,\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one)\n"
+      "    : state_(new State) {\n"
+      "  PushStart(state_, message, &PushStep<$name$>, type,\n"
+      "            booleans_as_numbers, start_index_one);\n"
+      "}\n"
+      "\n"
+      "$name$::PushParser::~PushParser() {\n"
+      "  delete state_;\n"
+      "}\n"
+      "\n"
+      "bool $name$::PushParser::Feed(const char *data, size_t size) {\n"
+      "  return PushFeed(state_, data, size);\n"
+      "}\n"
+      "\n"
+      "bool $name$::PushParser::Finish() {\n"
+      "  return PushFinish(state_);\n"
+      "}\n"
+      "\n",
+      "name", cc_class_name);
+
+  if (cc_printer->failed()) {
+    *error = "CppJsCodeGenerator detected write error.";
+    return false;
+  }
+
+  return true;
+}
+
+bool CodeGenerator::PushParseStep(
+    const google::protobuf::Descriptor *message,
+    google::protobuf::io::Printer *cc_printer,
+    std::string *error) const {
+  const std::string base = message->containing_type() ?
+      message->containing_type()->full_name() + "_" : "";
+  const std::string cc_class_name = base + message->name();
+  std::string max_length;
+  if (!internal::MaxFieldNameLength(message, &max_length)) {
+    return false;
+  }
+
+  cc_printer->Print(
+      "bool $name$::PushParseStep(\n"
+      "    const int event,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const char *text,\n"
+      "    const int text_size,\n"
+      "    google::protobuf::int32 *field_num,\n"
+      "    int *kind,\n"
+      "    void **$child$,\n"
+      "    void *$child_step$) {\n"
+      "  if (event == PUSH_KEY) {\n"
+      "    char field_name[$max_length$];\n"
+      "    int field_name_size;\n"
+      "    google::protobuf::io::ArrayInputStream key(\n"
+      "        text + 1, text_size - 1);\n"
+      "    if (!ReadObjectKeyChars(field_name, sizeof(field_name),\n"
+      "                            &field_name_size, &key) ||\n"
+      "        key.ByteCount() != text_size - 1) {\n"
+      "      RTN_FALSE;\n"
+      "    }\n"
+      "    google::protobuf::int32 cur_field_num;\n",
+      "name", cc_class_name,
+      "max_length", max_length,
+      "child", internal::HasMessageField(message) ? "child" : "/* child */",
+      "child_step",
+      internal::HasMessageField(message) ? "child_step" : "/* child_step */");
+  cc_printer->Indent();
+  cc_printer->Indent();
+  if (!internal::PrintFieldNameLookup(message, cc_printer)) {
+    return false;
+  }
+  cc_printer->Outdent();
+  cc_printer->Outdent();
+  cc_printer->Print(
+      "    *field_num = cur_field_num;\n"
+      "    return true;\n"
+      "  }\n"
+      "  *kind = PUSH_UNKNOWN;\n");
+  cc_printer->Indent();
+  if (message->field_count() > 0) {
+    cc_printer->Print("switch (*field_num) {\n");
+  }
+  cc_printer->Indent();
+
+  for (int j = 0; j < message->field_count(); ++j) {
+    const google::protobuf::FieldDescriptor *field = message->field(j);
+    const bool repeated =
+        field->label() == google::protobuf::FieldDescriptor::LABEL_REPEATED;
+
+    char field_number[13];  // ceiling(32/3) + sign char + NULL
+    if (snprintf(
+            field_number, sizeof(field_number), "%d", field->number()) >= 13) {
+      return false;
+    }
+    cc_printer->Print("// $name$\n"
+                     "case $number$: {\n",
+                     "number", field_number,
+                     "name", field->lowercase_name());
+    cc_printer->Indent();
+
+    if (field->type() == google::protobuf::FieldDescriptor::TYPE_GROUP ||
+        field->type() == google::protobuf::FieldDescriptor::TYPE_MESSAGE) {
+      if (repeated) {
+        cc_printer->Print(
+            "if (event == PUSH_OPEN) {\n"
+            "  *kind = PUSH_ARRAY;\n"
+            "  return true;\n"
+            "} else if (event != PUSH_OPEN_ELEMENT) {\n"
+            "  RTN_FALSE;\n"
+            "}\n"
+            "*child = this->add_$name$();\n",
+            "name", field->lowercase_name());
+      } else {
+        cc_printer->Print(
+            "if (event != PUSH_OPEN) {\n"
+            "  RTN_FALSE;\n"
+            "}\n"
+            "*child = this->mutable_$name$();\n",
+            "name", field->lowercase_name());
+      }
+      cc_printer->Print(
+          "*kind = PUSH_MESSAGE;\n"
+          "*static_cast<PushStepFunction *>(child_step) =\n"
+          "    &PushStep<$type$>;\n"
+          "return true;\n",
+          "type", internal::ClassName(field->message_type()));
+    } else {
+      if (repeated) {
+        cc_printer->Print(
+            "if (event == PUSH_OPEN) {\n"
+            "  *kind = PUSH_ARRAY;\n"
+            "  return true;\n"
+            "} else if (event != PUSH_VALUE_ELEMENT) {\n"
+            "  RTN_FALSE;\n"
+            "}\n");
+      } else {
+        cc_printer->Print(
+            "if (event != PUSH_VALUE) {\n"
+            "  RTN_FALSE;\n"
+            "}\n");
+      }
+      const std::string setter = repeated ? "add" : "set";
+      cc_printer->Print(
+          "google::protobuf::io::ArrayInputStream value_input(\n"
+          "    text, text_size);\n"
+          "google::protobuf::io::ZeroCopyInputStream *input = &value_input;\n");
+      if (field->type() == google::protobuf::FieldDescriptor::TYPE_BOOL) {
+        cc_printer->Print(
+            "if (booleans_as_numbers) {\n"
+            "  google::protobuf::uint32 value;\n"
+            "  if (!ReadUInt32(false, &value, input) || value > 1) {\n"
+            "    RTN_FALSE;\n"
+            "  }\n"
+            "  this->$setter$_$name$(value == 1);\n"
+            "} else if (text_size == 5 && memcmp(text, \"true\", 4) == 0) {\n"
+            "  this->$setter$_$name$(true);\n"
+            "  return true;\n"
+            "} else if (text_size == 6 && memcmp(text, \"false\", 5) == 0) {\n"
+            "  this->$setter$_$name$(false);\n"
+            "  return true;\n"
+            "} else {\n"
+            "  RTN_FALSE;\n"
+            "}\n",
+            "setter", setter,
+            "name", field->lowercase_name());
+      } else if (
+          field->type() == google::protobuf::FieldDescriptor::TYPE_BYTES ||
+          field->type() == google::protobuf::FieldDescriptor::TYPE_STRING) {
+        cc_printer->Print(
+            "Token token;\n"
+            "std::string *value = this->$accessor$_$name$();\n"
+            "value->clear();\n"
+            "if (!ReadToken(true, &token, input) || token != TOKEN_STRING ||\n"
+            "    !ReadString(value, input)) {\n"
+            "  RTN_FALSE;\n"
+            "}\n",
+            "accessor", repeated ? "add" : "mutable",
+            "name", field->lowercase_name());
+      } else {
+        std::string type;
+        std::string reader;
+        std::string quoted;
+        std::string enum_type;
+        internal::NumberReader(field, &type, &reader, &quoted, &enum_type);
+        cc_printer->Print("$type$ value;\n", "type", type);
+        internal::PrintReadNumber(
+            reader, quoted, enum_type,
+            "this->" + setter + "_" + field->lowercase_name(), cc_printer);
+      }
+      cc_printer->Print(
+          "// Only the terminator may be left.\n"
+          "return value_input.ByteCount() == text_size - 1;\n");
+    }
+    cc_printer->Outdent();
+    cc_printer->Print("}\n");
+  }
+
+  cc_printer->Outdent();
+  if (message->field_count() > 0) {
+    cc_printer->Print("}\n");
+  }
+  cc_printer->Outdent();
+  cc_printer->Print(
+      "  // Unknown fields are skipped.\n"
+      "  return true;\n"
+      "}\n"
+      "\n");
+
+  if (cc_printer->failed()) {
+    *error = "CppJsCodeGenerator detected write error.";
+    return false;
+  }
+
+  return true;
+}
+
+bool CodeGenerator::CompactFunctions(
+    const google::protobuf::Descriptor *message,
+    google::protobuf::io::Printer *cc_printer,
+    std::string *error) const {
+  const std::string base = message->containing_type() ?
+      message->containing_type()->full_name() + "_" : "";
+  const std::string cc_class_name = base + message->name();
+  const std::string table = internal::ReplaceAll(".", "_", cc_class_name) +
+      "_compact";
+  std::string max_length;
+  if (!internal::MaxFieldNameLength(message, &max_length)) {
+    return false;
+  }
+
+  cc_printer->Print("namespace {\n\n");
+  if (message->field_count() > 0) {
+    cc_printer->Print(
+        "const CompactField $table$_fields[] = {\n",
+        "table", table);
+    cc_printer->Indent();
+    for (int i = 0; i < message->field_count(); ++i) {
+      const google::protobuf::FieldDescriptor *field = message->field(i);
+      char number[13];  // ceiling(32/3) + sign char + NULL
+      if (snprintf(number, sizeof(number), "%d", field->number()) >= 13) {
+        return false;
+      }
+      const bool repeated = field->label() ==
+          google::protobuf::FieldDescriptor::LABEL_REPEATED;
+      const bool quoted =
+          (field->cpp_type() ==
+               google::protobuf::FieldDescriptor::CPPTYPE_INT64 ||
+           field->cpp_type() ==
+               google::protobuf::FieldDescriptor::CPPTYPE_UINT64) &&
+          !field->options().GetExtension(jstype);
+      std::string enum_is_valid = "NULL";
+      if (field->type() == google::protobuf::FieldDescriptor::TYPE_ENUM) {
+        const google::protobuf::EnumDescriptor *enum_type =
+            field->enum_type();
+        if (enum_type->containing_type() != NULL) {
+          enum_is_valid = "&" +
+              internal::ClassName(enum_type->containing_type()) + "::" +
+              enum_type->name() + "_IsValid";
+        } else {
+          enum_is_valid = "&" + internal::ReplaceAll(
+              ".", "::", "::" + enum_type->full_name()) + "_IsValid";
+        }
+      }
+      std::string calls = "NULL";
+      if (field->type() == google::protobuf::FieldDescriptor::TYPE_GROUP ||
+          field->type() == google::protobuf::FieldDescriptor::TYPE_MESSAGE) {
+        calls = "&CompactCalls< " +
+            internal::ClassName(field->message_type()) + " >::calls";
+      }
+      std::string type = field->type_name();
+      std::transform(type.begin(), type.end(), type.begin(), ::toupper);
+      cc_printer->Print(
+          "{$number$, \"$field$\",\n"
+          " google::protobuf::FieldDescriptor::TYPE_$type$,\n"
+          " $repeated$, $quoted$, $enum_is_valid$,\n"
+          " $calls$},\n",
+          "number", number,
+          "field", field->name(),
+          "type", type,
+          "repeated", repeated ? "true" : "false",
+          "quoted", quoted ? "true" : "false",
+          "enum_is_valid", enum_is_valid,
+          "calls", calls);
+    }
+    cc_printer->Outdent();
+    cc_printer->Print("};\n\n");
+  }
+  char field_count[13];  // ceiling(32/3) + sign char + NULL
+  if (snprintf(field_count,
+               sizeof(field_count),
+               "%d",
+               message->field_count()) >= 13) {
+    return false;
+  }
+  cc_printer->Print(
+      "const CompactMessage $table$ = {\n"
+      "  $fields$, $count$, $max_length$\n"
+      "};\n"
+      "\n"
+      "}  // namespace\n"
+      "\n",
+      "table", table,
+      "fields", message->field_count() > 0 ? table + "_fields" : "NULL",
+      "count", field_count,
+      "max_length", max_length);
+
+  cc_printer->Print(
+      "bool $name$::SerializePartialToZeroCopyJsonStream(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    google::protobuf::io::ZeroCopyOutputStream *output) const {\n"
+      "  return CompactSerialize($table$, *this, type, booleans_as_numbers,\n"
+      "                          start_index_one, output);\n"
+      "}\n"
+      "\n"
+      "bool $name$::ParsePartialFromZeroCopyJsonStream(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    google::protobuf::io::ZeroCopyInputStream *input) {\n"
+      "  return CompactParse($table$, this, type, booleans_as_numbers,\n"
+      "                      start_index_one, input);\n"
+      "}\n"
+      "\n"
+      "bool $name$::ValidateZeroCopyJsonStream(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    google::protobuf::io::ZeroCopyInputStream *input) {\n"
+      "  return CompactParse($table$, NULL, type, booleans_as_numbers,\n"
+      "                      start_index_one, input);\n"
+      "}\n"
+      "\n"
+      "bool $name$::TranscodeZeroCopyJsonStreamToBinary(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    google::protobuf::io::ZeroCopyInputStream *input,\n"
+      "    std::string *output) {\n"
+      "  $name$ message;\n"
+      "  return CompactParse($table$, &message, type, booleans_as_numbers,\n"
+      "                      start_index_one, input) &&\n"
+      "         message.AppendPartialToString(output);\n"
+      "}\n"
+      "\n"
+      "bool $name$::TranscodeZeroCopyJsonStream(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    google::protobuf::io::ZeroCopyInputStream *input,\n"
+      "    const google::protobuf::uint32 output_type,\n"
+      "    const bool output_booleans_as_numbers,\n"
+      "    const bool output_start_index_one,\n"
+      "    google::protobuf::io::ZeroCopyOutputStream *output) {\n"
+      "  $name$ message;\n"
+      "  return CompactParse($table$, &message, type, booleans_as_numbers,\n"
+      "                      start_index_one, input) &&\n"
+      "         CompactSerialize($table$, message, output_type,\n"
+      "                          output_booleans_as_numbers,\n"
+      "                          output_start_index_one, output);\n"
+      "}\n"
+      "\n"
+      "bool $name$::TranscodeBinaryToZeroCopyJsonStream(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    const void *data,\n"
+      "    int size,\n"
+      "    google::protobuf::io::ZeroCopyOutputStream *output) {\n"
+      "  $name$ message;\n"
+      "  return CompactTranscodeBinary($table$, &message, type,\n"
+      "                                booleans_as_numbers, start_index_one,\n"
+      "                                data, size, output);\n"
+      "}\n"
+      "\n"
+      "bool $name$::ParsePartialFromStructuralIndex(\n"
+      "    const google::protobuf::uint32 type,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const bool start_index_one,\n"
+      "    LazySpans * /* lazy */,\n"
+      "    const char *data,\n"
+      "    const google::protobuf::uint32 *structurals,\n"
+      "    const size_t structural_count,\n"
+      "    size_t *cursor) {\n"
+      "  return CompactParseStructuralIndex(\n"
+      "      $table$, this, type, booleans_as_numbers, start_index_one,\n"
+      "      data, structurals, structural_count, cursor);\n"
+      "}\n"
+      "\n"
+      "bool $name$::PushParseStep(\n"
+      "    const int event,\n"
+      "    const bool booleans_as_numbers,\n"
+      "    const char *text,\n"
+      "    const int text_size,\n"
+      "    google::protobuf::int32 *field_num,\n"
+      "    int *kind,\n"
+      "    void **child,\n"
+      "    void *child_step) {\n"
+      "  return CompactPushParseStep($table$, this, event,\n"
+      "                              booleans_as_numbers, text, text_size,\n"
+      "                              field_num, kind, child, child_step);\n"
+      "}\n"
+      "\n",
+      "name", cc_class_name,
+      "table", table);
+
+  if (cc_printer->failed()) {
+    *error = "CppJsCodeGenerator detected write error.";
+    return false;
+  }
+
+  return true;
+}
+
+bool CodeGenerator::InstrumentMessage(
+    const std::string &output_h_file_name,
+    const google::protobuf::Descriptor *message,
+    const bool code_size,
+    google::protobuf::compiler::OutputDirectory *output_directory,
+    google::protobuf::io::Printer *h_printer,
+    google::protobuf::io::Printer *cc_printer,
+    std::string *error) const {
+  if (!CodeGenerator::HeaderFile(output_h_file_name,
+                                 message,
+                                 output_directory,
+                                 error) ||
+      !CodeGenerator::LazyViewClass(message, h_printer, error)) {
+    return false;
+  }
+  if (code_size) {
+    if (!CodeGenerator::CompactFunctions(message, cc_printer, error) ||
+        !CodeGenerator::SerializePartialToStrings(
+            message, cc_printer, error) ||
+        !CodeGenerator::ParseEntryPoints(
+            message, PARSE, cc_printer, error) ||
+        !CodeGenerator::ParseEntryPoints(
+            message, VALIDATE, cc_printer, error) ||
+        !CodeGenerator::ParseEntryPoints(
+            message, TRANSCODE, cc_printer, error) ||
+        !CodeGenerator::ParseEntryPoints(
+            message, TRANSCODE_JSON, cc_printer, error) ||
+        !CodeGenerator::TranscodeBinaryToStrings(
+            message, cc_printer, error) ||
+        !CodeGenerator::LazyParseFunctions(message, cc_printer, error) ||
+        !CodeGenerator::PushParserClass(message, cc_printer, error)) {
+      return false;
+    }
+  } else {
+    if (!CodeGenerator::SerializePartialToZeroCopyJsonStream(
+            message,
+            cc_printer,
+            error) ||
+        !CodeGenerator::SerializePartialToStrings(
+            message,
+            cc_printer,
+            error)) {
+      return false;
+    }
+    const ParseMode modes[] = {PARSE, VALIDATE, TRANSCODE, TRANSCODE_JSON};
+    for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); ++i) {
+      if (!CodeGenerator::ParsePartialFromZeroCopyJsonStream(
+              message,
+              modes[i],
+              cc_printer,
+              error) ||
+          !CodeGenerator::ParseEntryPoints(
+              message,
+              modes[i],
+              cc_printer,
+              error)) {
+        return false;
+      }
+    }
+    if (!CodeGenerator::TranscodeBinaryToZeroCopyJsonStream(
+            message,
+            cc_printer,
+            error) ||
+        !CodeGenerator::TranscodeBinaryToStrings(
+            message,
+            cc_printer,
+            error)) {
+      return false;
+    }
+    if (!CodeGenerator::ParsePartialFromStructuralIndex(
+            message,
+            cc_printer,
+            error) ||
+        !CodeGenerator::LazyParseFunctions(
+            message,
+            cc_printer,
+            error)) {
+      return false;
+    }
+    if (!CodeGenerator::PushParserClass(
+            message,
+            cc_printer,
+            error) ||
+        !CodeGenerator::PushParseStep(
+            message,
+            cc_printer,
+            error)) {
+      return false;
+    }
+  }
+
+  for (int i = 0; i < message->nested_type_count(); ++i) {
+    const google::protobuf::Descriptor *sub_message = message->nested_type(i);
+    if (!InstrumentMessage(output_h_file_name,
+                           sub_message,
+                           code_size,
+                           output_directory,
+                           h_printer,
+                           cc_printer,
                            error)) {
       return false;
     }
@@ -1737,9 +3279,36 @@ bool CodeGenerator::InstrumentMessage(
 
 bool CodeGenerator::Generate(
     const google::protobuf::FileDescriptor *file,
-    const std::string &/* parameter */,
+    const std::string &parameter,
     google::protobuf::compiler::OutputDirectory *output_directory,
     std::string *error) const {
+  // optimize_for=code_size (or the file option optimize_for = CODE_SIZE,
+  // unless overridden with optimize_for=speed) selects the table-driven
+  // code, which needs the reflection of the full runtime and
+  // ccjs_compact.h.
+  bool code_size = file->options().optimize_for() ==
+      google::protobuf::FileOptions::CODE_SIZE;
+  std::vector<std::pair<std::string, std::string> > options;
+  google::protobuf::compiler::ParseGeneratorParameter(parameter, &options);
+  for (size_t i = 0; i < options.size(); ++i) {
+    if (options[i].first == "optimize_for" &&
+        options[i].second == "code_size") {
+      code_size = true;
+    } else if (options[i].first == "optimize_for" &&
+               options[i].second == "speed") {
+      code_size = false;
+    } else {
+      *error = "Unknown generator option: " + options[i].first;
+      if (!options[i].second.empty()) {
+        *error += "=" + options[i].second;
+      }
+      return false;
+    }
+  }
+  if (file->options().optimize_for() ==
+      google::protobuf::FileOptions::LITE_RUNTIME) {
+    code_size = false;
+  }
 
   std::string output_h_file_name = file->name();
   std::size_t loc = output_h_file_name.rfind(".");
@@ -1749,18 +3318,56 @@ bool CodeGenerator::Generate(
   output_cc_file_name.append(".pb.cc");
 
   if (!CodeGenerator::CppFileHelperFunctions(output_cc_file_name,
+                                             code_size,
                                              output_directory,
                                              error)) {
     return false;
   }
 
+  // The LazyView classes name the runtime, which the header does not
+  // include.
+  {
+    google::protobuf::internal::scoped_ptr<
+      google::protobuf::io::ZeroCopyOutputStream> output_h(
+          output_directory->OpenForInsert(output_h_file_name, "includes"));
+    google::protobuf::io::Printer h_printer(output_h.get(), '$');
+    h_printer.Print(
+        "namespace sg {\n"
+        "namespace protobuf {\n"
+        "namespace ccjs {\n"
+        "namespace runtime {\n"
+        "class LazySpans;\n"
+        "}  // namespace runtime\n"
+        "}  // namespace ccjs\n"
+        "}  // namespace protobuf\n"
+        "}  // namespace sg\n");
+    if (h_printer.failed()) {
+      *error = "CppJsCodeGenerator detected write error.";
+      return false;
+    }
+  }
+
+  // The code of all of the messages goes into a single namespace_scope
+  // insertion of each file, protoc splices each insertion separately.
+  google::protobuf::internal::scoped_ptr<
+    google::protobuf::io::ZeroCopyOutputStream> output_h(
+        output_directory->OpenForInsert(output_h_file_name,
+                                        "namespace_scope"));
+  google::protobuf::io::Printer h_printer(output_h.get(), '$');
+  google::protobuf::internal::scoped_ptr<
+    google::protobuf::io::ZeroCopyOutputStream> output_cc(
+        output_directory->OpenForInsert(output_cc_file_name,
+                                        "namespace_scope"));
+  google::protobuf::io::Printer cc_printer(output_cc.get(), '$');
   for (int i = 0; i < file->message_type_count(); ++i) {
     const google::protobuf::Descriptor *message = file->message_type(i);
 
     if (!InstrumentMessage(output_h_file_name,
-                           output_cc_file_name,
                            message,
+                           code_size,
                            output_directory,
+                           &h_printer,
+                           &cc_printer,
                            error)) {
       return false;
     }
@@ -1769,6 +3376,15 @@ bool CodeGenerator::Generate(
   return true;
 }
 
+bool CodeGenerator::GenerateAll(
+    const std::vector<const google::protobuf::FileDescriptor *> &files,
+    const std::string &parameter,
+    google::protobuf::compiler::OutputDirectory *output_directory,
+    std::string *error) const {
+  return js::GenerateAllOnThreads(this, files, parameter, output_directory,
+                                  error);
+}
+
 }  // namespace ccjs
 }  // namespace protobuf
 }  // namespace sg
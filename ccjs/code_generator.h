@@ -18,6 +18,7 @@
 #define PROTOBUF_CCJS_CODE_GENERATOR_H_
 
 #include <string>
+#include <vector>
 
 #include "google/protobuf/compiler/code_generator.h"
 #include "google/protobuf/descriptor.h"
@@ -38,37 +39,126 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
       google::protobuf::compiler::OutputDirectory *output_directory,
       std::string *error) const;
 
+  // Generates the files on a pool of threads, see GenerateAllOnThreads().
+  virtual bool GenerateAll(
+      const std::vector<const google::protobuf::FileDescriptor *> &files,
+      const std::string &parameter,
+      google::protobuf::compiler::OutputDirectory *output_directory,
+      std::string *error) const;
+
  private:
   std::string name_;
 
   bool HeaderFile(
       const std::string &output_h_file_name,
-      const std::string &class_scope,
+      const google::protobuf::Descriptor *message,
       google::protobuf::compiler::OutputDirectory *output_directory,
       std::string *error) const;
 
+  // Includes the runtime into the .pb.cc, and the table-driven code of
+  // ccjs_compact.h when code_size is set.
   bool CppFileHelperFunctions(
       const std::string &output_cc_file_name,
+      const bool code_size,
       google::protobuf::compiler::OutputDirectory *output_directory,
       std::string *error) const;
 
   bool SerializePartialToZeroCopyJsonStream(
-      const std::string &output_cc_file_name,
       const google::protobuf::Descriptor *message,
-      google::protobuf::compiler::OutputDirectory *output_directory,
+      google::protobuf::io::Printer *cc_printer,
       std::string *error) const;
 
+  // Emits the SerializePartialTo*String() wrappers.
+  bool SerializePartialToStrings(
+      const google::protobuf::Descriptor *message,
+      google::protobuf::io::Printer *cc_printer,
+      std::string *error) const;
+
+  // What ParsePartialFromZeroCopyJsonStream() emits for the JSON
+  // grammar: the stream parser, the static ValidateZeroCopyJsonStream()
+  // that stores nothing, the static TranscodeZeroCopyJsonStreamToBinary()
+  // that writes the binary wire format instead or the static
+  // TranscodeZeroCopyJsonStream() that writes another JSON format.
+  enum ParseMode {
+    PARSE,
+    VALIDATE,
+    TRANSCODE,
+    TRANSCODE_JSON,
+  };
+
   bool ParsePartialFromZeroCopyJsonStream(
-      const std::string &output_cc_file_name,
       const google::protobuf::Descriptor *message,
-      google::protobuf::compiler::OutputDirectory *output_directory,
+      const ParseMode mode,
+      google::protobuf::io::Printer *cc_printer,
+      std::string *error) const;
+
+  // Emits the wrappers of the parser of mode, for one format each.
+  bool ParseEntryPoints(
+      const google::protobuf::Descriptor *message,
+      const ParseMode mode,
+      google::protobuf::io::Printer *cc_printer,
       std::string *error) const;
 
+  // Emits the static TranscodeBinaryToZeroCopyJsonStream(), which writes
+  // the JSON of SerializePartialToZeroCopyJsonStream() for a binary
+  // message without parsing it into one.
+  bool TranscodeBinaryToZeroCopyJsonStream(
+      const google::protobuf::Descriptor *message,
+      google::protobuf::io::Printer *cc_printer,
+      std::string *error) const;
+
+  bool TranscodeBinaryToStrings(
+      const google::protobuf::Descriptor *message,
+      google::protobuf::io::Printer *cc_printer,
+      std::string *error) const;
+
+  bool ParsePartialFromStructuralIndex(
+      const google::protobuf::Descriptor *message,
+      google::protobuf::io::Printer *cc_printer,
+      std::string *error) const;
+
+  // Prints the LazyView class of message to h_printer, the
+  // namespace_scope of the header, if it has singular message fields.
+  bool LazyViewClass(
+      const google::protobuf::Descriptor *message,
+      google::protobuf::io::Printer *h_printer,
+      std::string *error) const;
+
+  // Emits the functions of the LazyView class of message.
+  bool LazyParseFunctions(
+      const google::protobuf::Descriptor *message,
+      google::protobuf::io::Printer *cc_printer,
+      std::string *error) const;
+
+  bool PushParserClass(
+      const google::protobuf::Descriptor *message,
+      google::protobuf::io::Printer *cc_printer,
+      std::string *error) const;
+
+  bool PushParseStep(
+      const google::protobuf::Descriptor *message,
+      google::protobuf::io::Printer *cc_printer,
+      std::string *error) const;
+
+  // Emits the table of the fields of message and the functions that the
+  // above emit unrolled as calls into the table-driven Compact*()
+  // functions of the runtime, for optimize_for=code_size.
+  bool CompactFunctions(
+      const google::protobuf::Descriptor *message,
+      google::protobuf::io::Printer *cc_printer,
+      std::string *error) const;
+
+  // Inserts the declarations of message and its nested messages into
+  // their class_scope in the header, prints their LazyView classes to
+  // h_printer and their definitions to cc_printer, the namespace_scope
+  // of the .pb.cc. The JSON code is table-driven when code_size is set.
   bool InstrumentMessage(
       const std::string &output_h_file_name,
-      const std::string &output_cc_file_name,
       const google::protobuf::Descriptor *message,
+      const bool code_size,
       google::protobuf::compiler::OutputDirectory *output_directory,
+      google::protobuf::io::Printer *h_printer,
+      google::protobuf::io::Printer *cc_printer,
       std::string *error) const;
 };
 
@@ -16,15 +16,20 @@
 
 #include "js/code_generator.h"
 
+#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 #include <iostream>  // NOLINT
 #include <sstream>  // NOLINT
 
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/io/printer.h"
 #include "google/protobuf/io/zero_copy_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 #include "google/protobuf/stubs/common.h"
 
+#include "js/generate_all.h"
 #include "js/int64_encoding.pb.h"
 #include "js/javascript_package.pb.h"
 
@@ -37,11 +42,23 @@ CodeGenerator::CodeGenerator(const std::string &name)
 
 CodeGenerator::~CodeGenerator() {}
 
+bool CodeGenerator::GenerateAll(
+    const std::vector<const google::protobuf::FileDescriptor *> &files,
+    const std::string &parameter,
+    google::protobuf::compiler::OutputDirectory *output_directory,
+    std::string *error) const {
+  return GenerateAllOnThreads(this, files, parameter, output_directory, error);
+}
+
 bool CodeGenerator::Generate(
     const google::protobuf::FileDescriptor *file,
-    const std::string &/* parameter */,
+    const std::string &parameter,
     google::protobuf::compiler::OutputDirectory *output_directory,
     std::string *error) const {
+  Options options;
+  if (!ParseOptions(parameter, &options, error)) {
+    return false;
+  }
 
   const std::string file_name = file->name();
   std::string output_file_name = file->name();
@@ -64,32 +81,36 @@ bool CodeGenerator::Generate(
   printer.Print("\n");
 
   // goog.provide all messages and enums
+  NameCache names;
   for (int i = 0; i < file->message_type_count(); ++i) {
     CodeGenerator::GenDescriptorGoogProvides(
         file->message_type(i),
-        &printer);
+        &printer,
+        &names);
   }
   for (int i = 0; i < file->enum_type_count(); ++i) {
     CodeGenerator::GenEnumDescriptorGoogProvides(
         file->enum_type(i),
-        &printer);
+        &printer,
+        &names);
   }
 
   printer.Print("\n");
-  printer.Print("goog.require('goog.proto2.Message');\n"
-                "\n");
+  printer.Print("goog.require('goog.proto2.Message');\n");
+  if (options.compact_accessors && file->message_type_count() > 0) {
+    printer.Print("goog.require('sg.protobuf.js.accessors');\n");
+  }
+  printer.Print("\n");
   for (int i = 0; i < file->dependency_count(); ++i) {
     for (int j = 0; j < file->dependency(i)->message_type_count(); j++) {
       printer.Print(
           "goog.require('$file$');\n",
           "file",
-          JsFullName(file->dependency(i)->message_type(j)->file(),
-                     file->dependency(i)->message_type(j)->full_name()));
+          JsName(file->dependency(i)->message_type(j), &names));
     }
     for (int j = 0; j < file->dependency(i)->enum_type_count(); j++) {
-      const std::string enum_name = JsFullName(
-          file->dependency(i)->enum_type(j)->file(),
-          file->dependency(i)->enum_type(j)->full_name());
+      const std::string &enum_name = JsName(
+          file->dependency(i)->enum_type(j), &names);
       if (enum_name == "Int64Encoding") {
         // The Int64Encoding enum is special in that it is not used directly
         // by any of the protobuf messages, instead it is only used internally
@@ -103,26 +124,36 @@ bool CodeGenerator::Generate(
 
   printer.Print("\n");
 
-  // generate accessor functions
-  for (int i = 0; i < file->message_type_count(); ++i) {
-    CodeGenerator::GenDescriptor(
-        file->message_type(i),
-        &printer);
+  // generate accessor functions, and the metadata that follows them in
+  // the same pass
+  std::string metadata;
+  {
+    google::protobuf::io::StringOutputStream metadata_output(&metadata);
+    google::protobuf::io::Printer metadata_printer(&metadata_output, '$');
+    for (int i = 0; i < file->message_type_count(); ++i) {
+      CodeGenerator::GenMessage(
+          file->message_type(i),
+          options,
+          &printer,
+          &metadata_printer,
+          &names);
+    }
+    if (metadata_printer.failed()) {
+      *error = "CodeGenerator detected write error.";
+      return false;
+    }
   }
   for (int i = 0; i < file->enum_type_count(); ++i) {
     CodeGenerator::GenEnumDescriptor(
         file->enum_type(i),
-        &printer);
+        &printer,
+        &names);
   }
 
   printer.Print("\n");
 
   // generate metadata
-  for (int i = 0; i < file->message_type_count(); ++i) {
-    CodeGenerator::GenDescriptorMetadata(
-        file->message_type(i),
-        &printer);
-  }
+  printer.PrintRaw(metadata);
 
   if (printer.failed()) {
     *error = "CodeGenerator detected write error.";
@@ -132,6 +163,39 @@ bool CodeGenerator::Generate(
   return true;
 }
 
+bool CodeGenerator::ParseOptions(const std::string &parameter,
+                                 Options *options,
+                                 std::string *error) {
+  std::vector<std::pair<std::string, std::string> > pairs;
+  google::protobuf::compiler::ParseGeneratorParameter(parameter, &pairs);
+  for (size_t i = 0; i < pairs.size(); ++i) {
+    if (pairs[i].first == "accessors" && pairs[i].second == "compact") {
+      options->compact_accessors = true;
+    } else if (pairs[i].first == "accessors" &&
+               pairs[i].second == "full") {
+      options->compact_accessors = false;
+    } else if (pairs[i].first == "metadata" && pairs[i].second == "lazy") {
+      options->lazy_metadata = true;
+    } else if (pairs[i].first == "metadata" &&
+               pairs[i].second == "eager") {
+      options->lazy_metadata = false;
+    } else if (pairs[i].first == "pblite" &&
+               pairs[i].second == "unrolled") {
+      options->unrolled_pblite = true;
+    } else if (pairs[i].first == "pblite" &&
+               pairs[i].second == "reflective") {
+      options->unrolled_pblite = false;
+    } else {
+      *error = "Unknown generator option: " + pairs[i].first;
+      if (!pairs[i].second.empty()) {
+        *error += "=" + pairs[i].second;
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
 std::string CodeGenerator::JsFullName(
     const google::protobuf::FileDescriptor *file,
     const std::string &full_name) {
@@ -148,39 +212,65 @@ std::string CodeGenerator::JsFullName(
   return new_name;
 }
 
+void CodeGenerator::GenMessage(
+    const google::protobuf::Descriptor *message,
+    const Options &options,
+    google::protobuf::io::Printer *accessors,
+    google::protobuf::io::Printer *metadata,
+    NameCache *names) {
+  CodeGenerator::GenDescriptor(message, options, accessors, names);
+  CodeGenerator::GenDescriptorMetadata(message, options, metadata, names);
+
+  // nested messages (recursively process)
+  for (int i = 0; i < message->nested_type_count(); ++i) {
+    CodeGenerator::GenMessage(
+        message->nested_type(i),
+        options,
+        accessors,
+        metadata,
+        names);
+    accessors->Print("\n"
+                     "\n");
+  }
+}
+
 void CodeGenerator::GenDescriptorGoogProvides(
     const google::protobuf::Descriptor *message,
-    google::protobuf::io::Printer *printer) {
+    google::protobuf::io::Printer *printer,
+    NameCache *names) {
   printer->Print("goog.provide('$name$');\n",
-                 "name", JsFullName(message->file(),
-                                    message->full_name()));
+                 "name", JsName(message, names));
 
   // enums
   for (int i = 0; i < message->enum_type_count(); ++i) {
     CodeGenerator::GenEnumDescriptorGoogProvides(
         message->enum_type(i),
-        printer);
+        printer,
+        names);
   }
 
   // Recursively process nested messages
   for (int i = 0; i < message->nested_type_count(); ++i) {
     CodeGenerator::GenDescriptorGoogProvides(
         message->nested_type(i),
-        printer);
+        printer,
+        names);
   }
 }
 
 void CodeGenerator::GenEnumDescriptorGoogProvides(
     const google::protobuf::EnumDescriptor *enum_desc,
-    google::protobuf::io::Printer *printer) {
+    google::protobuf::io::Printer *printer,
+    NameCache *names) {
   printer->Print("goog.provide('$name$');\n",
-                 "name", JsFullName(enum_desc->file(),
-                                    enum_desc->full_name()));
+                 "name", JsName(enum_desc, names));
 }
 
 void CodeGenerator::GenDescriptor(
     const google::protobuf::Descriptor *message,
-    google::protobuf::io::Printer *printer) {
+    const Options &options,
+    google::protobuf::io::Printer *printer,
+    NameCache *names) {
   printer->Print("\n"
                  "/**\n"
                  " * Message $name$.\n"
@@ -189,17 +279,19 @@ void CodeGenerator::GenDescriptor(
                  " */\n",
                  "name", message->name());
   printer->Print("$name$ = function() {\n",
-                 "name", JsFullName(message->file(),
-                                    message->full_name()));
+                 "name", JsName(message, names));
   printer->Indent();
+  if (options.lazy_metadata) {
+    printer->Print("$name$.getDescriptor();\n",
+                   "name", JsName(message, names));
+  }
   printer->Print("goog.proto2.Message.apply(this);\n");
   printer->Outdent();
   printer->Print("};\n"
                  "goog.inherits($name$, goog.proto2.Message);\n"
                  "\n"
                  "\n",
-                 "name", JsFullName(message->file(),
-                                    message->full_name()));
+                 "name", JsName(message, names));
 
   printer->Print(
       "/**\n"
@@ -209,43 +301,63 @@ void CodeGenerator::GenDescriptor(
       " * @override\n"
       " */\n"
       "$name$.prototype.clone;\n",
-      "name", JsFullName(message->file(),
-                         message->full_name()));
+      "name", JsName(message, names));
 
   // fields
-  for (int i = 0; i < message->field_count(); ++i) {
-    CodeGenerator::GenFieldDescriptor(
-        message->field(i),
-        printer);
+  if (options.compact_accessors && message->field_count() > 0) {
+    printer->Print("\n");
+    for (int i = 0; i < message->field_count(); ++i) {
+      CodeGenerator::GenCompactFieldDescriptor(
+          message->field(i),
+          printer,
+          names);
+    }
+    printer->Print("sg.protobuf.js.accessors.install($name$, [",
+                   "name", JsName(message, names));
+    for (int i = 0; i < message->field_count(); ++i) {
+      const google::protobuf::FieldDescriptor *field = message->field(i);
+      std::ostringstream number;
+      number << field->number();
+      printer->Print(
+          i == 0 ? "\n  [$number$, '$field$'$repeated$]" :
+                   ",\n  [$number$, '$field$'$repeated$]",
+          "number", number.str(),
+          "field", field->camelcase_name(),
+          "repeated", field->is_repeated() ? ", true" : "");
+    }
+    printer->Print("]);\n");
+  } else if (!options.compact_accessors) {
+    for (int i = 0; i < message->field_count(); ++i) {
+      CodeGenerator::GenFieldDescriptor(
+          message->field(i),
+          printer,
+          names);
+    }
+  }
+
+  if (options.unrolled_pblite) {
+    CodeGenerator::GenPbLiteSerializers(message, printer, names);
   }
 
   // enums
   for (int i = 0; i < message->enum_type_count(); ++i) {
     CodeGenerator::GenEnumDescriptor(
         message->enum_type(i),
-        printer);
-  }
-
-  // nested messages (recursively process)
-  for (int i = 0; i < message->nested_type_count(); ++i) {
-    CodeGenerator::GenDescriptor(
-        message->nested_type(i),
-        printer);
-    printer->Print("\n"
-                   "\n");
+        printer,
+        names);
   }
 }
 
-void CodeGenerator::GenFieldDescriptor(
+std::string CodeGenerator::JsType(
     const google::protobuf::FieldDescriptor *field,
-    google::protobuf::io::Printer *printer) {
-  printer->Print("\n");
+    NameCache *names,
+    bool *primitive) {
   std::string type;
-  bool type_is_primitive = false;
+  *primitive = false;
   bool as_number = field->options().GetExtension(jstype);
   if (field->type() == google::protobuf::FieldDescriptor::TYPE_BOOL) {
     type = "boolean";
-    type_is_primitive = true;
+    *primitive = true;
   } else if (
       field->type() == google::protobuf::FieldDescriptor::TYPE_BYTES ||
       field->type() == google::protobuf::FieldDescriptor::TYPE_STRING ||
@@ -256,21 +368,30 @@ void CodeGenerator::GenFieldDescriptor(
         field->type() == google::protobuf::FieldDescriptor::TYPE_SFIXED64) &&
        !as_number)) {
     type = "string";
-    type_is_primitive = true;
+    *primitive = true;
   } else if (
       field->type() == google::protobuf::FieldDescriptor::TYPE_GROUP ||
       field->type() == google::protobuf::FieldDescriptor::TYPE_MESSAGE) {
-    type = JsFullName(field->message_type()->file(),
-                      field->message_type()->full_name());
+    type = JsName(field->message_type(), names);
   } else if (field->type() == google::protobuf::FieldDescriptor::TYPE_ENUM) {
-    type = JsFullName(field->enum_type()->file(),
-                      field->enum_type()->full_name());
-    type_is_primitive = true;
+    type = JsName(field->enum_type(), names);
+    *primitive = true;
   } else {
     type = "number";
-    type_is_primitive = true;
+    *primitive = true;
   }
 
+  return type;
+}
+
+void CodeGenerator::GenFieldDescriptor(
+    const google::protobuf::FieldDescriptor *field,
+    google::protobuf::io::Printer *printer,
+    NameCache *names) {
+  printer->Print("\n");
+  bool type_is_primitive;
+  const std::string type = JsType(field, names, &type_is_primitive);
+
   std::ostringstream number;
   number << field->number();
 
@@ -279,253 +400,380 @@ void CodeGenerator::GenFieldDescriptor(
     upper_name[0] -= 32;
   }
 
+  // The variables are shared by all accessors, so that each is printed
+  // with a single substitution pass.
+  std::map<std::string, std::string> vars;
+  vars["name"] = field->name();
+  vars["type"] = type;
+  vars["nullable"] = type_is_primitive ? "?" : "";
+  vars["non_null"] = type_is_primitive ? "" : "!";
+  vars["prefix"] = JsName(field->containing_type(), names);
+  vars["field"] = upper_name;
+  vars["camel_field"] = field->camelcase_name();
+  vars["number"] = number.str();
+
   // get
   if (field->label() == google::protobuf::FieldDescriptor::LABEL_REPEATED) {
     printer->Print(
+        vars,
         "\n"
         "/**\n"
         " * Gets the value of the $name$ field at the index given.\n"
-        " * @param {number} index The index to lookup.\n",
-        "name", field->name());
-    printer->Print(
-        " * @return {$opt$$type$} The value.\n"
-        " */\n",
-        "opt", type_is_primitive ? "?" : "",
-        "type", type);
-    printer->Print(
-        "$prefix$.prototype.get$field$ = function(index) {\n",
-        "prefix", JsFullName(field->containing_type()->file(),
-                             field->containing_type()->full_name()),
-        "field", upper_name);
-    printer->Indent();
-    printer->Print(
-        "return /** @type {$opt$$type$} */ ",
-        "opt", type_is_primitive ? "?" : "",
-        "type", type);
-    printer->Print(
-        "(this.get$$Value($number$, index));\n",
-        "number", number.str());
-    printer->Outdent();
-    printer->Print(
+        " * @param {number} index The index to lookup.\n"
+        " * @return {$nullable$$type$} The value.\n"
+        " */\n"
+        "$prefix$.prototype.get$field$ = function(index) {\n"
+        "  return /** @type {$nullable$$type$} */ "
+            "(this.get$$Value($number$, index));\n"
         "};\n"
-        "\n");
-
-    printer->Print(
+        "\n"
         "\n"
         "/**\n"
         " * Gets the value of the $name$ field at the index given or the "
             "default value if not set.\n"
-        " * @param {number} index The index to lookup.\n",
-        "name", field->name());
-    printer->Print(
-        " * @return {$opt$$type$} The value.\n"
-        " */\n",
-        "opt", type_is_primitive ? "" : "!",
-        "type", type);
-    printer->Print(
-        "$prefix$.prototype.get$field$OrDefault = function(index) {\n",
-        "prefix", JsFullName(field->containing_type()->file(),
-                             field->containing_type()->full_name()),
-        "field", upper_name);
-    printer->Indent();
-    printer->Print(
-        "return /** @type {$opt$$type$} */ (",
-        "opt", type_is_primitive ? "" : "!",
-        "type", type);
-    printer->Print(
-        "this.get$$ValueOrDefault($number$, "
-            "index));\n",
-        "number", number.str());
-    printer->Outdent();
-    printer->Print(
+        " * @param {number} index The index to lookup.\n"
+        " * @return {$non_null$$type$} The value.\n"
+        " */\n"
+        "$prefix$.prototype.get$field$OrDefault = function(index) {\n"
+        "  return /** @type {$non_null$$type$} */ ("
+            "this.get$$ValueOrDefault($number$, index));\n"
         "};\n"
         "\n");
   } else {
     printer->Print(
+        vars,
         "\n"
         "/**\n"
-        " * Gets the value of the $name$ field.\n",
-        "name", field->name());
-    printer->Print(
-        " * @return {$opt$$type$} The value.\n"
-        " */\n",
-        "opt", type_is_primitive ? "?" : "",
-        "type", type);
-    printer->Print(
-        "$prefix$.prototype.get$field$ = function() {\n",
-        "prefix", JsFullName(field->containing_type()->file(),
-                             field->containing_type()->full_name()),
-        "field", upper_name);
-    printer->Indent();
-    printer->Print(
-        "return /** @type {$opt$$type$} */ ",
-        "opt", type_is_primitive ? "?" : "",
-        "type", type);
-    printer->Print(
-        "(this.get$$Value($number$));\n",
-        "number", number.str());
-    printer->Outdent();
-    printer->Print(
+        " * Gets the value of the $name$ field.\n"
+        " * @return {$nullable$$type$} The value.\n"
+        " */\n"
+        "$prefix$.prototype.get$field$ = function() {\n"
+        "  return /** @type {$nullable$$type$} */ "
+            "(this.get$$Value($number$));\n"
         "};\n"
-        "\n");
-
-    printer->Print(
+        "\n"
         "\n"
         "/**\n"
         " * Gets the value of the $name$ field or the default value if not "
-        "set.\n",
-        "name", field->name());
-    printer->Print(
-        " * @return {$opt$$type$} The value.\n"
-        " */\n",
-        "opt", type_is_primitive ? "" : "!",
-        "type", type);
-    printer->Print(
-        "$prefix$.prototype.get$field$OrDefault = function() {\n",
-        "prefix", JsFullName(field->containing_type()->file(),
-                             field->containing_type()->full_name()),
-        "field", upper_name);
-    printer->Indent();
-    printer->Print(
-        "return /** @type {$opt$$type$} */ (",
-        "opt", type_is_primitive ? "" : "!",
-        "type", type);
-    printer->Print(
-        "this.get$$ValueOrDefault($number$));\n",
-        "number", number.str());
-    printer->Outdent();
-    printer->Print(
+        "set.\n"
+        " * @return {$non_null$$type$} The value.\n"
+        " */\n"
+        "$prefix$.prototype.get$field$OrDefault = function() {\n"
+        "  return /** @type {$non_null$$type$} */ ("
+            "this.get$$ValueOrDefault($number$));\n"
         "};\n"
         "\n");
   }
 
   // set
   if (field->label() != google::protobuf::FieldDescriptor::LABEL_REPEATED) {
-    printer->Print("\n"
-                   "/**\n"
-                   " * Sets the value of the $name$ field.\n",
-                   "name", field->name());
-    printer->Print(" * @param {$opt$$type$} value The value.\n"
-                   " */\n",
-                   "opt", type_is_primitive ? "" : "!",
-                   "type", type);
-    printer->Print("$prefix$.prototype.set$field$ = function(value) {\n",
-                   "prefix", JsFullName(field->containing_type()->file(),
-                                        field->containing_type()->full_name()),
-                   "field", upper_name);
-    printer->Indent();
     printer->Print(
-        "this.set$$Value($number$, value);\n",
-        "number", number.str());
-    printer->Outdent();
-    printer->Print("};\n"
-                   "\n");
+        vars,
+        "\n"
+        "/**\n"
+        " * Sets the value of the $name$ field.\n"
+        " * @param {$non_null$$type$} value The value.\n"
+        " */\n"
+        "$prefix$.prototype.set$field$ = function(value) {\n"
+        "  this.set$$Value($number$, value);\n"
+        "};\n"
+        "\n");
   }
 
   // add, Array
   if (field->label() == google::protobuf::FieldDescriptor::LABEL_REPEATED) {
-    printer->Print("\n"
-                   "/**\n"
-                   " * Adds a value to the $name$ field.\n",
-                   "name", field->name());
-    printer->Print(" * @param {$opt$$type$} value The value to add.\n"
-                   " */\n",
-                   "opt", type_is_primitive ? "" : "!",
-                   "type", type);
-    printer->Print("$prefix$.prototype.add$field$ = function(value) {\n",
-                   "prefix", JsFullName(field->containing_type()->file(),
-                                        field->containing_type()->full_name()),
-                   "field", upper_name);
-    printer->Indent();
     printer->Print(
-        "this.add$$Value($number$, value);\n",
-        "number", number.str());
-    printer->Outdent();
-    printer->Print("};\n"
-                   "\n");
+        vars,
+        "\n"
+        "/**\n"
+        " * Adds a value to the $name$ field.\n"
+        " * @param {$non_null$$type$} value The value to add.\n"
+        " */\n"
+        "$prefix$.prototype.add$field$ = function(value) {\n"
+        "  this.add$$Value($number$, value);\n"
+        "};\n"
+        "\n"
+        "\n"
+        "/**\n"
+        " * Returns the array of values in the $name$ field.\n"
+        " * @return {!Array.<$non_null$$type$>} The values in the field.\n"
+        " */\n"
+        "$prefix$.prototype.$camel_field$Array = function() {\n"
+        "  return /** @type {!Array.<$non_null$$type$>} */ ("
+            "this.array$$Values($number$));\n"
+        "};\n"
+        "\n");
+  }
 
-    printer->Print("\n"
-                   "/**\n"
-                   " * Returns the array of values in the $name$ field.\n",
-                   "name", field->name());
-    printer->Print(
-        " * @return {!Array.<$opt$$type$>} The values in the field.\n"
-        " */\n",
-        "opt", type_is_primitive ? "" : "!",
-        "type", type);
-    printer->Print("$prefix$.prototype.$field$Array = function() {\n",
-                   "prefix", JsFullName(field->containing_type()->file(),
-                                        field->containing_type()->full_name()),
-                   "field", field->camelcase_name());
-    printer->Indent();
+  // has, count, clear
+  printer->Print(
+      vars,
+      "\n"
+      "/**\n"
+      " * @return {boolean} Whether the $name$ field has a value.\n"
+      " */\n"
+      "$prefix$.prototype.has$field$ = function() {\n"
+      "  return this.has$$Value($number$);\n"
+      "};\n"
+      "\n"
+      "\n"
+      "/**\n"
+      " * @return {number} The number of values in the $name$ field.\n"
+      " */\n"
+      "$prefix$.prototype.$camel_field$Count = function() {\n"
+      "  return this.count$$Values($number$);\n"
+      "};\n"
+      "\n"
+      "\n"
+      "/**\n"
+      " * Clears the values in the $name$ field.\n"
+      " */\n"
+      "$prefix$.prototype.clear$field$ = function() {\n"
+      "  this.clear$$Field($number$);\n"
+      "};\n");
+}
+
+void CodeGenerator::GenCompactFieldDescriptor(
+    const google::protobuf::FieldDescriptor *field,
+    google::protobuf::io::Printer *printer,
+    NameCache *names) {
+  bool type_is_primitive;
+  const std::string type = JsType(field, names, &type_is_primitive);
+
+  std::string upper_name = field->camelcase_name();
+  if (upper_name[0] >= 97 && upper_name[0] <= 122) {
+    upper_name[0] -= 32;
+  }
+
+  std::map<std::string, std::string> vars;
+  vars["type"] = type;
+  vars["nullable"] = type_is_primitive ? "?" : "";
+  vars["non_null"] = type_is_primitive ? "" : "!";
+  vars["prefix"] = JsName(field->containing_type(), names) + ".prototype.";
+  vars["field"] = upper_name;
+  vars["camel_field"] = field->camelcase_name();
+  vars["index"] = field->is_repeated() ? "number" : "";
+
+  printer->Print(
+      vars,
+      "/** @type {function($index$):$nullable$$type$} */\n"
+      "$prefix$get$field$;\n"
+      "/** @type {function($index$):$non_null$$type$} */\n"
+      "$prefix$get$field$OrDefault;\n");
+  if (field->is_repeated()) {
     printer->Print(
-        "return /** @type {!Array.<$opt$$type$>} */ (",
-        "type", type,
-        "opt", type_is_primitive ? "" : "!");
+        vars,
+        "/** @type {function($non_null$$type$)} */\n"
+        "$prefix$add$field$;\n"
+        "/** @type {function():!Array.<$non_null$$type$>} */\n"
+        "$prefix$$camel_field$Array;\n");
+  } else {
     printer->Print(
-        "this.array$$Values($number$));"
-        "\n",
-        "number", number.str());
-    printer->Outdent();
-    printer->Print("};\n"
-                   "\n");
+        vars,
+        "/** @type {function($non_null$$type$)} */\n"
+        "$prefix$set$field$;\n");
   }
+  printer->Print(
+      vars,
+      "/** @type {sg.protobuf.js.accessors.Has} */\n"
+      "$prefix$has$field$;\n"
+      "/** @type {sg.protobuf.js.accessors.Count} */\n"
+      "$prefix$$camel_field$Count;\n"
+      "/** @type {sg.protobuf.js.accessors.Clear} */\n"
+      "$prefix$clear$field$;\n");
+}
 
-  // has
-  printer->Print("\n"
-                 "/**\n"
-                 " * @return {boolean} Whether the $name$ field has a value.\n"
-                 " */\n",
-                 "name", field->name());
-  printer->Print("$prefix$.prototype.has$field$ = function() {\n",
-                 "prefix", JsFullName(field->containing_type()->file(),
-                                      field->containing_type()->full_name()),
-                 "field", upper_name);
-  printer->Indent();
-  printer->Print("return this.has$$Value($number$);\n",
-                 "number", number.str());
-  printer->Outdent();
-  printer->Print("};\n"
-                 "\n");
+void CodeGenerator::GenPbLiteSerializers(
+    const google::protobuf::Descriptor *message,
+    google::protobuf::io::Printer *printer,
+    NameCache *names) {
+  // toPbLite only needs value for repeated fields and i for the repeated
+  // fields that it converts element by element.
+  bool has_repeated = false;
+  bool has_converted_repeated = false;
+  for (int i = 0; i < message->field_count(); ++i) {
+    const google::protobuf::FieldDescriptor *field = message->field(i);
+    if (field->is_repeated()) {
+      has_repeated = true;
+      has_converted_repeated = has_converted_repeated ||
+          field->type() == google::protobuf::FieldDescriptor::TYPE_BOOL ||
+          field->cpp_type() ==
+              google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE;
+    }
+  }
 
-  // count
+  std::map<std::string, std::string> vars;
+  vars["name"] = message->name();
+  vars["prefix"] = JsName(message, names);
+  vars["locals"] = has_repeated ? "value, i" : "value";
+  vars["to_locals"] = has_converted_repeated ? "value, i" : "value";
+
+  // fromPbLite
   printer->Print(
+      vars,
+      "\n"
       "\n"
       "/**\n"
-      " * @return {number} The number of values in the $name$ field.\n"
-      " */\n",
-      "name", field->name());
-  printer->Print("$prefix$.prototype.$field$Count = function() {\n",
-                 "prefix", JsFullName(field->containing_type()->file(),
-                                      field->containing_type()->full_name()),
-                 "field", field->camelcase_name());
+      " * Deserializes a $name$ from its PbLite array.\n"
+      " * @param {!Array} data The PbLite array.\n"
+      " * @param {boolean=} opt_zeroIndex Whether field 1 is at index 0, as "
+          "in the\n"
+      " *     PbLiteZeroIndex format, instead of at index 1.\n"
+      " * @return {!$prefix$} The message.\n"
+      " */\n"
+      "$prefix$.fromPbLite = function(data, opt_zeroIndex) {\n");
   printer->Indent();
-  printer->Print("return this.count$$Values($number$);\n",
-                 "number", number.str());
+  printer->Print(vars, "var message = new $prefix$();\n");
+  if (message->field_count() > 0) {
+    printer->Print(vars,
+                   "var offset = opt_zeroIndex ? 1 : 0;\n"
+                   "var $locals$;\n");
+  }
+  for (int i = 0; i < message->field_count(); ++i) {
+    const google::protobuf::FieldDescriptor *field = message->field(i);
+    bool type_is_primitive;
+    const std::string type = JsType(field, names, &type_is_primitive);
+    std::ostringstream number;
+    number << field->number();
+
+    // The value is converted to the type of the field, as in
+    // goog.proto2.PbLiteSerializer.
+    std::string from_value;
+    if (field->type() == google::protobuf::FieldDescriptor::TYPE_BOOL) {
+      from_value = "!!$value$";
+    } else if (!type_is_primitive) {
+      from_value = type + ".fromPbLite($value$, opt_zeroIndex)";
+    } else if (type == "string") {
+      from_value = "String($value$)";
+    } else {
+      from_value = "$value$";
+    }
+    const std::string element = field->is_repeated() ? "value[i]" : "value";
+    from_value.replace(from_value.find("$value$"), 7, element);
+
+    printer->Print("\n"
+                   "value = data[$number$ - offset];\n"
+                   "if (value != null) {\n",
+                   "number", number.str());
+    if (field->is_repeated()) {
+      printer->Print("  for (i = 0; i < value.length; ++i) {\n"
+                     "    message.add$$Value($number$, $value$);\n"
+                     "  }\n",
+                     "number", number.str(),
+                     "value", from_value);
+    } else {
+      printer->Print("  message.set$$Value($number$, $value$);\n",
+                     "number", number.str(),
+                     "value", from_value);
+    }
+    printer->Print("}\n");
+  }
+  if (message->field_count() > 0) {
+    printer->Print("\n");
+  }
+  printer->Print("return message;\n");
   printer->Outdent();
-  printer->Print("};\n"
-                 "\n");
+  printer->Print("};\n");
 
-  // clear
-  printer->Print("\n"
-                 "/**\n"
-                 " * Clears the values in the $name$ field.\n"
-                 " */\n",
-                 "name", field->name());
-  printer->Print("$prefix$.prototype.clear$field$ = function() {\n",
-                 "prefix", JsFullName(field->containing_type()->file(),
-                                      field->containing_type()->full_name()),
-                 "field", upper_name);
+  // toPbLite
+  printer->Print(
+      vars,
+      "\n"
+      "\n"
+      "/**\n"
+      " * Serializes a $name$ to its PbLite array. JSON.stringify() writes "
+          "the\n"
+      " * array like SerializePartialToPbLiteString() of the ccjs plugin.\n"
+      " * @param {!$prefix$} message The message.\n"
+      " * @param {boolean=} opt_zeroIndex Whether field 1 is at index 0, as "
+          "in the\n"
+      " *     PbLiteZeroIndex format, instead of at index 1.\n"
+      " * @return {!Array} The PbLite array.\n"
+      " */\n"
+      "$prefix$.toPbLite = function(message, opt_zeroIndex) {\n");
   printer->Indent();
-  printer->Print("this.clear$$Field($number$);\n",
-                 "number", number.str());
+  printer->Print("var data = [];\n");
+  if (message->field_count() > 0) {
+    printer->Print("var offset = opt_zeroIndex ? 1 : 0;\n");
+  }
+  if (has_repeated) {
+    printer->Print(vars, "var $to_locals$;\n");
+  }
+  for (int i = 0; i < message->field_count(); ++i) {
+    const google::protobuf::FieldDescriptor *field = message->field(i);
+    bool type_is_primitive;
+    const std::string type = JsType(field, names, &type_is_primitive);
+    std::ostringstream number;
+    number << field->number();
+
+    std::string to_value;
+    if (field->type() == google::protobuf::FieldDescriptor::TYPE_BOOL) {
+      to_value = "$value$ ? 1 : 0";
+    } else if (!type_is_primitive) {
+      to_value = type + ".toPbLite(/** @type {!" + type + "} */ ($value$), "
+                 "opt_zeroIndex)";
+    }
+
+    printer->Print("\n");
+    if (field->is_repeated()) {
+      printer->Print("value = message.array$$Values($number$);\n"
+                     "if (value.length > 0) {\n",
+                     "number", number.str());
+      if (to_value.empty()) {
+        printer->Print("  data[$number$ - offset] = value.slice(0);\n",
+                       "number", number.str());
+      } else {
+        to_value.replace(to_value.find("$value$"), 7, "value[i]");
+        printer->Print("  data[$number$ - offset] = [];\n"
+                       "  for (i = 0; i < value.length; ++i) {\n"
+                       "    data[$number$ - offset][i] = $value$;\n"
+                       "  }\n",
+                       "number", number.str(),
+                       "value", to_value);
+      }
+    } else {
+      if (to_value.empty()) {
+        to_value = "$value$";
+      }
+      to_value.replace(to_value.find("$value$"), 7,
+                       "message.get$Value(" + number.str() + ")");
+      printer->Print("if (message.has$$Value($number$)) {\n"
+                     "  data[$number$ - offset] = $value$;\n",
+                     "number", number.str(),
+                     "value", to_value);
+    }
+    printer->Print("}\n");
+  }
+  if (has_repeated) {
+    // Like ccjs, the empty repeated fields before the last field with a
+    // value are written as [] and the other empty fields as null.
+    printer->Print("\n");
+    for (int i = 0; i < message->field_count(); ++i) {
+      const google::protobuf::FieldDescriptor *field = message->field(i);
+      if (!field->is_repeated()) {
+        continue;
+      }
+      std::ostringstream number;
+      number << field->number();
+      printer->Print("if (data.length > $number$ - offset &&\n"
+                     "    data[$number$ - offset] === undefined) {\n"
+                     "  data[$number$ - offset] = [];\n"
+                     "}\n",
+                     "number", number.str());
+    }
+  }
+  if (message->field_count() > 0) {
+    printer->Print("\n");
+  }
+  printer->Print("return data;\n");
   printer->Outdent();
   printer->Print("};\n");
 }
 
 void CodeGenerator::GenEnumDescriptor(
     const google::protobuf::EnumDescriptor *enum_desc,
-    google::protobuf::io::Printer *printer) {
+    google::protobuf::io::Printer *printer,
+    NameCache *names) {
   printer->Print("\n"
                  "\n"
                  "/**\n"
@@ -534,8 +782,7 @@ void CodeGenerator::GenEnumDescriptor(
                  " */\n",
                  "name", enum_desc->name());
   printer->Print("$name$ = {\n",
-                 "name", JsFullName(enum_desc->file(),
-                                    enum_desc->full_name()));
+                 "name", JsName(enum_desc, names));
   printer->Indent();
   for (int i = 0; i < enum_desc->value_count(); ++i) {
     std::string format = "$key$: $value$,\n";
@@ -556,12 +803,30 @@ void CodeGenerator::GenEnumDescriptor(
 
 void CodeGenerator::GenDescriptorMetadata(
       const google::protobuf::Descriptor *message,
-      google::protobuf::io::Printer *printer) {
-  printer->Print("\n"
-                 "\n"
-                 "goog.proto2.Message.set$$Metadata($name$, {\n",
-                 "name", JsFullName(message->file(),
-                                    message->full_name()));
+      const Options &options,
+      google::protobuf::io::Printer *printer,
+      NameCache *names) {
+  if (options.lazy_metadata) {
+    // set$Metadata() replaces getDescriptor() with the accessor of the
+    // descriptor it creates.
+    printer->Print("\n"
+                   "\n"
+                   "/**\n"
+                   " * Registers the metadata of $name$ on first use.\n"
+                   " * @return {!goog.proto2.Descriptor} The descriptor.\n"
+                   " */\n"
+                   "$js_name$.getDescriptor = function() {\n",
+                   "name", message->name(),
+                   "js_name", JsName(message, names));
+    printer->Indent();
+    printer->Print("goog.proto2.Message.set$$Metadata($name$, {\n",
+                   "name", JsName(message, names));
+  } else {
+    printer->Print("\n"
+                   "\n"
+                   "goog.proto2.Message.set$$Metadata($name$, {\n",
+                   "name", JsName(message, names));
+  }
   printer->Indent();
   printer->Print("0: {\n");
   printer->Indent();
@@ -570,8 +835,7 @@ void CodeGenerator::GenDescriptorMetadata(
   if (message->containing_type() != NULL) {
     printer->Print("containingType: $type$,\n",
                    "type",
-                   JsFullName(message->containing_type()->file(),
-                              message->containing_type()->full_name()));
+                   JsName(message->containing_type(), names));
   }
   printer->Print("fullName: '$fullname$'\n",
                  "fullname", message->full_name());
@@ -585,7 +849,8 @@ void CodeGenerator::GenDescriptorMetadata(
   for (int i = 0; i < message->field_count(); ++i) {
     CodeGenerator::GenFieldDescriptorMetadata(
         message->field(i),
-        printer);
+        printer,
+        names);
     if (i != message->field_count() - 1) {
       printer->Print(",\n");
     } else {
@@ -594,18 +859,18 @@ void CodeGenerator::GenDescriptorMetadata(
   }
   printer->Outdent();
   printer->Print("});\n");
-
-  // nested messages (recursively process)
-  for (int i = 0; i < message->nested_type_count(); ++i) {
-    CodeGenerator::GenDescriptorMetadata(
-        message->nested_type(i),
-        printer);
+  if (options.lazy_metadata) {
+    printer->Print("return $name$.getDescriptor();\n",
+                   "name", JsName(message, names));
+    printer->Outdent();
+    printer->Print("};\n");
   }
 }
 
 void CodeGenerator::GenFieldDescriptorMetadata(
       const google::protobuf::FieldDescriptor *field,
-      google::protobuf::io::Printer *printer) {
+      google::protobuf::io::Printer *printer,
+      NameCache *names) {
   std::ostringstream number;
   number << field->number();
 
@@ -667,9 +932,8 @@ void CodeGenerator::GenFieldDescriptorMetadata(
   } else if (field->type() == google::protobuf::FieldDescriptor::TYPE_ENUM) {
     js_type = "ENUM";
 
-    default_value << JsFullName(field->enum_type()->file(),
-                                field->enum_type()->full_name() + "." +
-                                field->default_value_enum()->name());
+    default_value << JsName(field->enum_type(), names) << "."
+                  << field->default_value_enum()->name();
   } else if (
       field->type() == google::protobuf::FieldDescriptor::TYPE_SFIXED32) {
     js_type = "SFIXED32";
@@ -710,11 +974,9 @@ void CodeGenerator::GenFieldDescriptorMetadata(
   } else if (
       field->type() == google::protobuf::FieldDescriptor::TYPE_GROUP ||
       field->type() == google::protobuf::FieldDescriptor::TYPE_MESSAGE) {
-    js_object = JsFullName(field->message_type()->file(),
-                           field->message_type()->full_name());
+    js_object = JsName(field->message_type(), names);
   } else if (field->type() == google::protobuf::FieldDescriptor::TYPE_ENUM) {
-    js_object = JsFullName(field->enum_type()->file(),
-                           field->enum_type()->full_name());
+    js_object = JsName(field->enum_type(), names);
   } else {
     js_object = "Number";
   }
@@ -17,7 +17,9 @@
 #ifndef PROTOBUF_JS_CODE_GENERATOR_H_
 #define PROTOBUF_JS_CODE_GENERATOR_H_
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include "google/protobuf/compiler/code_generator.h"
 #include "google/protobuf/descriptor.h"
@@ -38,40 +40,127 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
       google::protobuf::compiler::OutputDirectory *output_directory,
       std::string *error) const;
 
+  // Generates the files on a pool of threads, see GenerateAllOnThreads().
+  virtual bool GenerateAll(
+      const std::vector<const google::protobuf::FileDescriptor *> &files,
+      const std::string &parameter,
+      google::protobuf::compiler::OutputDirectory *output_directory,
+      std::string *error) const;
+
  private:
   std::string name_;
 
+  // The JsFullName() of each message and enum descriptor, computed once
+  // per Generate().
+  typedef std::map<const void *, std::string> NameCache;
+
   static std::string JsFullName(
       const google::protobuf::FileDescriptor *file,
       const std::string &full_name);
 
+  // Returns the JsFullName() of a message or enum from names.
+  template <typename DescriptorType>
+  static const std::string &JsName(const DescriptorType *descriptor,
+                                   NameCache *names) {
+    std::string &name = (*names)[descriptor];
+    if (name.empty()) {
+      name = JsFullName(descriptor->file(), descriptor->full_name());
+    }
+    return name;
+  }
+
+  // The options of the generator, given as --js_out=<options>:<dir>.
+  struct Options {
+    Options()
+        : compact_accessors(false),
+          lazy_metadata(false),
+          unrolled_pblite(false) {}
+
+    // accessors=compact: declares the accessors of each field with their
+    // types only and installs them with js/message_accessors.js from a
+    // table of the fields, instead of emitting every accessor.
+    bool compact_accessors;
+
+    // metadata=lazy: registers the metadata of each message type when it
+    // is first instantiated or its getDescriptor() is first called,
+    // instead of when the file is loaded.
+    bool lazy_metadata;
+
+    // pblite=unrolled: emits static fromPbLite() and toPbLite() functions
+    // for each message type that read and write the slots of its fields
+    // directly, in the PbLite format of the ccjs plugin.
+    bool unrolled_pblite;
+  };
+
+  static bool ParseOptions(const std::string &parameter,
+                           Options *options,
+                           std::string *error);
+
+  // Emits the accessors and metadata of message and its nested messages
+  // in a single traversal, each to its own printer.
+  static void GenMessage(
+      const google::protobuf::Descriptor *message,
+      const Options &options,
+      google::protobuf::io::Printer *accessors,
+      google::protobuf::io::Printer *metadata,
+      NameCache *names);
+
   static void GenDescriptorGoogProvides(
       const google::protobuf::Descriptor *message,
-      google::protobuf::io::Printer *printer);
+      google::protobuf::io::Printer *printer,
+      NameCache *names);
 
   static void GenEnumDescriptorGoogProvides(
       const google::protobuf::EnumDescriptor *enum_desc,
-      google::protobuf::io::Printer *printer);
+      google::protobuf::io::Printer *printer,
+      NameCache *names);
 
   static void GenDescriptor(
       const google::protobuf::Descriptor *message,
-      google::protobuf::io::Printer *printer);
+      const Options &options,
+      google::protobuf::io::Printer *printer,
+      NameCache *names);
+
+  // Returns the Closure type of the values of field, and whether that is
+  // a primitive type in primitive.
+  static std::string JsType(const google::protobuf::FieldDescriptor *field,
+                            NameCache *names,
+                            bool *primitive);
 
   static void GenFieldDescriptor(
       const google::protobuf::FieldDescriptor *field,
-      google::protobuf::io::Printer *printer);
+      google::protobuf::io::Printer *printer,
+      NameCache *names);
+
+  // Emits the typed declarations of the accessors of field for
+  // accessors=compact.
+  static void GenCompactFieldDescriptor(
+      const google::protobuf::FieldDescriptor *field,
+      google::protobuf::io::Printer *printer,
+      NameCache *names);
+
+  // Emits the fromPbLite() and toPbLite() functions of message for
+  // pblite=unrolled.
+  static void GenPbLiteSerializers(
+      const google::protobuf::Descriptor *message,
+      google::protobuf::io::Printer *printer,
+      NameCache *names);
 
   static void GenEnumDescriptor(
       const google::protobuf::EnumDescriptor *enum_desc,
-      google::protobuf::io::Printer *printer);
+      google::protobuf::io::Printer *printer,
+      NameCache *names);
 
   static void GenDescriptorMetadata(
       const google::protobuf::Descriptor *message,
-      google::protobuf::io::Printer *printer);
+      const Options &options,
+      google::protobuf::io::Printer *printer,
+      NameCache *names);
 
   static void GenFieldDescriptorMetadata(
       const google::protobuf::FieldDescriptor *field,
-      google::protobuf::io::Printer *printer);
+      google::protobuf::io::Printer *printer,
+      NameCache *names);
 };
 
 }  // namespace js
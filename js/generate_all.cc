@@ -0,0 +1,183 @@
+// Copyright (c) 2011 SameGoal LLC.
+// All Rights Reserved.
+// Author: Andy Hochhaus <ahochhaus@samegoal.com>
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "js/generate_all.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "google/protobuf/io/printer.h"
+#include "google/protobuf/io/zero_copy_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/stubs/common.h"
+
+namespace sg {
+namespace protobuf {
+namespace js {
+
+namespace {
+
+// An OutputDirectory that keeps everything written to it in memory, in
+// the order the files and insertion points were opened, until Commit()
+// replays it on the real OutputDirectory.
+class BufferedOutputDirectory
+    : public google::protobuf::compiler::OutputDirectory {
+ public:
+  BufferedOutputDirectory() {}
+  virtual ~BufferedOutputDirectory() {}
+
+  virtual google::protobuf::io::ZeroCopyOutputStream *Open(
+      const std::string &filename) {
+    return OpenForInsert(filename, "");
+  }
+
+  virtual google::protobuf::io::ZeroCopyOutputStream *OpenForInsert(
+      const std::string &filename,
+      const std::string &insertion_point) {
+    // a deque keeps the contents of earlier outputs in place while their
+    // streams are still open
+    outputs_.push_back(Output());
+    Output &output = outputs_.back();
+    output.filename = filename;
+    output.insertion_point = insertion_point;
+    return new google::protobuf::io::StringOutputStream(&output.contents);
+  }
+
+  void Commit(google::protobuf::compiler::OutputDirectory *output_directory) {
+    for (std::deque<Output>::const_iterator output = outputs_.begin();
+         output != outputs_.end();
+         ++output) {
+      google::protobuf::internal::scoped_ptr<
+          google::protobuf::io::ZeroCopyOutputStream> stream(
+              output->insertion_point.empty() ?
+              output_directory->Open(output->filename) :
+              output_directory->OpenForInsert(output->filename,
+                                              output->insertion_point));
+      google::protobuf::io::Printer printer(stream.get(), '$');
+      printer.PrintRaw(output->contents);
+    }
+  }
+
+ private:
+  struct Output {
+    std::string filename;
+    std::string insertion_point;
+    std::string contents;
+  };
+
+  std::deque<Output> outputs_;
+};
+
+// The files shared by the threads of GenerateAllOnThreads(). Each thread
+// takes the next file under the mutex until none are left.
+struct GenerateAllTask {
+  const google::protobuf::compiler::CodeGenerator *generator;
+  const std::vector<const google::protobuf::FileDescriptor *> *files;
+  const std::string *parameter;
+  std::vector<BufferedOutputDirectory *> outputs;
+  std::vector<std::string> errors;
+  std::vector<char> results;
+  pthread_mutex_t mutex;
+  size_t next;
+};
+
+void *RunGenerateAllTask(void *arg) {
+  GenerateAllTask *task = static_cast<GenerateAllTask *>(arg);
+  for (;;) {
+    pthread_mutex_lock(&task->mutex);
+    const size_t i = task->next++;
+    pthread_mutex_unlock(&task->mutex);
+    if (i >= task->files->size()) {
+      break;
+    }
+    task->results[i] = task->generator->Generate((*task->files)[i],
+                                                 *task->parameter,
+                                                 task->outputs[i],
+                                                 &task->errors[i]);
+  }
+  return NULL;
+}
+
+}  // namespace
+
+bool GenerateAllOnThreads(
+    const google::protobuf::compiler::CodeGenerator *generator,
+    const std::vector<const google::protobuf::FileDescriptor *> &files,
+    const std::string &parameter,
+    google::protobuf::compiler::OutputDirectory *output_directory,
+    std::string *error) {
+  GenerateAllTask task;
+  task.generator = generator;
+  task.files = &files;
+  task.parameter = &parameter;
+  task.outputs.resize(files.size());
+  for (size_t i = 0; i < files.size(); ++i) {
+    task.outputs[i] = new BufferedOutputDirectory();
+  }
+  task.errors.resize(files.size());
+  task.results.resize(files.size(), false);
+  pthread_mutex_init(&task.mutex, NULL);
+  task.next = 0;
+
+  // one thread per CPU, or just the calling thread if the count is not
+  // known, but no more than there are files
+  long thread_count = sysconf(_SC_NPROCESSORS_ONLN);  // NOLINT
+  if (thread_count <= 0) {
+    thread_count = 1;
+  }
+  if (static_cast<size_t>(thread_count) > files.size()) {
+    thread_count = std::max<size_t>(1, files.size());
+  }
+
+  // the calling thread takes files as well, so the files of a thread
+  // that could not be started are still generated
+  std::vector<pthread_t> threads(thread_count);
+  std::vector<bool> started(thread_count, false);
+  for (int t = 1; t < thread_count; ++t) {
+    started[t] = pthread_create(&threads[t], NULL,
+                                &RunGenerateAllTask,
+                                &task) == 0;
+  }
+  RunGenerateAllTask(&task);
+  for (int t = 1; t < thread_count; ++t) {
+    if (started[t]) {
+      pthread_join(threads[t], NULL);
+    }
+  }
+  pthread_mutex_destroy(&task.mutex);
+
+  bool result = true;
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (result && !task.results[i]) {
+      *error = files[i]->name() + ": " + task.errors[i];
+      result = false;
+    }
+    if (result) {
+      task.outputs[i]->Commit(output_directory);
+    }
+    delete task.outputs[i];
+  }
+  return result;
+}
+
+}  // namespace js
+}  // namespace protobuf
+}  // namespace sg
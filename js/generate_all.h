@@ -0,0 +1,47 @@
+// Copyright (c) 2011 SameGoal LLC.
+// All Rights Reserved.
+// Author: Andy Hochhaus <ahochhaus@samegoal.com>
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PROTOBUF_JS_GENERATE_ALL_H_
+#define PROTOBUF_JS_GENERATE_ALL_H_
+
+#include <string>
+#include <vector>
+
+#include "google/protobuf/compiler/code_generator.h"
+#include "google/protobuf/descriptor.h"
+
+namespace sg {
+namespace protobuf {
+namespace js {
+
+// Runs generator->Generate() for each of files on a pool of threads, one
+// thread per processor. Each file writes to its own in-memory buffers,
+// which are then written to output_directory in the order of files, so
+// the output is the same as generating the files one after another. As
+// in the serial case the first file that fails stops the commit and its
+// name is prefixed to error.
+bool GenerateAllOnThreads(
+    const google::protobuf::compiler::CodeGenerator *generator,
+    const std::vector<const google::protobuf::FileDescriptor *> &files,
+    const std::string &parameter,
+    google::protobuf::compiler::OutputDirectory *output_directory,
+    std::string *error);
+
+}  // namespace js
+}  // namespace protobuf
+}  // namespace sg
+
+#endif  // PROTOBUF_JS_GENERATE_ALL_H_
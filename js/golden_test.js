@@ -0,0 +1,428 @@
+// Copyright (c) 2010-2011 SameGoal LLC.
+// All Rights Reserved.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @fileoverview Checks the *.pb.js files in js/testdata, which protoc-gen-js
+ * writes for js/test.proto with each of its options, and prints their sizes.
+ * Run it with node from the top of the tree:
+ *
+ *   node js/golden_test.js [protoc-gen-js [--update]]
+ *
+ * Given the plugin, it first runs protoc with it and fails if the output
+ * differs from the goldens, or rewrites them with --update. It then loads the
+ * goldens against a stub of goog.proto2.Message that records its calls. It
+ * checks that the accessors which js/message_accessors.js defines for
+ * accessors=compact make the same calls as the default accessors, and that
+ * with metadata=lazy no metadata is registered at load and each message type
+ * registers the same metadata as by default once, when it is first used.
+ * Finally it reads the arrays of js/testdata/pblite_goldens.tsv, which the
+ * ccjs plugin writes, with the fromPbLite() of pblite=unrolled and checks that
+ * toPbLite() writes them back the same in both PbLite formats.
+ */
+
+var childProcess = require('child_process');
+var fs = require('fs');
+var os = require('os');
+var path = require('path');
+var vm = require('vm');
+
+
+/**
+ * The goldens and the *.proto files and --js_out options they are generated
+ * from.
+ * @type {!Array.<{file: string, proto: string, options: string}>}
+ */
+var GOLDENS = [
+  {file: 'test.pb.js', proto: 'js/test.proto', options: ''},
+  {file: 'test_compact.pb.js', proto: 'js/test.proto',
+   options: 'accessors=compact'},
+  {file: 'test_lazy.pb.js', proto: 'js/test.proto',
+   options: 'metadata=lazy'},
+  {file: 'test_compact_lazy.pb.js', proto: 'js/test.proto',
+   options: 'accessors=compact,metadata=lazy'},
+  {file: 'test_pblite.pb.js', proto: 'js/test.proto',
+   options: 'pblite=unrolled'},
+  {file: 'package_test_pblite.pb.js', proto: 'js/package_test.proto',
+   options: 'pblite=unrolled'}
+];
+
+
+/**
+ * The stub of the Closure library that the goldens are loaded against. Each
+ * goog.proto2.Message method that the accessors call returns a string of its
+ * name and arguments, and registered lists the message types and metadata
+ * that were passed to goog.proto2.Message.set$Metadata().
+ * @type {string}
+ */
+var CLOSURE_STUB = [
+  'var goog = {',
+  '  global: this,',
+  '  provide: function(name) {',
+  '    var parts = name.split(".");',
+  '    var object = goog.global;',
+  '    for (var i = 0; i < parts.length; ++i) {',
+  '      object = object[parts[i]] = object[parts[i]] || {};',
+  '    }',
+  '  },',
+  '  require: function() {},',
+  '  inherits: function(child, parent) {',
+  '    child.prototype = Object.create(parent.prototype);',
+  '    child.prototype.constructor = child;',
+  '  }',
+  '};',
+  'var registered = [];',
+  'goog.proto2 = {Message: function() { this.values_ = {}; }};',
+  'goog.proto2.Message.FieldType = {};',
+  'goog.proto2.Message.set$Metadata = function(type, metadata) {',
+  '  registered.push({type: type, metadata: metadata});',
+  '  type.getDescriptor = function() { return metadata; };',
+  '};',
+  '["get$Value", "get$ValueOrDefault", "set$Value", "add$Value",',
+  ' "array$Values", "has$Value", "count$Values", "clear$Field"].forEach(',
+  '    function(method) {',
+  '      goog.proto2.Message.prototype[method] = function() {',
+  '        return method + "(" +',
+  '            Array.prototype.slice.call(arguments).join(",") + ")";',
+  '      };',
+  '    });'
+].join('\n');
+
+
+/**
+ * Replaces the goog.proto2.Message methods that fromPbLite() and toPbLite()
+ * call with ones that store the values of the fields in values_, by tag.
+ * @type {string}
+ */
+var VALUES_STUB = [
+  'var prototype = goog.proto2.Message.prototype;',
+  'prototype.has$Value = function(tag) {',
+  '  return this.values_[tag] !== undefined;',
+  '};',
+  'prototype.get$Value = function(tag) {',
+  '  return this.values_[tag];',
+  '};',
+  'prototype.set$Value = function(tag, value) {',
+  '  this.values_[tag] = value;',
+  '};',
+  'prototype.array$Values = function(tag) {',
+  '  return this.values_[tag] || [];',
+  '};',
+  'prototype.add$Value = function(tag, value) {',
+  '  (this.values_[tag] = this.values_[tag] || []).push(value);',
+  '};'
+].join('\n');
+
+
+/**
+ * The arguments that the accessors are called with, by parameter name.
+ * @type {!Object.<string, *>}
+ */
+var ARGUMENTS = {index: 3, value: 'value'};
+
+
+/**
+ * @param {string} file The name of a golden.
+ * @return {string} The path of the golden.
+ */
+function goldenPath(file) {
+  return path.join('js', 'testdata', file);
+}
+
+
+/**
+ * Runs protoc with plugin for each golden and compares the output with it,
+ * or replaces it if update is set.
+ * @param {string} plugin The path of protoc-gen-js.
+ * @param {boolean} update Whether to rewrite the goldens.
+ * @return {boolean} Whether all of the output matches.
+ */
+function checkGenerated(plugin, update) {
+  var ok = true;
+  var out = fs.mkdtempSync(path.join(os.tmpdir(), 'golden_test'));
+  GOLDENS.forEach(function(golden) {
+    var dir = path.join(out, golden.file);
+    fs.mkdirSync(dir);
+    childProcess.execFileSync('protoc', [
+      '--plugin=protoc-gen-js=' + path.resolve(plugin),
+      '-I', '.',
+      '--js_out=' + (golden.options ? golden.options + ':' : '') + dir,
+      golden.proto
+    ], {stdio: 'inherit'});
+    var generated = fs.readFileSync(
+        path.join(dir, golden.proto.replace(/\.proto$/, '.pb.js')), 'utf8');
+    if (update) {
+      fs.writeFileSync(goldenPath(golden.file), generated);
+    } else if (generated != fs.readFileSync(goldenPath(golden.file), 'utf8')) {
+      console.log('FAIL ' + goldenPath(golden.file) + ' differs from ' +
+                  '--js_out=' + golden.options + ', rerun with --update ' +
+                  'if the change is intended');
+      ok = false;
+    }
+  });
+  fs.rmSync(out, {recursive: true});
+  return ok;
+}
+
+
+/**
+ * @param {!Array.<string>} files The files to run, after the stub.
+ * @param {string=} opt_stub Code to run after CLOSURE_STUB, before the files.
+ * @return {!Object} The context that the files ran in.
+ */
+function load(files, opt_stub) {
+  var context = vm.createContext({});
+  vm.runInContext(CLOSURE_STUB + '\n' + (opt_stub || ''), context);
+  files.forEach(function(file) {
+    vm.runInContext(fs.readFileSync(file, 'utf8'), context, {filename: file});
+  });
+  return context;
+}
+
+
+/**
+ * @param {!Object} context The context that a golden ran in.
+ * @param {string} name The full name of a message type.
+ * @return {!Function} The constructor of the message type.
+ */
+function lookup(context, name) {
+  return name.split('.').reduce(function(object, part) {
+    return object[part];
+  }, context);
+}
+
+
+/**
+ * Calls every accessor that the default golden defines on a message of both
+ * the default and a compact golden.
+ * @param {string} file The name of the compact golden.
+ * @return {boolean} Whether all of the calls match.
+ */
+function checkCompactAccessors(file) {
+  var full = load([goldenPath('test.pb.js')]);
+  var compact = load([path.join('js', 'message_accessors.js'),
+                      goldenPath(file)]);
+  var source = fs.readFileSync(goldenPath('test.pb.js'), 'utf8');
+  var accessor = /^([\w.]+)\.prototype\.(\w+) = function\(([\w, ]*)\)/mg;
+  var ok = true;
+  var count = 0;
+  var match;
+  while ((match = accessor.exec(source))) {
+    var args = match[3] ? match[3].split(', ').map(function(name) {
+      return ARGUMENTS[name];
+    }) : [];
+    var want = lookup(full, match[1]).prototype[match[2]].apply(
+        new (lookup(full, match[1]))(), args);
+    var compactType = lookup(compact, match[1]);
+    var method = compactType.prototype[match[2]];
+    var got = method ? method.apply(new compactType(), args) : 'undefined';
+    if (got !== want) {
+      console.log('FAIL ' + match[1] + '.prototype.' + match[2] + ' returns ' +
+                  got + ' in ' + file + ', ' + want + ' by default');
+      ok = false;
+    }
+    ++count;
+  }
+  console.log('checked ' + count + ' accessors of ' + file);
+  return ok;
+}
+
+
+/**
+ * @param {!Object} context The context that a golden ran in.
+ * @return {!Array.<string>} The metadata registered so far, as JSON with the
+ *     message types and the Number, String and Boolean types by name.
+ */
+function registeredMetadata(context) {
+  var names = new Map();
+  context.registered.forEach(function(registration) {
+    names.set(registration.type, registration.metadata[0].fullName);
+  });
+  return context.registered.map(function(registration) {
+    return JSON.stringify(registration.metadata, function(key, value) {
+      return typeof value == 'function' ?
+          names.get(value) || value.name : value;
+    });
+  });
+}
+
+
+/**
+ * Loads a metadata=lazy golden and uses each of its message types, either by
+ * constructing two messages or by calling getDescriptor() twice.
+ * @param {string} file The name of the lazy golden.
+ * @param {string} eagerFile The name of the golden with the same accessors
+ *     and eager metadata.
+ * @return {boolean} Whether the metadata is registered once per message
+ *     type, on first use, and matches that of eagerFile.
+ */
+function checkLazyMetadata(file, eagerFile) {
+  var ok = true;
+  var files = file.indexOf('compact') < 0 ? [] :
+      [path.join('js', 'message_accessors.js')];
+  var lazy = load(files.concat([goldenPath(file)]));
+  if (lazy.registered.length != 0) {
+    console.log('FAIL ' + file + ' registers ' + lazy.registered.length +
+                ' message types when it is loaded');
+    ok = false;
+  }
+  var provided = /^goog\.provide\('([\w.]+)'\);$/mg;
+  var types = 0;
+  var match;
+  while ((match = provided.exec(
+      fs.readFileSync(goldenPath(file), 'utf8')))) {
+    var type = lookup(lazy, match[1]);
+    if (typeof type.getDescriptor != 'function') {
+      continue;  // An enum.
+    }
+    var before = lazy.registered.length;
+    if (types++ % 2) {
+      new type();
+      new type();
+    } else {
+      type.getDescriptor();
+      type.getDescriptor();
+    }
+    if (!lazy.registered.slice(before).some(function(registration) {
+          return registration.type === type;
+        })) {
+      console.log('FAIL ' + match[1] + ' registers no metadata on first use');
+      ok = false;
+    }
+  }
+  var want = registeredMetadata(
+      load(files.concat([goldenPath(eagerFile)]))).sort();
+  var got = registeredMetadata(lazy).sort();
+  if (JSON.stringify(got) != JSON.stringify(want)) {
+    console.log('FAIL ' + file + ' registers different metadata than ' +
+                eagerFile);
+    ok = false;
+  }
+  console.log('checked the metadata of ' + types + ' message types of ' +
+              file);
+  return ok;
+}
+
+
+/**
+ * @param {!Object} context The context that a pblite=unrolled golden ran in.
+ * @param {!Object} message A message of the context.
+ * @return {string} Why a value of message or of its submessages does not
+ *     have the type of its field in the metadata, or '' if all of them do.
+ */
+function valueTypeError(context, message) {
+  var metadata = message.constructor.getDescriptor();
+  for (var tag in message.values_) {
+    var field = metadata[tag];
+    var values = field.repeated ? message.values_[tag] :
+        [message.values_[tag]];
+    for (var i = 0; i < values.length; ++i) {
+      var error;
+      if (values[i] instanceof context.goog.proto2.Message) {
+        error = valueTypeError(context, values[i]);
+      } else {
+        var want = {String: 'string', Boolean: 'boolean'}[field.type.name] ||
+            'number';
+        error = typeof values[i] == want ? '' :
+            metadata[0].fullName + '.' + field.name + ' is a ' +
+            typeof values[i] + ', not a ' + want;
+      }
+      if (error) {
+        return error;
+      }
+    }
+  }
+  return '';
+}
+
+
+/**
+ * Reads each PbLite and PbLiteZeroIndex array of pblite_goldens.tsv with
+ * fromPbLite() and writes the message with toPbLite() in both formats.
+ * @return {boolean} Whether the values have the types of their fields and
+ *     JSON.stringify() of each array that toPbLite() returns is the golden.
+ */
+function checkPbLite() {
+  var context = load([goldenPath('test_pblite.pb.js'),
+                      goldenPath('package_test_pblite.pb.js')], VALUES_STUB);
+  var ok = true;
+  var count = 0;
+  var lines = fs.readFileSync(goldenPath('pblite_goldens.tsv'), 'utf8')
+      .split('\n');
+  lines.forEach(function(line) {
+    if (line == '' || line[0] == '#') {
+      return;
+    }
+    var columns = line.split('\t');
+    var type = lookup(context, columns[0]);
+    var goldens = [columns[1], columns[2]];
+    [false, true].forEach(function(zeroIndex) {
+      var message = type.fromPbLite(JSON.parse(goldens[+zeroIndex]),
+                                    zeroIndex);
+      var error = valueTypeError(context, message);
+      if (error) {
+        console.log('FAIL fromPbLite(' + goldens[+zeroIndex] + '): ' + error);
+        ok = false;
+      }
+      [false, true].forEach(function(toZeroIndex) {
+        var got = JSON.stringify(type.toPbLite(message, toZeroIndex));
+        if (got != goldens[+toZeroIndex]) {
+          console.log('FAIL toPbLite(fromPbLite(' + goldens[+zeroIndex] +
+                      ', ' + zeroIndex + '), ' + toZeroIndex + ') is ' + got);
+          ok = false;
+        }
+        ++count;
+      });
+    });
+  });
+  console.log('checked ' + count + ' PbLite round trips of ' +
+              'pblite_goldens.tsv');
+  return ok;
+}
+
+
+/**
+ * Prints the size of each golden of js/test.proto and its ratio to the
+ * default output.
+ */
+function reportSizes() {
+  var base = fs.statSync(goldenPath(GOLDENS[0].file)).size;
+  GOLDENS.forEach(function(golden) {
+    if (golden.proto != GOLDENS[0].proto) {
+      return;
+    }
+    var size = fs.statSync(goldenPath(golden.file)).size;
+    console.log(
+        (golden.options || 'default').padEnd(32) + String(size).padStart(8) +
+        ' bytes' + (100 * size / base).toFixed(0).padStart(6) + '%');
+  });
+}
+
+
+function main(argv) {
+  var ok = true;
+  if (argv.length > 0) {
+    ok = checkGenerated(argv[0], argv[1] == '--update') && ok;
+  }
+  ok = checkCompactAccessors('test_compact.pb.js') && ok;
+  ok = checkCompactAccessors('test_compact_lazy.pb.js') && ok;
+  ok = checkLazyMetadata('test_lazy.pb.js', 'test.pb.js') && ok;
+  ok = checkLazyMetadata('test_compact_lazy.pb.js', 'test_compact.pb.js') && ok;
+  ok = checkPbLite() && ok;
+  reportSizes();
+  console.log(ok ? 'PASSED' : 'FAILED');
+  return ok ? 0 : 1;
+}
+
+process.exitCode = main(process.argv.slice(2));
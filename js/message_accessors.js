@@ -0,0 +1,108 @@
+// Copyright (c) 2010-2011 SameGoal LLC.
+// All Rights Reserved.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @fileoverview Installs the accessors of the messages that protoc-gen-js
+ * writes with --js_out=accessors=compact:<dir>. The *.pb.js files then only
+ * declare the type of each accessor and pass a table of their fields to
+ * install(), which defines the same methods as the default output.
+ */
+
+goog.provide('sg.protobuf.js.accessors');
+
+goog.require('goog.proto2.Message');
+
+
+/**
+ * The type of the has<Field>() accessors.
+ * @typedef {function():boolean}
+ */
+sg.protobuf.js.accessors.Has;
+
+
+/**
+ * The type of the <field>Count() accessors.
+ * @typedef {function():number}
+ */
+sg.protobuf.js.accessors.Count;
+
+
+/**
+ * The type of the clear<Field>() accessors.
+ * @typedef {function()}
+ */
+sg.protobuf.js.accessors.Clear;
+
+
+/**
+ * Defines the accessors of the fields of a message type on its prototype.
+ * @param {function(new:goog.proto2.Message)} type The message type.
+ * @param {!Array.<!Array>} fields The number and camel-cased name of each
+ *     field, followed by true for repeated fields.
+ */
+sg.protobuf.js.accessors.install = function(type, fields) {
+  for (var i = 0; i < fields.length; ++i) {
+    sg.protobuf.js.accessors.installField_(
+        type.prototype, fields[i][0], fields[i][1], !!fields[i][2]);
+  }
+};
+
+
+/**
+ * Defines the accessors of one field, see install().
+ * @param {!Object} prototype The prototype of the message type.
+ * @param {number} number The number of the field.
+ * @param {string} name The camel-cased name of the field.
+ * @param {boolean} repeated Whether the field is repeated.
+ * @private
+ */
+sg.protobuf.js.accessors.installField_ = function(
+    prototype, number, name, repeated) {
+  var upper = name.charAt(0).toUpperCase() + name.substr(1);
+
+  if (repeated) {
+    prototype['get' + upper] = function(index) {
+      return this.get$Value(number, index);
+    };
+    prototype['get' + upper + 'OrDefault'] = function(index) {
+      return this.get$ValueOrDefault(number, index);
+    };
+    prototype['add' + upper] = function(value) {
+      this.add$Value(number, value);
+    };
+    prototype[name + 'Array'] = function() {
+      return this.array$Values(number);
+    };
+  } else {
+    prototype['get' + upper] = function() {
+      return this.get$Value(number);
+    };
+    prototype['get' + upper + 'OrDefault'] = function() {
+      return this.get$ValueOrDefault(number);
+    };
+    prototype['set' + upper] = function(value) {
+      this.set$Value(number, value);
+    };
+  }
+  prototype['has' + upper] = function() {
+    return this.has$Value(number);
+  };
+  prototype[name + 'Count'] = function() {
+    return this.count$Values(number);
+  };
+  prototype['clear' + upper] = function() {
+    this.clear$Field(number);
+  };
+};
@@ -0,0 +1,1014 @@
+// Generated by the protocol buffer compiler.  DO NOT EDIT!
+// source: js/test.proto
+
+/**
+ * @fileoverview Generated Protocol Buffer code for file js/test.proto.
+ */
+
+goog.provide('proto2.TestAllTypes');
+goog.provide('proto2.TestAllTypes.NestedEnum');
+goog.provide('proto2.TestAllTypes.NestedMessage');
+goog.provide('proto2.TestAllTypes.OptionalGroup');
+goog.provide('proto2.TestAllTypes.RepeatedGroup');
+
+goog.require('goog.proto2.Message');
+goog.require('sg.protobuf.js.accessors');
+
+
+
+/**
+ * Message TestAllTypes.
+ * @constructor
+ * @extends {goog.proto2.Message}
+ */
+proto2.TestAllTypes = function() {
+  goog.proto2.Message.apply(this);
+};
+goog.inherits(proto2.TestAllTypes, goog.proto2.Message);
+
+
+/**
+ * Overrides {@link goog.proto2.Message#clone} to specify its exact return type.
+ * @return {!proto2.TestAllTypes} The cloned message.
+ * @override
+ */
+proto2.TestAllTypes.prototype.clone;
+
+/** @type {function():?number} */
+proto2.TestAllTypes.prototype.getOptionalInt32;
+/** @type {function():number} */
+proto2.TestAllTypes.prototype.getOptionalInt32OrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.prototype.setOptionalInt32;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalInt32;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalInt32Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalInt32;
+/** @type {function():?string} */
+proto2.TestAllTypes.prototype.getOptionalInt64;
+/** @type {function():string} */
+proto2.TestAllTypes.prototype.getOptionalInt64OrDefault;
+/** @type {function(string)} */
+proto2.TestAllTypes.prototype.setOptionalInt64;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalInt64;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalInt64Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalInt64;
+/** @type {function():?number} */
+proto2.TestAllTypes.prototype.getOptionalUint32;
+/** @type {function():number} */
+proto2.TestAllTypes.prototype.getOptionalUint32OrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.prototype.setOptionalUint32;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalUint32;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalUint32Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalUint32;
+/** @type {function():?string} */
+proto2.TestAllTypes.prototype.getOptionalUint64;
+/** @type {function():string} */
+proto2.TestAllTypes.prototype.getOptionalUint64OrDefault;
+/** @type {function(string)} */
+proto2.TestAllTypes.prototype.setOptionalUint64;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalUint64;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalUint64Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalUint64;
+/** @type {function():?number} */
+proto2.TestAllTypes.prototype.getOptionalSint32;
+/** @type {function():number} */
+proto2.TestAllTypes.prototype.getOptionalSint32OrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.prototype.setOptionalSint32;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalSint32;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalSint32Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalSint32;
+/** @type {function():?string} */
+proto2.TestAllTypes.prototype.getOptionalSint64;
+/** @type {function():string} */
+proto2.TestAllTypes.prototype.getOptionalSint64OrDefault;
+/** @type {function(string)} */
+proto2.TestAllTypes.prototype.setOptionalSint64;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalSint64;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalSint64Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalSint64;
+/** @type {function():?number} */
+proto2.TestAllTypes.prototype.getOptionalFixed32;
+/** @type {function():number} */
+proto2.TestAllTypes.prototype.getOptionalFixed32OrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.prototype.setOptionalFixed32;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalFixed32;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalFixed32Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalFixed32;
+/** @type {function():?string} */
+proto2.TestAllTypes.prototype.getOptionalFixed64;
+/** @type {function():string} */
+proto2.TestAllTypes.prototype.getOptionalFixed64OrDefault;
+/** @type {function(string)} */
+proto2.TestAllTypes.prototype.setOptionalFixed64;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalFixed64;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalFixed64Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalFixed64;
+/** @type {function():?number} */
+proto2.TestAllTypes.prototype.getOptionalSfixed32;
+/** @type {function():number} */
+proto2.TestAllTypes.prototype.getOptionalSfixed32OrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.prototype.setOptionalSfixed32;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalSfixed32;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalSfixed32Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalSfixed32;
+/** @type {function():?string} */
+proto2.TestAllTypes.prototype.getOptionalSfixed64;
+/** @type {function():string} */
+proto2.TestAllTypes.prototype.getOptionalSfixed64OrDefault;
+/** @type {function(string)} */
+proto2.TestAllTypes.prototype.setOptionalSfixed64;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalSfixed64;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalSfixed64Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalSfixed64;
+/** @type {function():?number} */
+proto2.TestAllTypes.prototype.getOptionalFloat;
+/** @type {function():number} */
+proto2.TestAllTypes.prototype.getOptionalFloatOrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.prototype.setOptionalFloat;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalFloat;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalFloatCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalFloat;
+/** @type {function():?number} */
+proto2.TestAllTypes.prototype.getOptionalDouble;
+/** @type {function():number} */
+proto2.TestAllTypes.prototype.getOptionalDoubleOrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.prototype.setOptionalDouble;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalDouble;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalDoubleCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalDouble;
+/** @type {function():?boolean} */
+proto2.TestAllTypes.prototype.getOptionalBool;
+/** @type {function():boolean} */
+proto2.TestAllTypes.prototype.getOptionalBoolOrDefault;
+/** @type {function(boolean)} */
+proto2.TestAllTypes.prototype.setOptionalBool;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalBool;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalBoolCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalBool;
+/** @type {function():?string} */
+proto2.TestAllTypes.prototype.getOptionalString;
+/** @type {function():string} */
+proto2.TestAllTypes.prototype.getOptionalStringOrDefault;
+/** @type {function(string)} */
+proto2.TestAllTypes.prototype.setOptionalString;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalString;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalStringCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalString;
+/** @type {function():?string} */
+proto2.TestAllTypes.prototype.getOptionalBytes;
+/** @type {function():string} */
+proto2.TestAllTypes.prototype.getOptionalBytesOrDefault;
+/** @type {function(string)} */
+proto2.TestAllTypes.prototype.setOptionalBytes;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalBytes;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalBytesCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalBytes;
+/** @type {function():proto2.TestAllTypes.OptionalGroup} */
+proto2.TestAllTypes.prototype.getOptionalgroup;
+/** @type {function():!proto2.TestAllTypes.OptionalGroup} */
+proto2.TestAllTypes.prototype.getOptionalgroupOrDefault;
+/** @type {function(!proto2.TestAllTypes.OptionalGroup)} */
+proto2.TestAllTypes.prototype.setOptionalgroup;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalgroup;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalgroupCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalgroup;
+/** @type {function():proto2.TestAllTypes.NestedMessage} */
+proto2.TestAllTypes.prototype.getOptionalNestedMessage;
+/** @type {function():!proto2.TestAllTypes.NestedMessage} */
+proto2.TestAllTypes.prototype.getOptionalNestedMessageOrDefault;
+/** @type {function(!proto2.TestAllTypes.NestedMessage)} */
+proto2.TestAllTypes.prototype.setOptionalNestedMessage;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalNestedMessage;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalNestedMessageCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalNestedMessage;
+/** @type {function():?proto2.TestAllTypes.NestedEnum} */
+proto2.TestAllTypes.prototype.getOptionalNestedEnum;
+/** @type {function():proto2.TestAllTypes.NestedEnum} */
+proto2.TestAllTypes.prototype.getOptionalNestedEnumOrDefault;
+/** @type {function(proto2.TestAllTypes.NestedEnum)} */
+proto2.TestAllTypes.prototype.setOptionalNestedEnum;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalNestedEnum;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalNestedEnumCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalNestedEnum;
+/** @type {function():?number} */
+proto2.TestAllTypes.prototype.getOptionalInt64Number;
+/** @type {function():number} */
+proto2.TestAllTypes.prototype.getOptionalInt64NumberOrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.prototype.setOptionalInt64Number;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalInt64Number;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalInt64NumberCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalInt64Number;
+/** @type {function():?string} */
+proto2.TestAllTypes.prototype.getOptionalInt64String;
+/** @type {function():string} */
+proto2.TestAllTypes.prototype.getOptionalInt64StringOrDefault;
+/** @type {function(string)} */
+proto2.TestAllTypes.prototype.setOptionalInt64String;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasOptionalInt64String;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.optionalInt64StringCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearOptionalInt64String;
+/** @type {function(number):?number} */
+proto2.TestAllTypes.prototype.getRepeatedInt32;
+/** @type {function(number):number} */
+proto2.TestAllTypes.prototype.getRepeatedInt32OrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.prototype.addRepeatedInt32;
+/** @type {function():!Array.<number>} */
+proto2.TestAllTypes.prototype.repeatedInt32Array;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedInt32;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedInt32Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedInt32;
+/** @type {function(number):?string} */
+proto2.TestAllTypes.prototype.getRepeatedInt64;
+/** @type {function(number):string} */
+proto2.TestAllTypes.prototype.getRepeatedInt64OrDefault;
+/** @type {function(string)} */
+proto2.TestAllTypes.prototype.addRepeatedInt64;
+/** @type {function():!Array.<string>} */
+proto2.TestAllTypes.prototype.repeatedInt64Array;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedInt64;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedInt64Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedInt64;
+/** @type {function(number):?number} */
+proto2.TestAllTypes.prototype.getRepeatedUint32;
+/** @type {function(number):number} */
+proto2.TestAllTypes.prototype.getRepeatedUint32OrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.prototype.addRepeatedUint32;
+/** @type {function():!Array.<number>} */
+proto2.TestAllTypes.prototype.repeatedUint32Array;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedUint32;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedUint32Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedUint32;
+/** @type {function(number):?string} */
+proto2.TestAllTypes.prototype.getRepeatedUint64;
+/** @type {function(number):string} */
+proto2.TestAllTypes.prototype.getRepeatedUint64OrDefault;
+/** @type {function(string)} */
+proto2.TestAllTypes.prototype.addRepeatedUint64;
+/** @type {function():!Array.<string>} */
+proto2.TestAllTypes.prototype.repeatedUint64Array;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedUint64;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedUint64Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedUint64;
+/** @type {function(number):?number} */
+proto2.TestAllTypes.prototype.getRepeatedSint32;
+/** @type {function(number):number} */
+proto2.TestAllTypes.prototype.getRepeatedSint32OrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.prototype.addRepeatedSint32;
+/** @type {function():!Array.<number>} */
+proto2.TestAllTypes.prototype.repeatedSint32Array;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedSint32;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedSint32Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedSint32;
+/** @type {function(number):?string} */
+proto2.TestAllTypes.prototype.getRepeatedSint64;
+/** @type {function(number):string} */
+proto2.TestAllTypes.prototype.getRepeatedSint64OrDefault;
+/** @type {function(string)} */
+proto2.TestAllTypes.prototype.addRepeatedSint64;
+/** @type {function():!Array.<string>} */
+proto2.TestAllTypes.prototype.repeatedSint64Array;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedSint64;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedSint64Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedSint64;
+/** @type {function(number):?number} */
+proto2.TestAllTypes.prototype.getRepeatedFixed32;
+/** @type {function(number):number} */
+proto2.TestAllTypes.prototype.getRepeatedFixed32OrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.prototype.addRepeatedFixed32;
+/** @type {function():!Array.<number>} */
+proto2.TestAllTypes.prototype.repeatedFixed32Array;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedFixed32;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedFixed32Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedFixed32;
+/** @type {function(number):?string} */
+proto2.TestAllTypes.prototype.getRepeatedFixed64;
+/** @type {function(number):string} */
+proto2.TestAllTypes.prototype.getRepeatedFixed64OrDefault;
+/** @type {function(string)} */
+proto2.TestAllTypes.prototype.addRepeatedFixed64;
+/** @type {function():!Array.<string>} */
+proto2.TestAllTypes.prototype.repeatedFixed64Array;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedFixed64;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedFixed64Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedFixed64;
+/** @type {function(number):?number} */
+proto2.TestAllTypes.prototype.getRepeatedSfixed32;
+/** @type {function(number):number} */
+proto2.TestAllTypes.prototype.getRepeatedSfixed32OrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.prototype.addRepeatedSfixed32;
+/** @type {function():!Array.<number>} */
+proto2.TestAllTypes.prototype.repeatedSfixed32Array;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedSfixed32;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedSfixed32Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedSfixed32;
+/** @type {function(number):?string} */
+proto2.TestAllTypes.prototype.getRepeatedSfixed64;
+/** @type {function(number):string} */
+proto2.TestAllTypes.prototype.getRepeatedSfixed64OrDefault;
+/** @type {function(string)} */
+proto2.TestAllTypes.prototype.addRepeatedSfixed64;
+/** @type {function():!Array.<string>} */
+proto2.TestAllTypes.prototype.repeatedSfixed64Array;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedSfixed64;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedSfixed64Count;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedSfixed64;
+/** @type {function(number):?number} */
+proto2.TestAllTypes.prototype.getRepeatedFloat;
+/** @type {function(number):number} */
+proto2.TestAllTypes.prototype.getRepeatedFloatOrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.prototype.addRepeatedFloat;
+/** @type {function():!Array.<number>} */
+proto2.TestAllTypes.prototype.repeatedFloatArray;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedFloat;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedFloatCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedFloat;
+/** @type {function(number):?number} */
+proto2.TestAllTypes.prototype.getRepeatedDouble;
+/** @type {function(number):number} */
+proto2.TestAllTypes.prototype.getRepeatedDoubleOrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.prototype.addRepeatedDouble;
+/** @type {function():!Array.<number>} */
+proto2.TestAllTypes.prototype.repeatedDoubleArray;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedDouble;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedDoubleCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedDouble;
+/** @type {function(number):?boolean} */
+proto2.TestAllTypes.prototype.getRepeatedBool;
+/** @type {function(number):boolean} */
+proto2.TestAllTypes.prototype.getRepeatedBoolOrDefault;
+/** @type {function(boolean)} */
+proto2.TestAllTypes.prototype.addRepeatedBool;
+/** @type {function():!Array.<boolean>} */
+proto2.TestAllTypes.prototype.repeatedBoolArray;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedBool;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedBoolCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedBool;
+/** @type {function(number):?string} */
+proto2.TestAllTypes.prototype.getRepeatedString;
+/** @type {function(number):string} */
+proto2.TestAllTypes.prototype.getRepeatedStringOrDefault;
+/** @type {function(string)} */
+proto2.TestAllTypes.prototype.addRepeatedString;
+/** @type {function():!Array.<string>} */
+proto2.TestAllTypes.prototype.repeatedStringArray;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedString;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedStringCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedString;
+/** @type {function(number):?string} */
+proto2.TestAllTypes.prototype.getRepeatedBytes;
+/** @type {function(number):string} */
+proto2.TestAllTypes.prototype.getRepeatedBytesOrDefault;
+/** @type {function(string)} */
+proto2.TestAllTypes.prototype.addRepeatedBytes;
+/** @type {function():!Array.<string>} */
+proto2.TestAllTypes.prototype.repeatedBytesArray;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedBytes;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedBytesCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedBytes;
+/** @type {function(number):proto2.TestAllTypes.RepeatedGroup} */
+proto2.TestAllTypes.prototype.getRepeatedgroup;
+/** @type {function(number):!proto2.TestAllTypes.RepeatedGroup} */
+proto2.TestAllTypes.prototype.getRepeatedgroupOrDefault;
+/** @type {function(!proto2.TestAllTypes.RepeatedGroup)} */
+proto2.TestAllTypes.prototype.addRepeatedgroup;
+/** @type {function():!Array.<!proto2.TestAllTypes.RepeatedGroup>} */
+proto2.TestAllTypes.prototype.repeatedgroupArray;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedgroup;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedgroupCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedgroup;
+/** @type {function(number):proto2.TestAllTypes.NestedMessage} */
+proto2.TestAllTypes.prototype.getRepeatedNestedMessage;
+/** @type {function(number):!proto2.TestAllTypes.NestedMessage} */
+proto2.TestAllTypes.prototype.getRepeatedNestedMessageOrDefault;
+/** @type {function(!proto2.TestAllTypes.NestedMessage)} */
+proto2.TestAllTypes.prototype.addRepeatedNestedMessage;
+/** @type {function():!Array.<!proto2.TestAllTypes.NestedMessage>} */
+proto2.TestAllTypes.prototype.repeatedNestedMessageArray;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedNestedMessage;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedNestedMessageCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedNestedMessage;
+/** @type {function(number):?proto2.TestAllTypes.NestedEnum} */
+proto2.TestAllTypes.prototype.getRepeatedNestedEnum;
+/** @type {function(number):proto2.TestAllTypes.NestedEnum} */
+proto2.TestAllTypes.prototype.getRepeatedNestedEnumOrDefault;
+/** @type {function(proto2.TestAllTypes.NestedEnum)} */
+proto2.TestAllTypes.prototype.addRepeatedNestedEnum;
+/** @type {function():!Array.<proto2.TestAllTypes.NestedEnum>} */
+proto2.TestAllTypes.prototype.repeatedNestedEnumArray;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedNestedEnum;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedNestedEnumCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedNestedEnum;
+/** @type {function(number):?number} */
+proto2.TestAllTypes.prototype.getRepeatedInt64Number;
+/** @type {function(number):number} */
+proto2.TestAllTypes.prototype.getRepeatedInt64NumberOrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.prototype.addRepeatedInt64Number;
+/** @type {function():!Array.<number>} */
+proto2.TestAllTypes.prototype.repeatedInt64NumberArray;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedInt64Number;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedInt64NumberCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedInt64Number;
+/** @type {function(number):?string} */
+proto2.TestAllTypes.prototype.getRepeatedInt64String;
+/** @type {function(number):string} */
+proto2.TestAllTypes.prototype.getRepeatedInt64StringOrDefault;
+/** @type {function(string)} */
+proto2.TestAllTypes.prototype.addRepeatedInt64String;
+/** @type {function():!Array.<string>} */
+proto2.TestAllTypes.prototype.repeatedInt64StringArray;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.prototype.hasRepeatedInt64String;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.prototype.repeatedInt64StringCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.prototype.clearRepeatedInt64String;
+sg.protobuf.js.accessors.install(proto2.TestAllTypes, [
+  [1, 'optionalInt32'],
+  [2, 'optionalInt64'],
+  [3, 'optionalUint32'],
+  [4, 'optionalUint64'],
+  [5, 'optionalSint32'],
+  [6, 'optionalSint64'],
+  [7, 'optionalFixed32'],
+  [8, 'optionalFixed64'],
+  [9, 'optionalSfixed32'],
+  [10, 'optionalSfixed64'],
+  [11, 'optionalFloat'],
+  [12, 'optionalDouble'],
+  [13, 'optionalBool'],
+  [14, 'optionalString'],
+  [15, 'optionalBytes'],
+  [16, 'optionalgroup'],
+  [18, 'optionalNestedMessage'],
+  [21, 'optionalNestedEnum'],
+  [50, 'optionalInt64Number'],
+  [51, 'optionalInt64String'],
+  [31, 'repeatedInt32', true],
+  [32, 'repeatedInt64', true],
+  [33, 'repeatedUint32', true],
+  [34, 'repeatedUint64', true],
+  [35, 'repeatedSint32', true],
+  [36, 'repeatedSint64', true],
+  [37, 'repeatedFixed32', true],
+  [38, 'repeatedFixed64', true],
+  [39, 'repeatedSfixed32', true],
+  [40, 'repeatedSfixed64', true],
+  [41, 'repeatedFloat', true],
+  [42, 'repeatedDouble', true],
+  [43, 'repeatedBool', true],
+  [44, 'repeatedString', true],
+  [45, 'repeatedBytes', true],
+  [46, 'repeatedgroup', true],
+  [48, 'repeatedNestedMessage', true],
+  [49, 'repeatedNestedEnum', true],
+  [52, 'repeatedInt64Number', true],
+  [53, 'repeatedInt64String', true]]);
+
+
+/**
+ * Enumeration NestedEnum.
+ * @enum {number}
+ */
+proto2.TestAllTypes.NestedEnum = {
+  FOO: 0,
+  BAR: 2,
+  BAZ: 3
+};
+
+
+
+/**
+ * Message NestedMessage.
+ * @constructor
+ * @extends {goog.proto2.Message}
+ */
+proto2.TestAllTypes.NestedMessage = function() {
+  goog.proto2.Message.apply(this);
+};
+goog.inherits(proto2.TestAllTypes.NestedMessage, goog.proto2.Message);
+
+
+/**
+ * Overrides {@link goog.proto2.Message#clone} to specify its exact return type.
+ * @return {!proto2.TestAllTypes.NestedMessage} The cloned message.
+ * @override
+ */
+proto2.TestAllTypes.NestedMessage.prototype.clone;
+
+/** @type {function():?number} */
+proto2.TestAllTypes.NestedMessage.prototype.getB;
+/** @type {function():number} */
+proto2.TestAllTypes.NestedMessage.prototype.getBOrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.NestedMessage.prototype.setB;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.NestedMessage.prototype.hasB;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.NestedMessage.prototype.bCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.NestedMessage.prototype.clearB;
+/** @type {function():?number} */
+proto2.TestAllTypes.NestedMessage.prototype.getC;
+/** @type {function():number} */
+proto2.TestAllTypes.NestedMessage.prototype.getCOrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.NestedMessage.prototype.setC;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.NestedMessage.prototype.hasC;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.NestedMessage.prototype.cCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.NestedMessage.prototype.clearC;
+sg.protobuf.js.accessors.install(proto2.TestAllTypes.NestedMessage, [
+  [1, 'b'],
+  [2, 'c']]);
+
+
+
+/**
+ * Message OptionalGroup.
+ * @constructor
+ * @extends {goog.proto2.Message}
+ */
+proto2.TestAllTypes.OptionalGroup = function() {
+  goog.proto2.Message.apply(this);
+};
+goog.inherits(proto2.TestAllTypes.OptionalGroup, goog.proto2.Message);
+
+
+/**
+ * Overrides {@link goog.proto2.Message#clone} to specify its exact return type.
+ * @return {!proto2.TestAllTypes.OptionalGroup} The cloned message.
+ * @override
+ */
+proto2.TestAllTypes.OptionalGroup.prototype.clone;
+
+/** @type {function():?number} */
+proto2.TestAllTypes.OptionalGroup.prototype.getA;
+/** @type {function():number} */
+proto2.TestAllTypes.OptionalGroup.prototype.getAOrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.OptionalGroup.prototype.setA;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.OptionalGroup.prototype.hasA;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.OptionalGroup.prototype.aCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.OptionalGroup.prototype.clearA;
+sg.protobuf.js.accessors.install(proto2.TestAllTypes.OptionalGroup, [
+  [17, 'a']]);
+
+
+
+/**
+ * Message RepeatedGroup.
+ * @constructor
+ * @extends {goog.proto2.Message}
+ */
+proto2.TestAllTypes.RepeatedGroup = function() {
+  goog.proto2.Message.apply(this);
+};
+goog.inherits(proto2.TestAllTypes.RepeatedGroup, goog.proto2.Message);
+
+
+/**
+ * Overrides {@link goog.proto2.Message#clone} to specify its exact return type.
+ * @return {!proto2.TestAllTypes.RepeatedGroup} The cloned message.
+ * @override
+ */
+proto2.TestAllTypes.RepeatedGroup.prototype.clone;
+
+/** @type {function(number):?number} */
+proto2.TestAllTypes.RepeatedGroup.prototype.getA;
+/** @type {function(number):number} */
+proto2.TestAllTypes.RepeatedGroup.prototype.getAOrDefault;
+/** @type {function(number)} */
+proto2.TestAllTypes.RepeatedGroup.prototype.addA;
+/** @type {function():!Array.<number>} */
+proto2.TestAllTypes.RepeatedGroup.prototype.aArray;
+/** @type {sg.protobuf.js.accessors.Has} */
+proto2.TestAllTypes.RepeatedGroup.prototype.hasA;
+/** @type {sg.protobuf.js.accessors.Count} */
+proto2.TestAllTypes.RepeatedGroup.prototype.aCount;
+/** @type {sg.protobuf.js.accessors.Clear} */
+proto2.TestAllTypes.RepeatedGroup.prototype.clearA;
+sg.protobuf.js.accessors.install(proto2.TestAllTypes.RepeatedGroup, [
+  [47, 'a', true]]);
+
+
+
+
+
+goog.proto2.Message.set$Metadata(proto2.TestAllTypes, {
+  0: {
+    name: 'TestAllTypes',
+    fullName: 'TestAllTypes'
+  },
+  1: {
+    name: 'optional_int32',
+    fieldType: goog.proto2.Message.FieldType.INT32,
+    type: Number
+  },
+  2: {
+    name: 'optional_int64',
+    fieldType: goog.proto2.Message.FieldType.INT64,
+    defaultValue: '1',
+    type: String
+  },
+  3: {
+    name: 'optional_uint32',
+    fieldType: goog.proto2.Message.FieldType.UINT32,
+    type: Number
+  },
+  4: {
+    name: 'optional_uint64',
+    fieldType: goog.proto2.Message.FieldType.UINT64,
+    type: String
+  },
+  5: {
+    name: 'optional_sint32',
+    fieldType: goog.proto2.Message.FieldType.SINT32,
+    type: Number
+  },
+  6: {
+    name: 'optional_sint64',
+    fieldType: goog.proto2.Message.FieldType.SINT64,
+    type: String
+  },
+  7: {
+    name: 'optional_fixed32',
+    fieldType: goog.proto2.Message.FieldType.FIXED32,
+    type: Number
+  },
+  8: {
+    name: 'optional_fixed64',
+    fieldType: goog.proto2.Message.FieldType.FIXED64,
+    type: String
+  },
+  9: {
+    name: 'optional_sfixed32',
+    fieldType: goog.proto2.Message.FieldType.SFIXED32,
+    type: Number
+  },
+  10: {
+    name: 'optional_sfixed64',
+    fieldType: goog.proto2.Message.FieldType.SFIXED64,
+    type: String
+  },
+  11: {
+    name: 'optional_float',
+    fieldType: goog.proto2.Message.FieldType.FLOAT,
+    defaultValue: 1.5,
+    type: Number
+  },
+  12: {
+    name: 'optional_double',
+    fieldType: goog.proto2.Message.FieldType.DOUBLE,
+    type: Number
+  },
+  13: {
+    name: 'optional_bool',
+    fieldType: goog.proto2.Message.FieldType.BOOL,
+    type: Boolean
+  },
+  14: {
+    name: 'optional_string',
+    fieldType: goog.proto2.Message.FieldType.STRING,
+    type: String
+  },
+  15: {
+    name: 'optional_bytes',
+    fieldType: goog.proto2.Message.FieldType.BYTES,
+    defaultValue: 'moo',
+    type: String
+  },
+  16: {
+    name: 'optionalgroup',
+    fieldType: goog.proto2.Message.FieldType.GROUP,
+    type: proto2.TestAllTypes.OptionalGroup
+  },
+  18: {
+    name: 'optional_nested_message',
+    fieldType: goog.proto2.Message.FieldType.MESSAGE,
+    type: proto2.TestAllTypes.NestedMessage
+  },
+  21: {
+    name: 'optional_nested_enum',
+    fieldType: goog.proto2.Message.FieldType.ENUM,
+    defaultValue: proto2.TestAllTypes.NestedEnum.FOO,
+    type: proto2.TestAllTypes.NestedEnum
+  },
+  50: {
+    name: 'optional_int64_number',
+    fieldType: goog.proto2.Message.FieldType.INT64,
+    defaultValue: 1000000000000000001,
+    type: Number
+  },
+  51: {
+    name: 'optional_int64_string',
+    fieldType: goog.proto2.Message.FieldType.INT64,
+    defaultValue: '1000000000000000001',
+    type: String
+  },
+  31: {
+    name: 'repeated_int32',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.INT32,
+    type: Number
+  },
+  32: {
+    name: 'repeated_int64',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.INT64,
+    type: String
+  },
+  33: {
+    name: 'repeated_uint32',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.UINT32,
+    type: Number
+  },
+  34: {
+    name: 'repeated_uint64',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.UINT64,
+    type: String
+  },
+  35: {
+    name: 'repeated_sint32',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.SINT32,
+    type: Number
+  },
+  36: {
+    name: 'repeated_sint64',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.SINT64,
+    type: String
+  },
+  37: {
+    name: 'repeated_fixed32',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.FIXED32,
+    type: Number
+  },
+  38: {
+    name: 'repeated_fixed64',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.FIXED64,
+    type: String
+  },
+  39: {
+    name: 'repeated_sfixed32',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.SFIXED32,
+    type: Number
+  },
+  40: {
+    name: 'repeated_sfixed64',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.SFIXED64,
+    type: String
+  },
+  41: {
+    name: 'repeated_float',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.FLOAT,
+    type: Number
+  },
+  42: {
+    name: 'repeated_double',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.DOUBLE,
+    type: Number
+  },
+  43: {
+    name: 'repeated_bool',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.BOOL,
+    type: Boolean
+  },
+  44: {
+    name: 'repeated_string',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.STRING,
+    type: String
+  },
+  45: {
+    name: 'repeated_bytes',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.BYTES,
+    type: String
+  },
+  46: {
+    name: 'repeatedgroup',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.GROUP,
+    type: proto2.TestAllTypes.RepeatedGroup
+  },
+  48: {
+    name: 'repeated_nested_message',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.MESSAGE,
+    type: proto2.TestAllTypes.NestedMessage
+  },
+  49: {
+    name: 'repeated_nested_enum',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.ENUM,
+    defaultValue: proto2.TestAllTypes.NestedEnum.FOO,
+    type: proto2.TestAllTypes.NestedEnum
+  },
+  52: {
+    name: 'repeated_int64_number',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.INT64,
+    type: Number
+  },
+  53: {
+    name: 'repeated_int64_string',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.INT64,
+    type: String
+  }
+});
+
+
+goog.proto2.Message.set$Metadata(proto2.TestAllTypes.NestedMessage, {
+  0: {
+    name: 'NestedMessage',
+    containingType: proto2.TestAllTypes,
+    fullName: 'TestAllTypes.NestedMessage'
+  },
+  1: {
+    name: 'b',
+    fieldType: goog.proto2.Message.FieldType.INT32,
+    type: Number
+  },
+  2: {
+    name: 'c',
+    fieldType: goog.proto2.Message.FieldType.INT32,
+    type: Number
+  }
+});
+
+
+goog.proto2.Message.set$Metadata(proto2.TestAllTypes.OptionalGroup, {
+  0: {
+    name: 'OptionalGroup',
+    containingType: proto2.TestAllTypes,
+    fullName: 'TestAllTypes.OptionalGroup'
+  },
+  17: {
+    name: 'a',
+    fieldType: goog.proto2.Message.FieldType.INT32,
+    type: Number
+  }
+});
+
+
+goog.proto2.Message.set$Metadata(proto2.TestAllTypes.RepeatedGroup, {
+  0: {
+    name: 'RepeatedGroup',
+    containingType: proto2.TestAllTypes,
+    fullName: 'TestAllTypes.RepeatedGroup'
+  },
+  47: {
+    name: 'a',
+    repeated: true,
+    fieldType: goog.proto2.Message.FieldType.INT32,
+    type: Number
+  }
+});
@@ -41,6 +41,7 @@
       ],
       'sources': [
         'js/code_generator.cc',
+        'js/generate_all.cc',
         'js/protoc_gen_js.cc',
       ],
       'conditions': [
@@ -65,6 +66,7 @@
       'sources': [
         'ccjs/code_generator.cc',
         'ccjs/protoc_gen_ccjs.cc',
+        'js/generate_all.cc',
       ],
       'conditions': [
         ['OS=="linux"', {
@@ -74,10 +76,45 @@
         }],
       ],
     },
+    {
+      'target_name': 'ccjs_runtime',
+      'type': '<(library)',
+      'include_dirs': [
+        '.',
+      ],
+      'direct_dependent_settings': {
+        'include_dirs': [
+          '.',
+        ],
+      },
+      'dependencies': [
+        '../third_party/libcxx/libcxx.gyp:libcxx',
+        '../third_party/protobuf/protobuf.gyp:protobuf_lite',
+      ],
+      'sources': [
+        'ccjs/ccjs_runtime.cc',
+      ],
+    },
+    {
+      # The table-driven code of the *.pb.cc files of CODE_SIZE messages,
+      # which needs the full protobuf library for reflection.
+      'target_name': 'ccjs_compact',
+      'type': '<(library)',
+      'dependencies': [
+        'ccjs_runtime',
+        '../third_party/libcxx/libcxx.gyp:libcxx',
+        '../third_party/protobuf/protobuf.gyp:protobuf_full_use_sparingly',
+      ],
+      'sources': [
+        'ccjs/ccjs_compact.cc',
+      ],
+    },
     {
       'target_name': 'test_pb',
       'type': '<(library)',
       'dependencies': [
+        'ccjs_compact',
+        'ccjs_runtime',
         'protobuf_js_pb',
         'protoc-gen-js',
         'protoc-gen-ccjs',
@@ -85,7 +122,11 @@
         '../third_party/google-glog/glog.gyp:glog',
         '../third_party/protobuf/protobuf.gyp:closure_protoc',
       ],
+      'defines': [
+        'CCJS_STRUCTURAL_INDEX_MIN_SIZE=65536',
+      ],
       'sources': [
+        'js/code_size_test.proto',
         'js/package_test.proto',
         'js/test.proto',
       ],
@@ -108,5 +149,20 @@
         'ccjs/ccjs_test.cc',
       ],
     },
+    {
+      'target_name': 'ccjs_benchmark',
+      'type': 'executable',
+      'dependencies': [
+        'test_pb',
+        '../third_party/libcxx/libcxx.gyp:libcxx',
+        '../third_party/protobuf/protobuf.gyp:protobuf_full_use_sparingly',
+      ],
+      'include_dirs' : [
+        '..',
+      ],
+      'sources': [
+        'ccjs/ccjs_benchmark.cc',
+      ],
+    },
   ],
 }